@@ -224,7 +224,7 @@ void FEHexRefine::BuildSplitLists(FEModel& fem)
 	{
 		if (m_elemList[i] != -1)
 		{
-			const std::vector<int>& elface = topo.ElementFaceList(i);
+			FEIndexList elface = topo.ElementFaceList(i);
 			for (int j = 0; j < elface.size(); ++j) m_faceList[elface[j]] = 1;
 		}
 	}
@@ -244,7 +244,7 @@ void FEHexRefine::BuildSplitLists(FEModel& fem)
 	{
 		if (m_faceList[i] != -1)
 		{
-			const std::vector<int>& faceEdge = topo.FaceEdgeList(i);
+			FEIndexList faceEdge = topo.FaceEdgeList(i);
 			for (int j = 0; j < faceEdge.size(); ++j) m_edgeList[faceEdge[j]] = 1;
 		}
 	}
@@ -566,7 +566,7 @@ void FEHexRefine::FindHangingNodes(FEModel& fem)
 		if (m_faceList[i] == -1)
 		{
 			// This face is not split
-			const std::vector<int>& fel = topo.FaceEdgeList(i);
+			FEIndexList fel = topo.FaceEdgeList(i);
 			for (int j = 0; j < fel.size(); ++j)
 			{
 				if ((m_edgeList[fel[j]] >= 0) && (tag[fel[j]] == 0))
@@ -610,7 +610,7 @@ void FEHexRefine::FindHangingNodes(FEModel& fem)
 			// This element is not split
 			// If any of its faces are split, then the corresponding node
 			// will be hanging
-			const std::vector<int>& elface = topo.ElementFaceList(i);
+			FEIndexList elface = topo.ElementFaceList(i);
 			for (int j = 0; j < elface.size(); ++j)
 			{
 				if (m_faceList[elface[j]] >= 0)
@@ -646,7 +646,7 @@ void FEHexRefine::FindHangingNodes(FEModel& fem)
 			// This element is not split
 			// If any of its edges are split, then the corresponding node
 			// will be hanging
-			const std::vector<int>& eledge = topo.ElementEdgeList(i);
+			FEIndexList eledge = topo.ElementEdgeList(i);
 			for (int j = 0; j < eledge.size(); ++j)
 			{
 				if ((m_edgeList[eledge[j]] >= 0) && (tag[eledge[j]] == 0))
@@ -745,8 +745,8 @@ void FEHexRefine::BuildNewDomains(FEModel& fem)
 
 				if (m_elemList[nelems] != -1)
 				{
-					const std::vector<int>& ee = topo.ElementEdgeList(nelems); assert(ee.size() == 12);
-					const std::vector<int>& ef = topo.ElementFaceList(nelems); assert(ef.size() == 6);
+					FEIndexList ee = topo.ElementEdgeList(nelems); assert(ee.size() == 12);
+					FEIndexList ef = topo.ElementFaceList(nelems); assert(ef.size() == 6);
 
 					// build the look-up table
 					int ENL[27] = { 0 };
@@ -914,7 +914,7 @@ bool FEHexRefine::UpdateSurface(FESurface& surf)
 		if (m_faceList[iface] >= 0)
 		{
 			const FEFaceList::FACE& face = topo.Face(iface);
-			const vector<int>& edge = topo.FaceEdgeList(iface);
+			FEIndexList edge = topo.FaceEdgeList(iface);
 
 			int NL[9];
 			NL[0] = face.node[0];
@@ -230,7 +230,7 @@ bool FEHexRefine2D::BuildSplitLists(FEModel& fem)
 		if (m_elemList[i] != -1)
 		{
 			int splitFaces = 0;
-			const std::vector<int>& elface = topo.ElementFaceList(i);
+			FEIndexList elface = topo.ElementFaceList(i);
 			for (int j = 0; j < elface.size(); ++j)
 			{
 				if (m_faceList[elface[j]] == -1)
@@ -282,7 +282,7 @@ bool FEHexRefine2D::BuildSplitLists(FEModel& fem)
 	{
 		if (m_faceList[i] >= 0)
 		{
-			const std::vector<int>& faceEdge = topo.FaceEdgeList(i);
+			FEIndexList faceEdge = topo.FaceEdgeList(i);
 			for (int j = 0; j < faceEdge.size(); ++j) m_edgeList[faceEdge[j]] = 1;
 		}
 	}
@@ -516,7 +516,7 @@ void FEHexRefine2D::FindHangingNodes(FEModel& fem)
 		if (m_faceList[i] == -1)
 		{
 			// This face is not split
-			const std::vector<int>& fel = topo.FaceEdgeList(i);
+			FEIndexList fel = topo.FaceEdgeList(i);
 			for (int j = 0; j < fel.size(); ++j)
 			{
 				if ((m_edgeList[fel[j]] >= 0) && (tag[fel[j]] == 0))
@@ -607,8 +607,8 @@ void FEHexRefine2D::BuildNewDomains(FEModel& fem)
 
 				if (m_elemList[nelems] != -1)
 				{
-					const std::vector<int>& ee = topo.ElementEdgeList(nelems); assert(ee.size() == 12);
-					const std::vector<int>& ef = topo.ElementFaceList(nelems); assert(ef.size() == 6);
+					FEIndexList ee = topo.ElementEdgeList(nelems); assert(ee.size() == 12);
+					FEIndexList ef = topo.ElementFaceList(nelems); assert(ef.size() == 6);
 
 					// build the look-up table
 					int ENL[27] = { 0 };
@@ -765,7 +765,7 @@ bool FEHexRefine2D::UpdateSurface(FESurface& surf)
 		if (m_faceList[iface] >= 0)
 		{
 			const FEFaceList::FACE& face = topo.Face(iface);
-			const vector<int>& edge = topo.FaceEdgeList(iface);
+			FEIndexList edge = topo.FaceEdgeList(iface);
 
 			int NL[9];
 			NL[0] = face.node[0];
@@ -791,7 +791,7 @@ bool FEHexRefine2D::UpdateSurface(FESurface& surf)
 		else if (m_faceList[iface] == -2)
 		{
 			const FEFaceList::FACE& face = topo.Face(iface);
-			const vector<int>& edge = topo.FaceEdgeList(iface);
+			FEIndexList edge = topo.FaceEdgeList(iface);
 
 			int NL[2][4];
 
@@ -143,7 +143,7 @@ bool FETetRefine::RefineMesh()
 		{
 			FEElement& el0 = newDom->ElementRef(j);
 
-			std::vector<int> ee = topo.ElementEdgeList(j); assert(ee.size() == 6);
+			FEIndexList ee = topo.ElementEdgeList(j); assert(ee.size() == 6);
 
 			// build the look-up table
 			int ENL[10] = { 0 };
@@ -236,7 +236,7 @@ bool FETetRefine::RefineMesh()
 		{
 			TRI& t = tri[j];
 
-			std::vector<int> ee = topo.FaceEdgeList(faceList[j]); assert(ee.size() == 3);
+			FEIndexList ee = topo.FaceEdgeList(faceList[j]); assert(ee.size() == 3);
 
 			// build the look-up table
 			int FNL[6] = { 0 };
@@ -635,7 +635,11 @@ void FEBioModel::DumpData(int nevent)
 		else
 		{
 			Serialize(ar);
-			feLogInfo("\nRestart point created. Archive name is %s.", m_sdump.c_str());
+			if (ar.Close() == false)
+			{
+				feLogWarning("Failed writing restart file (%s).\n", m_sdump.c_str());
+			}
+			else feLogInfo("\nRestart point created. Archive name is %s.", m_sdump.c_str());
 		}
 	}
 }
@@ -30,6 +30,7 @@ SOFTWARE.*/
 #include "febio.h"
 #include <FEBioXML/XMLReader.h>
 #include <FEBioXML/xmltool.h>
+#include <FEBioXML/FEBioImport.h>
 #include <FECore/FEModel.h>
 #include <FECore/FECoreTask.h>
 #include <NumCore/MatrixTools.h>
@@ -66,6 +67,7 @@ namespace febio {
 	bool parse_set(XMLTag& tag);
 	bool parse_omp_num_threads(XMLTag& tag);
 	bool parse_output_negative_jacobians(XMLTag& tag);
+	bool parse_mesh_cache(XMLTag& tag);
 
 	// create a map for the variables (defined with set)
 	static std::map<string, string> vars;
@@ -189,6 +191,10 @@ namespace febio {
 		{
 			if (parse_output_negative_jacobians(tag) == false) return false;
 		}
+		else if (tag == "mesh_cache")
+		{
+			if (parse_mesh_cache(tag) == false) return false;
+		}
 		else throw XMLReader::InvalidTag(tag);
 
 		++tag;
@@ -224,6 +230,15 @@ namespace febio {
 		return true;
 	}
 
+	//-----------------------------------------------------------------------------
+	bool parse_mesh_cache(XMLTag& tag)
+	{
+		int n;
+		tag.value(n);
+		FEBioImport::SetMeshCache(n != 0);
+		return true;
+	}
+
 	//-----------------------------------------------------------------------------
 	bool parse_default_linear_solver(XMLTag& tag)
 	{
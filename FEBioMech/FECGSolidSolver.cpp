@@ -175,6 +175,9 @@ bool FECGSolidSolver::InitEquations()
 	FEMechModel& fem = static_cast<FEMechModel&>(*GetFEModel());
 	FEMesh& mesh = fem.GetMesh();
 
+	// the element equation numbers will have to be updated
+	mesh.EquationsChanged();
+
 	// initialize nr of equations
 	int neq = 0;
 
@@ -29,6 +29,8 @@ SOFTWARE.*/
 #include <FECore/FEGlobalMatrix.h>
 #include <FECore/FELinearSystem.h>
 #include <FECore/FEBox.h>
+#include <FECore/FEMesh.h>
+#include <algorithm>
 
 vec3d MaterialPointPosition(FESurfaceElement& el, int n)
 {
@@ -121,6 +123,7 @@ BEGIN_FECORE_CLASS(FEContactPotential, FEContactInterface)
 	ADD_PARAMETER(m_Rin, "R_in");
 	ADD_PARAMETER(m_Rout, "R_out");
 	ADD_PARAMETER(m_wtol, "w_tol");
+	ADD_PARAMETER(m_skin, "search_skin");
 END_FECORE_CLASS();
 
 FEContactPotential::FEContactPotential(FEModel* fem) : m_surf1(fem), m_surf2(fem)
@@ -133,6 +136,7 @@ FEContactPotential::FEContactPotential(FEModel* fem) : m_surf1(fem), m_surf2(fem
 	m_Rin = 1.0;
 	m_Rout = 2.0;
 	m_wtol = 0.0;
+	m_skin = -1.0;
 }
 
 //! return the primary surface
@@ -153,18 +157,6 @@ bool FEContactPotential::UseNodalIntegration()
 	return false;
 }
 
-static bool is_neighbor(FESurfaceElement& e1, FESurfaceElement& e2)
-{
-	int n1 = e1.Nodes();
-	int n2 = e2.Nodes();
-	for (int i = 0; i < n1; ++i)
-	for (int j = 0; j < n2; ++j)
-	{
-		if (e1.m_node[i] == e2.m_node[j]) return true;
-	}
-	return false;
-}
-
 struct BOX
 {
 public:
@@ -231,14 +223,16 @@ public:
 			m_nbr = c.m_nbr;
 		}
 
-		void add(FESurfaceElement* el)
+		void add(int iel)
 		{
-			m_elemList.insert(el);
+			// all integration points of an element are added before the next
+			// element, so we only need to check the last entry for duplicates
+			if (m_elemList.empty() || (m_elemList.back() != iel)) m_elemList.push_back(iel);
 		}
 
 	public:
 		BOX m_box;
-		set<FESurfaceElement*>	m_elemList;
+		vector<int>		m_elemList;	//!< (local) indices of the elements in this cell
 		vector<Cell*>	m_nbr;
 	};
 
@@ -359,7 +353,7 @@ public:
 			{
 				FECPContactPoint& mp = static_cast<FECPContactPoint&>(*el.GetMaterialPoint(n));
 				Cell* c = FindCell(mp.m_rt); assert(c);
-				c->add(&el);
+				c->add(i);
 			}
 		}
 	}
@@ -385,25 +379,178 @@ bool FEContactPotential::Init()
 {
 	if (FEContactInterface::Init() == false) return false;
 
-	m_elemNeighbors.resize(m_surf1.Elements());
-	for (int i = 0; i < m_surf1.Elements(); ++i)
+	// Find the elements of surface 2 that share a node with an element of surface 1.
+	// To do this fast, we first build the node-to-element list of surface 2.
+	FEMesh& mesh = *m_surf2.GetMesh();
+	int NN = mesh.Nodes();
+	vector<int> nodeOffset(NN + 1, 0);
+	for (int j = 0; j < m_surf2.Elements(); ++j)
+	{
+		FESurfaceElement& el2 = m_surf2.Element(j);
+		for (int k = 0; k < el2.Nodes(); ++k) nodeOffset[el2.m_node[k] + 1]++;
+	}
+	for (int i = 0; i < NN; ++i) nodeOffset[i + 1] += nodeOffset[i];
+	vector<int> nodeElems(nodeOffset[NN]);
+	vector<int> pos(nodeOffset.begin(), nodeOffset.end() - 1);
+	for (int j = 0; j < m_surf2.Elements(); ++j)
+	{
+		FESurfaceElement& el2 = m_surf2.Element(j);
+		for (int k = 0; k < el2.Nodes(); ++k) nodeElems[pos[el2.m_node[k]]++] = j;
+	}
+
+	int NE1 = m_surf1.Elements();
+	m_nbrOffset.assign(NE1 + 1, 0);
+	m_nbrList.clear();
+	vector<int> nbr;
+	for (int i = 0; i < NE1; ++i)
+	{
+		FESurfaceElement& el1 = m_surf1.Element(i);
+
+		nbr.clear();
+		for (int k = 0; k < el1.Nodes(); ++k)
+		{
+			int nk = el1.m_node[k];
+			for (int l = nodeOffset[nk]; l < nodeOffset[nk + 1]; ++l) nbr.push_back(nodeElems[l]);
+		}
+		sort(nbr.begin(), nbr.end());
+		nbr.erase(unique(nbr.begin(), nbr.end()), nbr.end());
+
+		m_nbrList.insert(m_nbrList.end(), nbr.begin(), nbr.end());
+		m_nbrOffset[i + 1] = (int)m_nbrList.size();
+	}
+
+	// make sure the candidates get built in the first update
+	m_pairOffset.clear();
+	m_r1.clear();
+	m_r2.clear();
+
+	return true;
+}
+
+// largest squared displacement of the integration points of a surface, compared to 
+// the positions in r. Returns -1 if the number of integration points changed.
+static double MaxPointDisplacement2(FESurface& surf, const vector<vec3d>& r)
+{
+	double dmax = 0.0;
+	size_t k = 0;
+	for (int i = 0; i < surf.Elements(); ++i)
+	{
+		FESurfaceElement& el = surf.Element(i);
+		for (int n = 0; n < el.GaussPoints(); ++n, ++k)
+		{
+			if (k >= r.size()) return -1.0;
+			FECPContactPoint& mp = static_cast<FECPContactPoint&>(*el.GetMaterialPoint(n));
+			double d = (mp.m_rt - r[k]).norm2();
+			if (d > dmax) dmax = d;
+		}
+	}
+	return (k == r.size() ? dmax : -1.0);
+}
+
+// store the integration point positions of a surface
+static void StorePointPositions(FESurface& surf, vector<vec3d>& r)
+{
+	r.clear();
+	for (int i = 0; i < surf.Elements(); ++i)
+	{
+		FESurfaceElement& el = surf.Element(i);
+		for (int n = 0; n < el.GaussPoints(); ++n)
+		{
+			FECPContactPoint& mp = static_cast<FECPContactPoint&>(*el.GetMaterialPoint(n));
+			r.push_back(mp.m_rt);
+		}
+	}
+}
+
+// see if the candidate lists need to be rebuilt
+bool FEContactPotential::CandidatesOutdated()
+{
+	if (m_pairOffset.size() != m_surf1.Elements() + 1) return true;
+
+	// Two integration points that are now within R_out were within R_out + d1 + d2 when 
+	// the lists were built. Note that we need to compare the integration points and not
+	// the nodes, since for higher-order elements the integration points can move more
+	// than the nodes.
+	double d1 = MaxPointDisplacement2(m_surf1, m_r1);
+	double d2 = MaxPointDisplacement2(m_surf2, m_r2);
+	if ((d1 < 0.0) || (d2 < 0.0)) return true;
+
+	double skin = (m_skin < 0.0 ? 0.25*m_Rout : m_skin);
+
+	return (sqrt(d1) + sqrt(d2) > skin);
+}
+
+// build the lists of candidate element pairs
+void FEContactPotential::BuildCandidates()
+{
+	double skin = (m_skin < 0.0 ? 0.25*m_Rout : m_skin);
+	double Rs = m_Rout + skin;
+
+	// build the grid
+	int ndivs = (int)pow(m_surf2.Elements(), 0.33333);
+	if (ndivs < 2) ndivs = 2;
+	Grid g(m_surf2, ndivs, Rs);
+
+	// find the candidates of each element
+	int NE1 = m_surf1.Elements();
+	vector< vector<int> > candidates(NE1);
+#pragma omp parallel for shared(g) schedule(dynamic)
+	for (int i = 0; i < NE1; ++i)
 	{
 		FESurfaceElement& el1 = m_surf1.Element(i);
+		vector<int>& elist = candidates[i];
 
-		set<FESurfaceElement*>& nbrList = m_elemNeighbors[i];
-		nbrList.clear();
+		const int* nbr = m_nbrList.data() + m_nbrOffset[i];
+		const int* nbrEnd = m_nbrList.data() + m_nbrOffset[i + 1];
 
-		for (int j = 0; j < m_surf2.Elements(); ++j)
+		for (int n = 0; n < el1.GaussPoints(); ++n)
 		{
-			FESurfaceElement& el2 = m_surf2.Element(j);
-			if (is_neighbor(el1, el2))
+			FECPContactPoint& mp1 = static_cast<FECPContactPoint&>(*el1.GetMaterialPoint(n));
+			vec3d r1 = mp1.m_rt;
+
+			// find the grid cell this point is in and loop over the cell's neighborhood
+			Grid::Cell* c[27] = { nullptr };
+			int nc = g.GetCellNeighborHood(r1, &c[0]);
+			for (int l = 0; l < nc; ++l)
 			{
-				nbrList.insert(&el2);
+				Grid::Cell* cl = c[l];
+				for (int j : cl->m_elemList)
+				{
+					// skip neighbors (which can be the case for self-contact)
+					if (binary_search(nbr, nbrEnd, j)) continue;
+
+					// see if any integration point of el2 is close to the current 
+					// integration point of el1. 
+					FESurfaceElement& el2 = m_surf2.Element(j);
+					for (int m = 0; m < el2.GaussPoints(); ++m)
+					{
+						FECPContactPoint& mp2 = static_cast<FECPContactPoint&>(*el2.GetMaterialPoint(m));
+						vec3d r12 = r1 - mp2.m_rt;
+						if (r12.norm2() < Rs*Rs)
+						{
+							elist.push_back(j);
+							break;
+						}
+					}
+				}
 			}
 		}
+
+		sort(elist.begin(), elist.end());
+		elist.erase(unique(elist.begin(), elist.end()), elist.end());
 	}
 
-	return true;
+	// store the candidates in compressed row format
+	m_pairOffset.assign(NE1 + 1, 0);
+	for (int i = 0; i < NE1; ++i) m_pairOffset[i + 1] = m_pairOffset[i] + (int)candidates[i].size();
+	m_pairList.resize(m_pairOffset[NE1]);
+	for (int i = 0; i < NE1; ++i) copy(candidates[i].begin(), candidates[i].end(), m_pairList.begin() + m_pairOffset[i]);
+	m_activeList.resize(m_pairList.size());
+	m_activeCount.assign(NE1, 0);
+
+	// store the current integration point positions
+	StorePointPositions(m_surf1, m_r1);
+	StorePointPositions(m_surf2, m_r2);
 }
 
 // update
@@ -422,78 +569,68 @@ void FEContactPotential::Update()
 		UpdateSurface(m_surf2);
 	}
 
-	// build the grid
-	int ndivs = (int)pow(m_surf2.Elements(), 0.33333);
-	if (ndivs < 2) ndivs = 2;
-	Grid g(m_surf2, ndivs, m_Rout);
+	// rebuild the candidate lists if the surfaces moved too much
+	if (CandidatesOutdated()) BuildCandidates();
 
-	// build the list of active elements
-	m_activeElements.resize(m_surf1.Elements());
-#pragma omp parallel for shared(g) schedule(dynamic)
-	for (int i = 0; i < m_surf1.Elements(); ++i)
+	// build the list of active elements from the candidates
+	int NE1 = m_surf1.Elements();
+#pragma omp parallel for schedule(dynamic)
+	for (int i = 0; i < NE1; ++i)
 	{
 		FESurfaceElement& el1 = m_surf1.Element(i);
 
-		set<FESurfaceElement*>& activeElems = m_activeElements[i];
-		activeElems.clear();
-
-		set<FESurfaceElement*> nbrList = m_elemNeighbors[i];
+		int* activeElems = m_activeList.data() + m_pairOffset[i];
+		int nactive = 0;
 
 		for (int n = 0; n < el1.GaussPoints(); ++n)
 		{
 			FECPContactPoint& mp1 = static_cast<FECPContactPoint&>(*el1.GetMaterialPoint(n));
 			mp1.m_gap = 0.0;
-			vec3d r1 = mp1.m_rt;
-			vec3d n1 = mp1.dxr ^ mp1.dxs; n1.unit();
+		}
 
-			// find the grid cell this point is in and loop over the cell's neighborhood
-			Grid::Cell* c[27] = { nullptr };
-			int nc = g.GetCellNeighborHood(r1, &c[0]);
-			for (int l = 0; l < nc; ++l)
+		for (int k = m_pairOffset[i]; k < m_pairOffset[i + 1]; ++k)
+		{
+			FESurfaceElement& el2 = m_surf2.Element(m_pairList[k]);
+
+			bool bactive = false;
+			for (int n = 0; n < el1.GaussPoints(); ++n)
 			{
-				Grid::Cell* cl = c[l];
-				for (FESurfaceElement* el2 : cl->m_elemList)
+				FECPContactPoint& mp1 = static_cast<FECPContactPoint&>(*el1.GetMaterialPoint(n));
+				vec3d r1 = mp1.m_rt;
+				vec3d n1 = mp1.dxr ^ mp1.dxs; n1.unit();
+
+				// see if any integration point of el2 is close to the current 
+				// integration point of el1. 
+				for (int m = 0; m < el2.GaussPoints(); ++m)
 				{
-					// make sure we did not process this element yet
-					// and the element is not a neighbor (which can be the case for self-contact)
-					if ((activeElems.find(el2) == activeElems.end()) &&
-						(nbrList.find(el2) == nbrList.end()))
+					FECPContactPoint& mp2 = static_cast<FECPContactPoint&>(*el2.GetMaterialPoint(m));
+
+					vec3d r12 = r1 - mp2.m_rt;
+					if ((r12.x < m_Rout) && (r12.x > -m_Rout) &&
+						(r12.y < m_Rout) && (r12.y > -m_Rout) &&
+						(r12.z < m_Rout) && (r12.z > -m_Rout) &&
+						(r12.norm2() < m_Rout * m_Rout))
 					{
-						// Next, we see if any integration point of el2 is close to the current 
-						// integration point of el1. 
-						for (int m = 0; m < el2->GaussPoints(); ++m)
+						double l12 = r12.unit();
+						if (fabs(r12 * n1) > m_wtol)
 						{
-							FECPContactPoint& mp2 = static_cast<FECPContactPoint&>(*el2->GetMaterialPoint(m));
+							// we found one, so this element is active
+							bactive = true;
 
-							vec3d r12 = r1 - mp2.m_rt;
-							if ((r12.x < m_Rout) && (r12.x > -m_Rout) &&
-								(r12.y < m_Rout) && (r12.y > -m_Rout) &&
-								(r12.z < m_Rout) && (r12.z > -m_Rout) &&
-								(r12.norm2() < m_Rout * m_Rout))
+							if ((mp1.m_gap == 0.0) || (l12 < mp1.m_gap))
 							{
-								double l12 = r12.unit();
-								if (fabs(r12 * n1) > m_wtol)
-								{
-									// we found one, so insert it to the list of active elements
-									activeElems.insert(el2);
-
-//									fprintf(stderr, "r12: %lg, %lg, %lg\n", r12.x, r12.y, r12.z);
-//									fprintf(stderr, "n1 : %lg, %lg, %lg\n", n1.x, n1.y, n1.z);
-//									fprintf(stderr, "l12 = %lg\n", l12);
-
-									if ((mp1.m_gap == 0.0) || (l12 < mp1.m_gap))
-									{
-										mp1.m_gap = l12;
-									}
-									break;
-								}
+								mp1.m_gap = l12;
 							}
+							break;
 						}
-
 					}
 				}
 			}
+
+			if (bactive) activeElems[nactive++] = m_pairList[k];
 		}
+
+		m_activeCount[i] = nactive;
 	}
 }
 
@@ -501,12 +638,13 @@ void FEContactPotential::Update()
 void FEContactPotential::BuildMatrixProfile(FEGlobalMatrix& M)
 {
 	// connect every element of surface 1 to surface 2
+	vector<int> lm;
 	for (int i = 0; i < m_surf1.Elements(); ++i)
 	{
 		FESurfaceElement& el1 = m_surf1.Element(i);
 
 		// add the dofs of element 1
-		vector<int> lm;
+		lm.clear();
 		for (int j = 0; j < el1.Nodes(); ++j)
 		{
 			FENode& node = m_surf1.Node(el1.m_lnode[j]);
@@ -516,12 +654,12 @@ void FEContactPotential::BuildMatrixProfile(FEGlobalMatrix& M)
 		}
 
 		// add all active dofs of surface 2
-		set<FESurfaceElement*>& activeElems = m_activeElements[i];
-		for (FESurfaceElement* el2 : activeElems)
+		for (int k = 0; k < ActiveElements(i); ++k)
 		{
-			for (int j = 0; j < el2->Nodes(); ++j)
+			FESurfaceElement& el2 = ActiveElement(i, k);
+			for (int j = 0; j < el2.Nodes(); ++j)
 			{
-				FENode& node = m_surf2.Node(el2->m_lnode[j]);
+				FENode& node = m_surf2.Node(el2.m_lnode[j]);
 				lm.push_back(node.m_ID[0]);
 				lm.push_back(node.m_ID[1]);
 				lm.push_back(node.m_ID[2]);
@@ -565,6 +703,7 @@ void FEContactPotential::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 	const int ndof = 3;
 
 	// clear all contact tractions
+#pragma omp parallel for
 	for (int i = 0; i < m_surf1.Elements(); ++i)
 	{
 		FESurfaceElement& el = m_surf1.Element(i);
@@ -575,6 +714,7 @@ void FEContactPotential::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 			cp.m_tc = vec3d(0, 0, 0);
 		}
 	}
+#pragma omp parallel for
 	for (int i = 0; i < m_surf2.Elements(); ++i)
 	{
 		FESurfaceElement& el = m_surf2.Element(i);
@@ -596,10 +736,10 @@ void FEContactPotential::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 		vector<double> fe;
 		vector<int> lm;
 
-		// loop over all elements of surf 2
-		set<FESurfaceElement*>& activeElems = m_activeElements[i];
-		for (FESurfaceElement* elj : activeElems)
+		// loop over all active elements of surf 2
+		for (int k = 0; k < ActiveElements(i); ++k)
 		{
+			FESurfaceElement* elj = &ActiveElement(i, k);
 			int nb = elj->Nodes();
 
 			// evaluate contribution to force vector
@@ -629,6 +769,7 @@ void FEContactPotential::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 	}
 
 	// update contact pressures (only needed for plot output)
+#pragma omp parallel for
 	for (int i = 0; i < m_surf1.Elements(); ++i)
 	{
 		FESurfaceElement& el = m_surf1.Element(i);
@@ -638,6 +779,7 @@ void FEContactPotential::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 			cp.m_Ln = cp.m_tc.norm();
 		}
 	}
+#pragma omp parallel for
 	for (int i = 0; i < m_surf2.Elements(); ++i)
 	{
 		FESurfaceElement& el = m_surf2.Element(i);
@@ -686,7 +828,15 @@ void FEContactPotential::ElementForce(FESurfaceElement& el1, FESurfaceElement& e
 			{
 				vec3d F = e12 * df;
 				mp1.m_tc += F * Jw2;
-				mp2.m_tc -= F * Jw1;
+
+				// other threads may be working on the same element of surface 2
+				vec3d F2 = F * Jw1;
+				#pragma omp atomic
+				mp2.m_tc.x -= F2.x;
+				#pragma omp atomic
+				mp2.m_tc.y -= F2.y;
+				#pragma omp atomic
+				mp2.m_tc.z -= F2.z;
 
 				for (int a = 0; a < na; ++a)
 				{
@@ -718,9 +868,9 @@ void FEContactPotential::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo& t
 		FESurfaceElement& eli = m_surf1.Element(i);
 		int na = eli.Nodes();
 
-		set<FESurfaceElement*>& activeElems = m_activeElements[i];
-		for (FESurfaceElement* elj : activeElems)
+		for (int k = 0; k < ActiveElements(i); ++k)
 		{
+			FESurfaceElement* elj = &ActiveElement(i, k);
 			int nb = elj->Nodes();
 
 			FEElementMatrix ke((na + nb) * ndof, (na + nb) * ndof);
@@ -26,7 +26,7 @@ SOFTWARE.*/
 #pragma once
 #include "FEContactInterface.h"
 #include "FEContactSurface.h"
-#include <set>
+#include <vector>
 using namespace std;
 
 class FEContactPotentialSurface : public FEContactSurface
@@ -96,6 +96,18 @@ protected:
 	double PotentialDerive(double r);
 	double PotentialDerive2(double r);
 
+	// see if the candidate lists need to be rebuilt
+	bool CandidatesOutdated();
+
+	// build the lists of candidate element pairs
+	void BuildCandidates();
+
+	// number of active elements of surface 2 for element i of surface 1
+	int ActiveElements(int i) const { return m_activeCount[i]; }
+
+	// get an active element of surface 2 for element i of surface 1
+	FESurfaceElement& ActiveElement(int i, int j) { return m_surf2.Element(m_activeList[m_pairOffset[i] + j]); }
+
 protected:
 	FEContactPotentialSurface	m_surf1;
 	FEContactPotentialSurface	m_surf2;
@@ -106,11 +118,31 @@ protected:
 	double	m_Rin;
 	double	m_Rout;
 	double	m_wtol;
+	double	m_skin;		//!< search distance added to R_out for the candidate lists (< 0 = R_out/4)
 
 	double	m_c1, m_c2;
 
-	vector<	set<FESurfaceElement*> >			m_activeElements;
-	vector< set<FESurfaceElement*> >	m_elemNeighbors;
+	// The lists below are stored in compressed row format: 
+	// row i (i.e. element i of surface 1) starts at offset[i] and ends at offset[i+1].
+
+	// the elements of surface 2 that share a node with elements of surface 1 (for self-contact)
+	vector<int>		m_nbrOffset;
+	vector<int>		m_nbrList;
+
+	// The candidate elements of surface 2 for each element of surface 1. These are all 
+	// the elements within R_out + skin when the list was built. The list is only rebuilt
+	// when the integration points have moved more than the skin distance since the last build.
+	vector<int>		m_pairOffset;
+	vector<int>		m_pairList;
+
+	// the active elements are the candidates that are within R_out. They are stored
+	// at the same offsets as the candidates.
+	vector<int>		m_activeList;
+	vector<int>		m_activeCount;
+
+	// integration point positions when the candidate lists were built
+	vector<vec3d>	m_r1;
+	vector<vec3d>	m_r2;
 
 	DECLARE_FECORE_CLASS();
 };
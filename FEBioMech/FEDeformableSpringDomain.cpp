@@ -810,30 +810,30 @@ void FEDeformableSpringDomain2::UpdateNodes()
 	int NN = Nodes();
 	if (NN <= 2) return;
 
-	// find wire segments
-	int n0 = 0, n1 = 1;
-	while (n0 < NN-1)
+	// find the anchor points on either side of each node
+	vector<int> prev(NN), next(NN);
+	prev[0] = 0;
+	for (int n = 1; n < NN; ++n) prev[n] = (m_nodeData[n].banchor ? n : prev[n - 1]);
+	next[NN - 1] = NN - 1;
+	for (int n = NN - 2; n >= 0; --n) next[n] = (m_nodeData[n].banchor ? n : next[n + 1]);
+
+	// distribute the nodes of each wire segment between its anchors
+	#pragma omp parallel for shared(NN)
+	for (int n = 1; n < NN - 1; ++n)
 	{
-		if (m_nodeData[n1].banchor)
-		{
-			vec3d r0 = Node(n0).m_rt;
-			vec3d r1 = Node(n1).m_rt;
+		if (m_nodeData[n].banchor) continue;
 
-			for (int n = n0+1; n<=n1-1; ++n)
-			{
-				assert(m_nodeData[n].banchor == false);
+		int n0 = prev[n];
+		int n1 = next[n];
+		vec3d r0 = Node(n0).m_rt;
+		vec3d r1 = Node(n1).m_rt;
 
-				double w = (double) (n - n0) / (double)(n1 - n0);
+		double w = (double) (n - n0) / (double)(n1 - n0);
 
-				FENode& nd = Node(n);
-				nd.m_rt = r0 + (r1 - r0)*w;
-				vec3d u = nd.m_rt - nd.m_r0;
-				nd.set_vec3d(m_dofU[0], m_dofU[1], m_dofU[2], u);
-			}
-
-			n0 = n1;
-		}
-		n1++;
+		FENode& nd = Node(n);
+		nd.m_rt = r0 + (r1 - r0)*w;
+		vec3d u = nd.m_rt - nd.m_r0;
+		nd.set_vec3d(m_dofU[0], m_dofU[1], m_dofU[2], u);
 	}
 
 	// re-calculate current length
@@ -208,7 +208,9 @@ void FEDiscreteElasticDomain::Update(const FETimeInfo& tp)
 	double dt = tp.timeIncrement;
 
 	// loop over all discrete elements
-	for (size_t i = 0; i < m_Elem.size(); ++i)
+	int NE = (int)m_Elem.size();
+	#pragma omp parallel for shared(NE)
+	for (int i = 0; i < NE; ++i)
 	{
 		// get the discrete element
 		FEDiscreteElement& el = m_Elem[i];
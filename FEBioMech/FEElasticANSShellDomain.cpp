@@ -849,52 +849,74 @@ void FEElasticANSShellDomain::Update(const FETimeInfo& tp)
 	FESSIShellDomain::Update(tp);
 
     FEMesh& mesh = *GetMesh();
-    const int MELN = FEElement::MAX_NODES;
-    vec3d r0[MELN], rt[MELN];
     
-    int n;
-    for (int i=0; i<(int) m_Elem.size(); ++i)
+    bool berr = false;
+    int NE = Elements();
+    #pragma omp parallel for shared(NE, berr)
+    for (int i=0; i<NE; ++i)
     {
-        // get the solid element
-		FEShellElementNew& el = m_Elem[i];
-        
-        // get the number of integration points
-        int nint = el.GaussPoints();
-        
-        // number of nodes
-        int neln = el.Nodes();
-        
-        // nodal coordinates
-        for (int j=0; j<neln; ++j)
+        try
         {
-            FENode& nj = mesh.Node(el.m_node[j]);
-            r0[j] = nj.m_r0;
-            rt[j] = nj.m_rt;
-        }
-        
-        // loop over the integration points and calculate
-        // the stress at the integration point
-        for (n=0; n<nint; ++n)
-        {
-            FEMaterialPoint& mp = *(el.GetMaterialPoint(n));
-            FEElasticMaterialPoint& pt = *(mp.ExtractData<FEElasticMaterialPoint>());
+            const int MELN = FEElement::MAX_NODES;
+            vec3d r0[MELN], rt[MELN];
+
+            // get the solid element
+            FEShellElementNew& el = m_Elem[i];
             
-            // material point coordinates
-            // TODO: I'm not entirly happy with this solution
-            //         since the material point coordinates are used by most materials.
-            pt.m_r0 = el.Evaluate(r0, n);
-            pt.m_rt = el.Evaluate(rt, n);
+            // get the number of integration points
+            int nint = el.GaussPoints();
             
-            // get the deformation gradient and determinant
-            pt.m_J = defgrad(el, pt.m_F, n);
+            // number of nodes
+            int neln = el.Nodes();
             
-            // update specialized material points
-            m_pMat->UpdateSpecializedMaterialPoints(mp, tp);
+            // nodal coordinates
+            for (int j=0; j<neln; ++j)
+            {
+                FENode& nj = mesh.Node(el.m_node[j]);
+                r0[j] = nj.m_r0;
+                rt[j] = nj.m_rt;
+            }
             
-            // calculate the stress at this material point
-            mat3ds S = m_pMat->PK2Stress(mp, el.m_E[n]);
-            pt.m_s = (pt.m_F*S*pt.m_F.transpose()).sym()/pt.m_J;
+            // loop over the integration points and calculate
+            // the stress at the integration point
+            for (int n=0; n<nint; ++n)
+            {
+                FEMaterialPoint& mp = *(el.GetMaterialPoint(n));
+                FEElasticMaterialPoint& pt = *(mp.ExtractData<FEElasticMaterialPoint>());
+                
+                // material point coordinates
+                // TODO: I'm not entirly happy with this solution
+                //         since the material point coordinates are used by most materials.
+                pt.m_r0 = el.Evaluate(r0, n);
+                pt.m_rt = el.Evaluate(rt, n);
+                
+                // get the deformation gradient and determinant
+                pt.m_J = defgrad(el, pt.m_F, n);
+                
+                // update specialized material points
+                m_pMat->UpdateSpecializedMaterialPoints(mp, tp);
+                
+                // calculate the stress at this material point
+                mat3ds S = m_pMat->PK2Stress(mp, el.m_E[n]);
+                pt.m_s = (pt.m_F*S*pt.m_F.transpose()).sym()/pt.m_J;
+            }
         }
+        catch (NegativeJacobian e)
+        {
+            #pragma omp critical
+            {
+                // reset the logfile mode
+                berr = true;
+                if (e.DoOutput()) feLogError(e.what());
+            }
+        }
+    }
+
+    // if we encountered an error, we request a running restart
+    if (berr)
+    {
+        if (NegativeJacobian::DoOutput() == false) feLogError("Negative jacobian was detected.");
+        throw DoRunningRestart();
     }
 }
 
@@ -0,0 +1,347 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#include "stdafx.h"
+#include "FEElasticMatrixFree.h"
+#include "FEElasticSolidDomain.h"
+#include <FECore/FEModel.h>
+#include <FECore/FEMesh.h>
+
+//-----------------------------------------------------------------------------
+FEElasticMatrixFree::FEElasticMatrixFree(FEModel* fem) : m_fem(fem)
+{
+	m_nrow = m_ncol = 0;
+	m_nsize = 0;
+	m_bcache = true;
+}
+
+//-----------------------------------------------------------------------------
+void FEElasticMatrixFree::SetCacheTangents(bool b)
+{
+	m_bcache = b;
+}
+
+//-----------------------------------------------------------------------------
+void FEElasticMatrixFree::Create(SparseMatrixProfile& MP)
+{
+	// we only need the dimensions of the matrix
+	m_nrow = MP.Rows();
+	m_ncol = MP.Columns();
+	m_nsize = 0;
+
+	m_diag.assign(m_nrow, 0.0);
+	m_Kd.assign(m_nrow, 0.0);
+	m_dom.clear();
+	m_ebe.clear();
+	m_Koff.clear();
+}
+
+//-----------------------------------------------------------------------------
+void FEElasticMatrixFree::Zero()
+{
+	m_diag.assign(m_nrow, 0.0);
+	m_Kd.assign(m_nrow, 0.0);
+	m_dom.clear();
+	m_ebe.clear();
+	m_Koff.clear();
+}
+
+//-----------------------------------------------------------------------------
+void FEElasticMatrixFree::Clear()
+{
+	m_dom.clear();
+	m_ebe.clear();
+	m_Koff.clear();
+	m_diag.clear();
+	m_Kd.clear();
+}
+
+//-----------------------------------------------------------------------------
+bool FEElasticMatrixFree::AddDomain(FEElasticSolidDomain& dom, std::vector<double>& F, const std::vector<double>& u, int nreq)
+{
+	// Nodes that are attached to rigid bodies require a transformation
+	// of the element matrix, so we can't handle those here. 
+	for (int i = 0; i < dom.Nodes(); ++i)
+	{
+		if (dom.Node(i).m_rid >= 0) return false;
+	}
+
+	m_dom.push_back(DOMAIN_DATA());
+	DOMAIN_DATA& dd = m_dom.back();
+	dd.dom = &dom;
+
+	// store the equation numbers and allocate storage for the tangents
+	int NE = dom.Elements();
+	dd.pLM.assign(NE + 1, 0);
+	dd.pD.assign(NE + 1, 0);
+	for (int i = 0; i < NE; ++i)
+	{
+		FESolidElement& el = dom.Element(i);
+		int ne = (el.isActive() ? el.Nodes() : 0);
+		int ni = (el.isActive() ? el.GaussPoints() : 0);
+		dd.pLM[i + 1] = dd.pLM[i] + 3 * ne;
+		dd.pD[i + 1] = dd.pD[i] + (m_bcache ? 36 * ni : 0);
+	}
+	dd.LM.resize(dd.pLM[NE]);
+	dd.D.resize(dd.pD[NE]);
+
+	const int neq = m_nrow;
+	#pragma omp parallel
+	{
+		std::vector<int> lm;
+		std::vector<double> xe(3 * FEElement::MAX_NODES), re(3 * FEElement::MAX_NODES);
+
+		#pragma omp for
+		for (int i = 0; i < NE; ++i)
+		{
+			FESolidElement& el = dom.Element(i);
+			if (el.isActive() == false) continue;
+
+			int ndof = 3 * el.Nodes();
+			dom.UnpackLM(el, lm);
+			int* LM = &dd.LM[dd.pLM[i]];
+			for (int j = 0; j < ndof; ++j) LM[j] = lm[j];
+
+			double* D = (m_bcache ? &dd.D[dd.pD[i]] : nullptr);
+			if (D) dom.ElementTangents(el, D);
+
+			// add to the diagonal
+			dom.ElementStiffnessDiagonal(el, D, &re[0]);
+			for (int j = 0; j < ndof; ++j)
+			{
+				if (LM[j] >= 0)
+				{
+					#pragma omp atomic
+					m_diag[LM[j]] += re[j];
+				}
+			}
+
+			// check for prescribed dofs
+			bool bpresc = false;
+			for (int j = 0; j < ndof; ++j)
+			{
+				int J = -LM[j] - 2;
+				if ((J >= 0) && (J < nreq))
+				{
+					xe[j] = u[J];
+					bpresc = true;
+				}
+				else xe[j] = 0.0;
+			}
+
+			if (bpresc)
+			{
+				// contribution of prescribed dofs to the RHS
+				dom.ElementStiffnessProduct(el, D, &xe[0], &re[0]);
+				for (int j = 0; j < ndof; ++j)
+				{
+					if (LM[j] >= 0)
+					{
+						#pragma omp atomic
+						F[LM[j]] -= re[j];
+					}
+				}
+			}
+		}
+	}
+
+	// set the diagonal element of K to 1 for the prescribed dofs
+	// (this is done here since neighboring elements share these entries)
+	const int NLM = (int)dd.LM.size();
+	for (int i = 0; i < NLM; ++i)
+	{
+		int J = -dd.LM[i] - 2;
+		if ((J >= 0) && (J < nreq) && (J < neq)) m_Kd[J] = 1.0;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void FEElasticMatrixFree::Assemble(const matrix& ke, const std::vector<int>& lm)
+{
+	Assemble(ke, lm, lm);
+}
+
+//-----------------------------------------------------------------------------
+void FEElasticMatrixFree::Assemble(const matrix& ke, const std::vector<int>& lmi, const std::vector<int>& lmj)
+{
+	const int N = ke.rows();
+	const int M = ke.columns();
+
+	#pragma omp critical (FEElasticMatrixFree_Assemble)
+	{
+		// add the diagonal
+		for (int i = 0; i < N; ++i)
+		{
+			int I = lmi[i];
+			if (I < 0) continue;
+			for (int j = 0; j < M; ++j)
+			{
+				if (lmj[j] == I) m_diag[I] += ke[i][j];
+			}
+		}
+
+		// store the element matrix
+		m_ebe.push_back(ELEMENT_MATRIX());
+		ELEMENT_MATRIX& em = m_ebe.back();
+		em.lmi.assign(lmi.begin(), lmi.begin() + N);
+		em.lmj.assign(lmj.begin(), lmj.begin() + M);
+		em.ke = ke;
+	}
+}
+
+//-----------------------------------------------------------------------------
+double FEElasticMatrixFree::AssembledValue(int i, int j) const
+{
+	double v = 0.0;
+	for (size_t n = 0; n < m_ebe.size(); ++n)
+	{
+		const ELEMENT_MATRIX& em = m_ebe[n];
+		const int N = (int)em.lmi.size();
+		const int M = (int)em.lmj.size();
+		for (int k = 0; k < N; ++k)
+		{
+			if (em.lmi[k] != i) continue;
+			for (int l = 0; l < M; ++l)
+			{
+				if (em.lmj[l] == j) v += em.ke[k][l];
+			}
+		}
+	}
+	return v;
+}
+
+//-----------------------------------------------------------------------------
+// The entries of the assembled element matrices are not stored individually, so
+// we overwrite an entry by storing the difference with the assembled value.
+void FEElasticMatrixFree::set(int i, int j, double v)
+{
+	#pragma omp critical (FEElasticMatrixFree_Assemble)
+	{
+		if (i == j) m_Kd[i] = v - m_diag[i];
+		else
+		{
+			// NOTE: this requires a search over all element matrices, but setting
+			// off-diagonal entries is rare.
+			m_Koff[std::pair<int, int>(i, j)] = v - AssembledValue(i, j);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FEElasticMatrixFree::add(int i, int j, double v)
+{
+	if (i == j)
+	{
+		#pragma omp atomic
+		m_Kd[i] += v;
+	}
+	else
+	{
+		#pragma omp critical (FEElasticMatrixFree_Assemble)
+		m_Koff[std::pair<int, int>(i, j)] += v;
+	}
+}
+
+//-----------------------------------------------------------------------------
+bool FEElasticMatrixFree::mult_vector(double* x, double* r)
+{
+	const int neq = m_nrow;
+	#pragma omp parallel for
+	for (int i = 0; i < neq; ++i) r[i] = m_Kd[i] * x[i];
+
+	// the matrix-free domains
+	for (size_t n = 0; n < m_dom.size(); ++n)
+	{
+		DOMAIN_DATA& dd = m_dom[n];
+		FEElasticSolidDomain& dom = *dd.dom;
+		int NE = dom.Elements();
+
+		#pragma omp parallel
+		{
+			double xe[3 * FEElement::MAX_NODES], re[3 * FEElement::MAX_NODES];
+
+			#pragma omp for
+			for (int i = 0; i < NE; ++i)
+			{
+				int ndof = dd.pLM[i + 1] - dd.pLM[i];
+				if (ndof == 0) continue;
+
+				FESolidElement& el = dom.Element(i);
+				const int* LM = &dd.LM[dd.pLM[i]];
+				for (int j = 0; j < ndof; ++j) xe[j] = (LM[j] >= 0 ? x[LM[j]] : 0.0);
+
+				const double* D = (dd.pD[i + 1] > dd.pD[i] ? &dd.D[dd.pD[i]] : nullptr);
+				dom.ElementStiffnessProduct(el, D, xe, re);
+
+				for (int j = 0; j < ndof; ++j)
+				{
+					if (LM[j] >= 0)
+					{
+						#pragma omp atomic
+						r[LM[j]] += re[j];
+					}
+				}
+			}
+		}
+	}
+
+	// all other assembled element matrices
+	const int NEM = (int)m_ebe.size();
+	#pragma omp parallel for schedule(dynamic)
+	for (int n = 0; n < NEM; ++n)
+	{
+		const ELEMENT_MATRIX& em = m_ebe[n];
+		const int N = (int)em.lmi.size();
+		const int M = (int)em.lmj.size();
+		for (int i = 0; i < N; ++i)
+		{
+			int I = em.lmi[i];
+			if (I < 0) continue;
+
+			double ri = 0.0;
+			for (int j = 0; j < M; ++j)
+			{
+				int J = em.lmj[j];
+				if (J >= 0) ri += em.ke[i][j] * x[J];
+			}
+
+			#pragma omp atomic
+			r[I] += ri;
+		}
+	}
+
+	// off-diagonal entries that were set or added directly
+	std::map<std::pair<int, int>, double>::const_iterator it;
+	for (it = m_Koff.begin(); it != m_Koff.end(); ++it)
+	{
+		r[it->first.first] += it->second * x[it->first.second];
+	}
+
+	return true;
+}
@@ -0,0 +1,118 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#pragma once
+#include <FECore/SparseMatrix.h>
+#include "febiomech_api.h"
+#include <vector>
+#include <map>
+
+class FEModel;
+class FEElasticSolidDomain;
+
+//-----------------------------------------------------------------------------
+// This class implements a matrix-free stiffness matrix for solid mechanics problems.
+// The stiffness of elastic solid domains is never assembled. Instead, mult_vector
+// evaluates K*x element by element, using the (optionally cached) material tangents.
+// All other contributions (contact, surface loads, rigid bodies, etc.) are still 
+// assembled through the SparseMatrix interface and are stored element-by-element.
+// Since only mult_vector and diag are available, this matrix can only be used with
+// iterative linear solvers (and a diagonal preconditioner).
+class FEBIOMECH_API FEElasticMatrixFree : public SparseMatrix
+{
+	struct DOMAIN_DATA
+	{
+		FEElasticSolidDomain*	dom;
+		std::vector<int>		LM;		// equation numbers of the elements (3 per node)
+		std::vector<int>		pLM;	// offsets into LM for each element
+		std::vector<int>		pD;		// offsets into D for each element
+		std::vector<double>		D;		// cached material tangents
+	};
+
+	struct ELEMENT_MATRIX
+	{
+		std::vector<int>	lmi, lmj;
+		matrix				ke;
+	};
+
+public:
+	FEElasticMatrixFree(FEModel* fem);
+
+	//! Set whether the material tangents are cached or evaluated during mult_vector
+	void SetCacheTangents(bool b);
+
+	//! Add the stiffness of an elastic solid domain. This returns false if the
+	//! domain cannot be handled matrix-free, in which case it has to be assembled as usual.
+	//! The contributions of prescribed dofs are added to F, using the prescribed values in u.
+	bool AddDomain(FEElasticSolidDomain& dom, std::vector<double>& F, const std::vector<double>& u, int nreq);
+
+public: // from SparseMatrix
+
+	//! multiply with vector
+	bool mult_vector(double* x, double* r) override;
+
+	//! set all matrix elements to zero
+	void Zero() override;
+
+	//! Create a sparse matrix from a sparse-matrix profile
+	void Create(SparseMatrixProfile& MP) override;
+
+	//! assemble a matrix into the sparse matrix
+	void Assemble(const matrix& ke, const std::vector<int>& lm) override;
+
+	//! assemble a matrix into the sparse matrix
+	void Assemble(const matrix& ke, const std::vector<int>& lmi, const std::vector<int>& lmj) override;
+
+	//! check if an entry was allocated
+	bool check(int i, int j) override { return true; }
+
+	//! set entry to value
+	void set(int i, int j, double v) override;
+
+	//! add value to entry
+	void add(int i, int j, double v) override;
+
+	//! get the diagonal value
+	double diag(int i) override { return m_diag[i] + m_Kd[i]; }
+
+	//! release memory for storing data
+	void Clear() override;
+
+private:
+	//! sum of the assembled element matrix entries at (i, j)
+	double AssembledValue(int i, int j) const;
+
+private:
+	FEModel*	m_fem;
+	bool		m_bcache;	//!< cache material tangents
+
+	std::vector<DOMAIN_DATA>		m_dom;	//!< the domains that are evaluated matrix-free
+	std::vector<ELEMENT_MATRIX>		m_ebe;	//!< all other assembled element matrices
+	std::vector<double>	m_diag;		//!< diagonal of assembled element matrices
+	std::vector<double>	m_Kd;		//!< diagonal entries that were set or added directly
+	std::map<std::pair<int, int>, double>	m_Koff;	//!< off-diagonal entries that were set or added directly
+};
@@ -36,6 +36,7 @@ SOFTWARE.*/
 #include <math.h>
 #include <FECore/FESolidDomain.h>
 #include <FECore/FELinearSystem.h>
+#include <FECore/FEElementWorkspace.h>
 #include "FEBioMech.h"
 
 //-----------------------------------------------------------------------------
@@ -149,26 +150,29 @@ void FEElasticShellDomain::PreSolveUpdate(const FETimeInfo& timeInfo)
 // Calculates the forces due to the stress
 void FEElasticShellDomain::InternalForces(FEGlobalVector& R)
 {
+    // make sure the element LM vectors are up to date
+    UpdateLMCache();
+
     int NS = (int)m_Elem.size();
 #pragma omp parallel for shared (NS)
     for (int i=0; i<NS; ++i)
     {
-        // element force vector
-        vector<double> fe;
-        vector<int> lm;
-        
         // get the element
         FEShellElement& el = m_Elem[i];
         
-        // create the element force vector and initialize to zero
+        // get the thread's workspace for this element
         int ndof = 6*el.Nodes();
-        fe.assign(ndof, 0);
+        FEElementWorkspace& ws = FEElementWorkspace::Get(el, ndof);
+
+        // get the element force vector (initialized to zero)
+        vector<double>& fe = ws.Vector();
         
         // calculate element's internal force
         ElementInternalForce(el, fe);
         
         // get the element's LM vector
-        UnpackLM(el, lm);
+        vector<int>& lm = ws.LM();
+        CachedLM(i, lm);
         
         // assemble the residual
         R.Assemble(el.m_node, lm, fe, true);
@@ -241,26 +245,29 @@ void FEElasticShellDomain::ElementInternalForce(FEShellElement& el, vector<doubl
 //-----------------------------------------------------------------------------
 void FEElasticShellDomain::BodyForce(FEGlobalVector& R, FEBodyForce& BF)
 {
+    // make sure the element LM vectors are up to date
+    UpdateLMCache();
+
     int NS = (int)m_Elem.size();
 #pragma omp parallel for
     for (int i=0; i<NS; ++i)
     {
-        // element force vector
-        vector<double> fe;
-        vector<int> lm;
-        
         // get the element
         FEShellElement& el = m_Elem[i];
         
-        // create the element force vector and initialize to zero
+        // get the thread's workspace for this element
         int ndof = 6*el.Nodes();
-        fe.assign(ndof, 0);
+        FEElementWorkspace& ws = FEElementWorkspace::Get(el, ndof);
+        
+        // create the element force vector and initialize to zero
+        vector<double>& fe = ws.Vector();
         
         // apply body forces to shells
         ElementBodyForce(BF, el, fe);
         
         // get the element's LM vector
-        UnpackLM(el, lm);
+        vector<int>& lm = ws.LM();
+        CachedLM(i, lm);
         
         // assemble the residual
         R.Assemble(el.m_node, lm, fe, true);
@@ -315,25 +322,28 @@ void FEElasticShellDomain::ElementBodyForce(FEBodyForce& BF, FEShellElement& el,
 // Calculate inertial forces \todo Why is F no longer needed?
 void FEElasticShellDomain::InertialForces(FEGlobalVector& R, vector<double>& F)
 {
+    // make sure the element LM vectors are up to date
+    UpdateLMCache();
+
     int NE = (int)m_Elem.size();
     for (int i=0; i<NE; ++i)
     {
-        // element force vector
-        vector<double> fe;
-        vector<int> lm;
-        
         // get the element
         FEShellElement& el = m_Elem[i];
         
-        // get the element force vector and initialize it to zero
+        // get the thread's workspace for this element
         int ndof = 6*el.Nodes();
-        fe.assign(ndof, 0);
+        FEElementWorkspace& ws = FEElementWorkspace::Get(el, ndof);
+        
+        // get the element force vector and initialize it to zero
+        vector<double>& fe = ws.Vector();
         
         // calculate internal force vector
         ElementInertialForce(el, fe);
         
         // get the element's LM vector
-        UnpackLM(el, lm);
+        vector<int>& lm = ws.LM();
+        CachedLM(i, lm);
         
         // assemble element 'fe'-vector into global R vector
         R.Assemble(el.m_node, lm, fe, true);
@@ -441,6 +451,9 @@ void FEElasticShellDomain::ElementBodyForceStiffness(FEBodyForce& BF, FEShellEle
 
 void FEElasticShellDomain::StiffnessMatrix(FELinearSystem& LS)
 {
+    // make sure the element LM vectors are up to date
+    UpdateLMCache();
+
     // repeat over all shell elements
     int NS = (int)m_Elem.size();
 #pragma omp parallel for shared (NS)
@@ -448,17 +461,17 @@ void FEElasticShellDomain::StiffnessMatrix(FELinearSystem& LS)
     {
 		FEShellElement& el = m_Elem[iel];
         
-        // create the element's stiffness matrix
-		FEElementMatrix ke(el);
+        // create the element's stiffness matrix, using the thread's workspace
 		int ndof = 6*el.Nodes();
-        ke.resize(ndof, ndof);
+		FEElementWorkspace& ws = FEElementWorkspace::Get(el, ndof);
+		FEElementMatrix& ke = ws.Matrix(el);
         
         // calculate the element stiffness matrix
         ElementStiffness(iel, ke);
         
         // get the element's LM vector
-		vector<int> lm;
-		UnpackLM(el, lm);
+		vector<int>& lm = ws.LM();
+		CachedLM(iel, lm);
 		ke.SetIndices(lm);
         
         // assemble element matrix in global stiffness matrix
@@ -475,17 +488,18 @@ void FEElasticShellDomain::MassMatrix(FELinearSystem& LS, double scale)
     {
 		FEShellElement& el = m_Elem[iel];
         
-        // create the element's stiffness matrix
-		FEElementMatrix ke(el);
+        // get the thread's workspace for this element
 		int ndof = 6*el.Nodes();
-        ke.resize(ndof, ndof);
-        ke.zero();
+		FEElementWorkspace& ws = FEElementWorkspace::Get(el, ndof);
+        
+        // create the element's stiffness matrix (this also zeroes it)
+		FEElementMatrix& ke = ws.Matrix(el);
         
         // calculate inertial stiffness
         ElementMassMatrix(el, ke, scale);
         
         // get the element's LM vector
-		vector<int> lm;
+		vector<int>& lm = ws.LM();
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
         
@@ -504,17 +518,18 @@ void FEElasticShellDomain::BodyForceStiffness(FELinearSystem& LS, FEBodyForce& b
     {
 		FEShellElement& el = m_Elem[iel];
         
-        // create the element's stiffness matrix
-		FEElementMatrix ke(el);
+        // get the thread's workspace for this element
 		int ndof = 6*el.Nodes();
-        ke.resize(ndof, ndof);
-        ke.zero();
+		FEElementWorkspace& ws = FEElementWorkspace::Get(el, ndof);
+        
+        // create the element's stiffness matrix (this also zeroes it)
+		FEElementMatrix& ke = ws.Matrix(el);
         
         // calculate inertial stiffness
         ElementBodyForceStiffness(bf, el, ke);
         
         // get the element's LM vector
-		vector<int> lm;
+		vector<int>& lm = ws.LM();
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
         
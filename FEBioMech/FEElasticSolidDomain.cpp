@@ -36,6 +36,7 @@ SOFTWARE.*/
 #include <FECore/sys.h>
 #include "FEBioMech.h"
 #include <FECore/FELinearSystem.h>
+#include <FECore/FEElementWorkspace.h>
 
 //-----------------------------------------------------------------------------
 //! constructor
@@ -159,6 +160,9 @@ void FEElasticSolidDomain::PreSolveUpdate(const FETimeInfo& timeInfo)
 //-----------------------------------------------------------------------------
 void FEElasticSolidDomain::InternalForces(FEGlobalVector& R)
 {
+	// make sure the element LM vectors are up to date
+	UpdateLMCache();
+
 	int NE = Elements();
 	#pragma omp parallel for shared (NE)
 	for (int i=0; i<NE; ++i)
@@ -167,19 +171,19 @@ void FEElasticSolidDomain::InternalForces(FEGlobalVector& R)
 		FESolidElement& el = m_Elem[i];
 
 		if (el.isActive()) {
-			// element force vector
-			vector<double> fe;
-			vector<int> lm;
+			// get the thread's workspace for this element
+			int ndof = 3 * el.Nodes();
+			FEElementWorkspace& ws = FEElementWorkspace::Get(el, ndof);
 
 			// get the element force vector and initialize it to zero
-			int ndof = 3 * el.Nodes();
-			fe.assign(ndof, 0);
+			vector<double>& fe = ws.Vector();
 
 			// calculate internal force vector
 			ElementInternalForce(el, fe);
 
 			// get the element's LM vector
-			UnpackLM(el, lm);
+			vector<int>& lm = ws.LM();
+			CachedLM(i, lm);
 
 			// assemble element 'fe'-vector into global R vector
 			R.Assemble(el.m_node, lm, fe);
@@ -192,39 +196,40 @@ void FEElasticSolidDomain::InternalForces(FEGlobalVector& R)
 
 void FEElasticSolidDomain::ElementInternalForce(FESolidElement& el, vector<double>& fe)
 {
-	// jacobian matrix, inverse jacobian matrix and determinants
-	double Ji[3][3];
-
 	int nint = el.GaussPoints();
 	int neln = el.Nodes();
 
 	double*	gw = el.GaussWeights();
 
+	// nodal coordinates
+	vec3d rt[FEElement::MAX_NODES];
+	if (m_update_dynamic) GetCurrentNodalCoordinates(el, rt, m_alphaf);
+	else GetCurrentNodalCoordinates(el, rt);
+
+	// global derivatives of shape functions and jacobian determinants at all integration points
+	vec3d G[FEElement::MAX_NODES*FEElement::MAX_INTPOINTS];
+	double detJ[FEElement::MAX_INTPOINTS];
+	ShapeGradients(el, rt, G, detJ);
+
 	// repeat for all integration points
 	for (int n=0; n<nint; ++n)
 	{
 		FEMaterialPoint& mp = *el.GetMaterialPoint(n);
 		FEElasticMaterialPoint& pt = *(mp.ExtractData<FEElasticMaterialPoint>());
 
-		// calculate the jacobian
-		double detJt = (m_update_dynamic ? invjact(el, Ji, n, m_alphaf) : invjact(el, Ji, n));
-
-		detJt *= gw[n];
+		double detJt = detJ[n]*gw[n];
 
 		// get the stress vector for this integration point
         const mat3ds& s = pt.m_s;
 
-		const double* Gr = el.Gr(n);
-		const double* Gs = el.Gs(n);
-		const double* Gt = el.Gt(n);
+		const vec3d* Gn = G + n*neln;
 
 		for (int i=0; i<neln; ++i)
 		{
-			// calculate global gradient of shape functions
-			// note that we need the transposed of Ji, not Ji itself !
-			double Gx = Ji[0][0]*Gr[i]+Ji[1][0]*Gs[i]+Ji[2][0]*Gt[i];
-			double Gy = Ji[0][1]*Gr[i]+Ji[1][1]*Gs[i]+Ji[2][1]*Gt[i];
-			double Gz = Ji[0][2]*Gr[i]+Ji[1][2]*Gs[i]+Ji[2][2]*Gt[i];
+			// global gradient of shape functions
+			double Gx = Gn[i].x;
+			double Gy = Gn[i].y;
+			double Gz = Gn[i].z;
 
 			// calculate internal force
 			// the '-' sign is so that the internal forces get subtracted
@@ -279,19 +284,25 @@ void FEElasticSolidDomain::BodyForce(FEGlobalVector& R, FEBodyForce& BF)
 //! calculates element's geometrical stiffness component for integration point n
 void FEElasticSolidDomain::ElementGeometricalStiffness(FESolidElement &el, matrix &ke)
 {
-	// spatial derivatives of shape functions
-	vec3d G[FEElement::MAX_NODES];
-
 	// weights at gauss points
 	const double *gw = el.GaussWeights();
 
-	// calculate geometrical element stiffness matrix
 	int neln = el.Nodes();
 	int nint = el.GaussPoints();
+
+	// spatial derivatives of shape functions and jacobians at all integration points
+	vec3d rt[FEElement::MAX_NODES];
+	GetCurrentNodalCoordinates(el, rt, m_alphaf);
+	vec3d GN[FEElement::MAX_NODES*FEElement::MAX_INTPOINTS];
+	double detJ[FEElement::MAX_INTPOINTS];
+	ShapeGradients(el, rt, GN, detJ);
+
+	// calculate geometrical element stiffness matrix
 	for (int n = 0; n<nint; ++n)
 	{
-		// calculate shape function gradients and jacobian
-		double w = ShapeGradient(el, n, G, m_alphaf)*gw[n]*m_alphaf;
+		// shape function gradients and jacobian
+		const vec3d* G = GN + n*neln;
+		double w = detJ[n]*gw[n]*m_alphaf;
 
 		// get the material point data
 		FEMaterialPoint& mp = *el.GetMaterialPoint(n);
@@ -321,8 +332,12 @@ void FEElasticSolidDomain::ElementMaterialStiffness(FESolidElement &el, matrix &
 	const int nint = el.GaussPoints();
 	const int neln = el.Nodes();
 
-	// global derivatives of shape functions
-	vec3d G[FEElement::MAX_NODES];
+	// global derivatives of shape functions and jacobians at all integration points
+	vec3d rt[FEElement::MAX_NODES];
+	GetCurrentNodalCoordinates(el, rt, m_alphaf);
+	vec3d GN[FEElement::MAX_NODES*FEElement::MAX_INTPOINTS];
+	double detJ[FEElement::MAX_INTPOINTS];
+	ShapeGradients(el, rt, GN, detJ);
 
 	double Gxi, Gyi, Gzi;
 	double Gxj, Gyj, Gzj;
@@ -342,8 +357,9 @@ void FEElasticSolidDomain::ElementMaterialStiffness(FESolidElement &el, matrix &
 	// calculate element stiffness matrix
 	for (int n=0; n<nint; ++n)
 	{
-		// calculate jacobian and shape function gradients
-		detJt = ShapeGradient(el, n, G, m_alphaf)*gw[n]*m_alphaf;
+		// jacobian and shape function gradients
+		const vec3d* G = GN + n*neln;
+		detJt = detJ[n]*gw[n]*m_alphaf;
 
 		// setup the material point
 		// NOTE: deformation gradient and determinant have already been evaluated in the stress routine
@@ -410,9 +426,170 @@ void FEElasticSolidDomain::ElementMaterialStiffness(FESolidElement &el, matrix &
 	}
 }
 
+//-----------------------------------------------------------------------------
+//! Evaluates the material tangents at all integration points of the element and
+//! stores them (in 6x6 matrix format) in D. D must have room for 36*nint values.
+void FEElasticSolidDomain::ElementTangents(FESolidElement& el, double* D)
+{
+	const int nint = el.GaussPoints();
+	for (int n = 0; n < nint; ++n)
+	{
+		FEMaterialPoint& mp = *el.GetMaterialPoint(n);
+		tens4dmm C = m_pMat->SolidTangent(mp);
+
+		double Dn[6][6];
+		C.extract(Dn);
+		double* d = D + 36 * n;
+		for (int i = 0; i < 6; ++i)
+			for (int j = 0; j < 6; ++j) d[6 * i + j] = Dn[i][j];
+	}
+}
+
+//-----------------------------------------------------------------------------
+//! Calculates the product of the element stiffness matrix (material and 
+//! geometrical parts) with the vector xe, without forming the stiffness matrix.
+//! Instead of looping over all node pairs, this evaluates the strain (B*xe) at 
+//! each integration point first, which is only linear in the number of nodes.
+//! If D is null, the material tangents are evaluated on the fly.
+void FEElasticSolidDomain::ElementStiffnessProduct(FESolidElement& el, const double* D, const double* xe, double* re)
+{
+	const int nint = el.GaussPoints();
+	const int neln = el.Nodes();
+	const double *gw = el.GaussWeights();
+
+	// global derivatives of shape functions
+	vec3d G[FEElement::MAX_NODES];
+
+	for (int i = 0; i < 3 * neln; ++i) re[i] = 0.0;
+
+	double Dn[6][6];
+	for (int n = 0; n<nint; ++n)
+	{
+		// calculate jacobian and shape function gradients
+		double w = ShapeGradient(el, n, G, m_alphaf)*gw[n] * m_alphaf;
+
+		FEMaterialPoint& mp = *el.GetMaterialPoint(n);
+		FEElasticMaterialPoint& pt = *(mp.ExtractData<FEElasticMaterialPoint>());
+		const mat3ds& s = pt.m_s;
+
+		// get the 'D' matrix
+		const double* d = (D ? D + 36 * n : &Dn[0][0]);
+		if (D == nullptr)
+		{
+			tens4dmm C = m_pMat->SolidTangent(mp);
+			C.extract(Dn);
+		}
+
+		// evaluate the strain e = B*xe and the gradient L = sum G_j x xe_j
+		double e[6] = { 0 };
+		double L[3][3] = { 0 };
+		for (int j = 0; j < neln; ++j)
+		{
+			const double Gx = G[j].x, Gy = G[j].y, Gz = G[j].z;
+			const double ux = xe[3*j], uy = xe[3*j+1], uz = xe[3*j+2];
+
+			e[0] += Gx*ux;
+			e[1] += Gy*uy;
+			e[2] += Gz*uz;
+			e[3] += Gy*ux + Gx*uy;
+			e[4] += Gz*uy + Gy*uz;
+			e[5] += Gz*ux + Gx*uz;
+
+			L[0][0] += Gx*ux; L[0][1] += Gx*uy; L[0][2] += Gx*uz;
+			L[1][0] += Gy*ux; L[1][1] += Gy*uy; L[1][2] += Gy*uz;
+			L[2][0] += Gz*ux; L[2][1] += Gz*uy; L[2][2] += Gz*uz;
+		}
+
+		// "stress" t = D*e
+		double t[6];
+		for (int k = 0; k < 6; ++k)
+		{
+			const double* dk = d + 6 * k;
+			t[k] = (dk[0]*e[0] + dk[1]*e[1] + dk[2]*e[2] + dk[3]*e[3] + dk[4]*e[4] + dk[5]*e[5])*w;
+		}
+
+		// re += B^T*t (material) + (G*s*G)*xe (geometrical)
+		for (int i = 0; i < neln; ++i)
+		{
+			const double Gx = G[i].x, Gy = G[i].y, Gz = G[i].z;
+
+			vec3d sG = s*G[i];
+			sG *= w;
+
+			re[3*i  ] += Gx*t[0] + Gy*t[3] + Gz*t[5] + sG.x*L[0][0] + sG.y*L[1][0] + sG.z*L[2][0];
+			re[3*i+1] += Gy*t[1] + Gx*t[3] + Gz*t[4] + sG.x*L[0][1] + sG.y*L[1][1] + sG.z*L[2][1];
+			re[3*i+2] += Gz*t[2] + Gy*t[4] + Gx*t[5] + sG.x*L[0][2] + sG.y*L[1][2] + sG.z*L[2][2];
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//! Calculates the diagonal of the element stiffness matrix. 
+//! If D is null, the material tangents are evaluated on the fly.
+void FEElasticSolidDomain::ElementStiffnessDiagonal(FESolidElement& el, const double* D, double* de)
+{
+	const int nint = el.GaussPoints();
+	const int neln = el.Nodes();
+	const double *gw = el.GaussWeights();
+
+	// global derivatives of shape functions
+	vec3d G[FEElement::MAX_NODES];
+
+	for (int i = 0; i < 3 * neln; ++i) de[i] = 0.0;
+
+	double Dn[6][6];
+	for (int n = 0; n<nint; ++n)
+	{
+		// calculate jacobian and shape function gradients
+		double w = ShapeGradient(el, n, G, m_alphaf)*gw[n] * m_alphaf;
+
+		FEMaterialPoint& mp = *el.GetMaterialPoint(n);
+		FEElasticMaterialPoint& pt = *(mp.ExtractData<FEElasticMaterialPoint>());
+		const mat3ds& s = pt.m_s;
+
+		// get the 'D' matrix
+		const double* d = (D ? D + 36 * n : &Dn[0][0]);
+		if (D == nullptr)
+		{
+			tens4dmm C = m_pMat->SolidTangent(mp);
+			C.extract(Dn);
+		}
+
+		for (int i = 0; i < neln; ++i)
+		{
+			const double Gx = G[i].x, Gy = G[i].y, Gz = G[i].z;
+
+			// the columns of the B matrix for this node
+			const double B[3][6] = {
+				{ Gx, 0, 0, Gy, 0, Gz },
+				{ 0, Gy, 0, Gx, Gz, 0 },
+				{ 0, 0, Gz, 0, Gy, Gx }};
+
+			// geometrical stiffness
+			double kg = G[i] * (s*G[i]);
+
+			for (int m = 0; m < 3; ++m)
+			{
+				const double* b = B[m];
+				double kmm = 0.0;
+				for (int k = 0; k < 6; ++k)
+				{
+					if (b[k] == 0.0) continue;
+					const double* dk = d + 6 * k;
+					kmm += b[k] * (dk[0]*b[0] + dk[1]*b[1] + dk[2]*b[2] + dk[3]*b[3] + dk[4]*b[4] + dk[5]*b[5]);
+				}
+				de[3*i + m] += (kmm + kg)*w;
+			}
+		}
+	}
+}
+
 //-----------------------------------------------------------------------------
 void FEElasticSolidDomain::StiffnessMatrix(FELinearSystem& LS)
 {
+	// make sure the element LM vectors are up to date
+	UpdateLMCache();
+
 	// repeat over all solid elements
 	int NE = Elements();
 	
@@ -423,17 +600,17 @@ void FEElasticSolidDomain::StiffnessMatrix(FELinearSystem& LS)
 
 		if (el.isActive()) {
 
-			// get the element's LM vector
-			vector<int> lm;
-			UnpackLM(el, lm);
+			// get the thread's workspace for this element
+			int ndof = 3 * el.Nodes();
+			FEElementWorkspace& ws = FEElementWorkspace::Get(el, ndof);
 
-			// element stiffness matrix
-			FEElementMatrix ke(el, lm);
+			// get the element's LM vector
+			vector<int>& lm = ws.LM();
+			CachedLM(iel, lm);
 
-			// create the element's stiffness matrix
-			int ndof = 3 * el.Nodes();
-			ke.resize(ndof, ndof);
-			ke.zero();
+			// create the element's stiffness matrix (this also zeroes it)
+			FEElementMatrix& ke = ws.Matrix(el);
+			ke.SetIndices(lm);
 
 			// calculate geometrical stiffness
 			ElementGeometricalStiffness(el, ke);
@@ -711,6 +888,9 @@ void FEElasticSolidDomain::UnpackLM(FEElement& el, vector<int>& lm)
 // Calculate inertial forces \todo Why is F no longer needed?
 void FEElasticSolidDomain::InertialForces(FEGlobalVector& R, vector<double>& F)
 {
+	// make sure the element LM vectors are up to date
+	UpdateLMCache();
+
     int NE = Elements();
     for (int i=0; i<NE; ++i)
     {
@@ -718,19 +898,19 @@ void FEElasticSolidDomain::InertialForces(FEGlobalVector& R, vector<double>& F)
 		FESolidElement& el = m_Elem[i];
 
 		if (el.isActive()) {
-			// element force vector
-			vector<double> fe;
-			vector<int> lm;
+			// get the thread's workspace for this element
+			int ndof = 3 * el.Nodes();
+			FEElementWorkspace& ws = FEElementWorkspace::Get(el, ndof);
 
 			// get the element force vector and initialize it to zero
-			int ndof = 3 * el.Nodes();
-			fe.assign(ndof, 0);
+			vector<double>& fe = ws.Vector();
 
 			// calculate internal force vector
 			ElementInertialForce(el, fe);
 
 			// get the element's LM vector
-			UnpackLM(el, lm);
+			vector<int>& lm = ws.LM();
+			CachedLM(i, lm);
 
 			// assemble element 'fe'-vector into global R vector
 			R.Assemble(el.m_node, lm, fe);
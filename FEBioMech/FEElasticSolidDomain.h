@@ -108,6 +108,17 @@ public:
 	//! material stiffness component
 	virtual void ElementMaterialStiffness(FESolidElement& el, matrix& ke);
 
+	// --- M A T R I X - F R E E ---
+
+	//! store the material tangents (6x6 per integration point) of an element
+	void ElementTangents(FESolidElement& el, double* D);
+
+	//! calculate ke*xe without forming ke. The tangents D are optional (see ElementTangents).
+	void ElementStiffnessProduct(FESolidElement& el, const double* D, const double* xe, double* re);
+
+	//! calculate the diagonal of ke
+	void ElementStiffnessDiagonal(FESolidElement& el, const double* D, double* de);
+
 	// --- R E S I D U A L ---
 
 	//! Calculates the internal stress vector for solid elements
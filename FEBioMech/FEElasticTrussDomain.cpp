@@ -244,9 +244,12 @@ void FEElasticTrussDomain::ElementInternalForces(FETrussElement& el, vector<doub
 void FEElasticTrussDomain::Update(const FETimeInfo& tp)
 {
 	// loop over all elements
-	vec3d r0[2], rt[2];
-	for (int i=0; i<(int) m_Elem.size(); ++i)
+	int NE = (int) m_Elem.size();
+	#pragma omp parallel for shared(NE)
+	for (int i=0; i<NE; ++i)
 	{
+		vec3d r0[2], rt[2];
+
 		// unpack the element
 		FETrussElement& el = m_Elem[i];
 
@@ -32,9 +32,16 @@ SOFTWARE.*/
 #include "FECore/log.h"
 #include <FECore/FEMesh.h>
 
+//-----------------------------------------------------------------------------
+BEGIN_FECORE_CLASS(FEMortarInterface, FEContactInterface)
+	ADD_PARAMETER(m_srad, FE_RANGE_GREATER_OR_EQUAL(0.0), "search_radius");
+END_FECORE_CLASS();
+
 //-----------------------------------------------------------------------------
 FEMortarInterface::FEMortarInterface(FEModel* pfem) : FEContactInterface(pfem)
 {
+	m_srad = 0.0;
+
 	// set the integration rule
 	m_pT = dynamic_cast<FESurfaceElementTraits*>(FEElementLibrary::GetElementTraits(FE_TRI3G7));
 }
@@ -43,17 +50,15 @@ FEMortarInterface::FEMortarInterface(FEModel* pfem) : FEContactInterface(pfem)
 void FEMortarInterface::UpdateMortarWeights(FESurface& ss, FESurface& ms)
 {
 	// allocate sturcture for the integration weights
+	// (this also clears the weights)
 	int NS = ss.Nodes();
 	int NM = ms.Nodes();
-	m_n1.resize(NS,NS);
-	m_n2.resize(NS,NM);
-
-	// clear weights
-	m_n1.zero();
-	m_n2.zero();
+	m_n1.Create(NS);
+	m_n2.Create(NS);
 
 	// number of integration points
 	const int MAX_INT = 11;
+	const int MAX_NODES = 4;
 	const int nint = m_pT->m_nint;
 	vector<double>& gw = m_pT->gw;
 	vector<double>& gr = m_pT->gr;
@@ -61,18 +66,29 @@ void FEMortarInterface::UpdateMortarWeights(FESurface& ss, FESurface& ms)
 
 	// calculate the mortar surface
 	MortarSurface mortar;
-	CalculateMortarSurface(ss, ms, mortar);
+	CalculateMortarSurface(ss, ms, mortar, m_srad);
 
-	// These arrays will store the shape function values of the projection points 
-	// on the primary and secondary side when evaluating the integral over a pallet
-	double Ns[MAX_INT][4], Nm[MAX_INT][4];
+	// The contributions of each patch are evaluated in parallel and stored
+	// in a small dense block, which are then added to the weights.
+	struct PATCH_WEIGHTS
+	{
+		double	n1[MAX_NODES][MAX_NODES];
+		double	n2[MAX_NODES][MAX_NODES];
+	};
+	int NP = mortar.Patches();
+	vector<PATCH_WEIGHTS> pw(NP);
 
 	// loop over the mortar patches
-	int NP = mortar.Patches();
+#pragma omp parallel for schedule(dynamic, 16)
 	for (int i=0; i<NP; ++i)
 	{
+		// These arrays will store the shape function values of the projection points 
+		// on the primary and secondary side when evaluating the integral over a pallet
+		double Ns[MAX_INT][MAX_NODES], Nm[MAX_INT][MAX_NODES];
+
 		// get the next patch
 		Patch& pi = mortar.GetPatch(i);
+		PATCH_WEIGHTS& wi = pw[i];
 
 		// get the facet ID's that generated this patch
 		int k = pi.GetPrimaryFacetID();
@@ -83,6 +99,14 @@ void FEMortarInterface::UpdateMortarWeights(FESurface& ss, FESurface& ms)
 		// get the mortar surface element
 		FESurfaceElement& me = ms.Element(l);
 
+		int ns = se.Nodes();
+		int nm = me.Nodes();
+		for (int A=0; A<ns; ++A)
+		{
+			for (int B=0; B<ns; ++B) wi.n1[A][B] = 0.0;
+			for (int C=0; C<nm; ++C) wi.n2[A][C] = 0.0;
+		}
+
 		// loop over all patch triangles
 		int np = pi.Size();
 		for (int j=0; j<np; ++j)
@@ -117,12 +141,8 @@ void FEMortarInterface::UpdateMortarWeights(FESurface& ss, FESurface& ms)
 				}
 
 				// Evaluate the contributions to the integrals
-				int ns = se.Nodes();
-				int nm = me.Nodes();
 				for (int A=0; A<ns; ++A)
 				{
-					int a = se.m_lnode[A];
-
 					// loop over all the nodes on the primary facet
 					for (int B=0; B<ns; ++B)
 					{
@@ -131,10 +151,7 @@ void FEMortarInterface::UpdateMortarWeights(FESurface& ss, FESurface& ms)
 						{
 							n1 += gw[n]*Ns[n][A]*Ns[n][B];
 						}
-						n1 *= Area;
-
-						int b = se.m_lnode[B];
-						m_n1[a][b] += n1;
+						wi.n1[A][B] += n1*Area;
 					}
 
 					// loop over all the nodes on the secondary facet
@@ -145,26 +162,35 @@ void FEMortarInterface::UpdateMortarWeights(FESurface& ss, FESurface& ms)
 						{
 							n2 += gw[n]*Ns[n][A]*Nm[n][C];
 						}
-						n2 *= Area;
-
-						int c = me.m_lnode[C];
-						m_n2[a][c] += n2;
+						wi.n2[A][C] += n2*Area;
 					}
 				}
 			}		
 		}
 	}
 
+	// add the patch contributions to the weights
+	for (int i=0; i<NP; ++i)
+	{
+		Patch& pi = mortar.GetPatch(i);
+		PATCH_WEIGHTS& wi = pw[i];
+		FESurfaceElement& se = ss.Element(pi.GetPrimaryFacetID());
+		FESurfaceElement& me = ms.Element(pi.GetSecondaryFacetID());
+		int ns = se.Nodes();
+		int nm = me.Nodes();
+		for (int A=0; A<ns; ++A)
+		{
+			int a = se.m_lnode[A];
+			for (int B=0; B<ns; ++B) m_n1.Add(a, se.m_lnode[B], wi.n1[A][B]);
+			for (int C=0; C<nm; ++C) m_n2.Add(a, me.m_lnode[C], wi.n2[A][C]);
+		}
+	}
+
 #ifdef _DEBUG
 	// Sanity check: sum should add up to contact area
 	// This is for a hardcoded problem. Remove or generalize this!
-	double sum1 = 0.0;
-	for (int A=0; A<NS; ++A)
-		for (int B=0; B<NS; ++B) sum1 += m_n1[A][B];
-
-	double sum2 = 0.0;
-	for (int A=0; A<NS; ++A)
-		for (int C=0; C<NM; ++C) sum2 += m_n2[A][C];
+	double sum1 = m_n1.Sum();
+	double sum2 = m_n2.Sum();
 
 	if (fabs(sum1 - 1.0) > 1e-5) feLog("WARNING: Mortar weights are not correct (%lg).\n", sum1);
 	if (fabs(sum2 - 1.0) > 1e-5) feLog("WARNING: Mortar weights are not correct (%lg).\n", sum2);
@@ -175,32 +201,31 @@ void FEMortarInterface::UpdateMortarWeights(FESurface& ss, FESurface& ms)
 //! Update the nodal gaps
 void FEMortarInterface::UpdateNodalGaps(FEMortarContactSurface& ss, FEMortarContactSurface& ms)
 {
-	// reset nodal gaps
 	vector<vec3d>& gap = ss.m_gap;
-	zero(ss.m_gap);
-
 	int NS = ss.Nodes();
-	int NM = ms.Nodes();
 
 	// loop over all primary nodes
+#pragma omp parallel for
 	for (int A=0; A<NS; ++A)
 	{
-		// loop over all primary nodes
-		for (int B=0; B<NS; ++B)
+		vec3d gA(0,0,0);
+
+		// loop over all primary nodes that share a patch with A
+		const MortarWeights::ROW& n1 = m_n1.Row(A);
+		for (size_t i=0; i<n1.size(); ++i)
 		{
-			FENode& nodeB = ss.Node(B);
-			vec3d& xB = nodeB.m_rt;
-			double nAB = m_n1[A][B];
-			gap[A] += xB*nAB;
+			vec3d& xB = ss.Node(n1[i].col).m_rt;
+			gA += xB*n1[i].val;
 		}
 
 		// loop over secondary side
-		for (int C=0; C<NM; ++C)
+		const MortarWeights::ROW& n2 = m_n2.Row(A);
+		for (size_t i=0; i<n2.size(); ++i)
 		{
-			FENode& nodeC = ms.Node(C);
-			vec3d& xC = nodeC.m_rt;
-			double nAC = m_n2[A][C];
-			gap[A] -= xC*nAC;
+			vec3d& xC = ms.Node(n2[i].col).m_rt;
+			gA -= xC*n2[i].val;
 		}
+
+		gap[A] = gA;
 	}
 }
@@ -29,6 +29,7 @@ SOFTWARE.*/
 #pragma once
 #include "FEContactInterface.h"
 #include "FEMortarContactSurface.h"
+#include <FECore/mortar.h>
 
 //-----------------------------------------------------------------------------
 // Base class for mortar-type contact formulations
@@ -45,10 +46,14 @@ public:
 	void UpdateNodalGaps(FEMortarContactSurface& ss, FEMortarContactSurface& ms);
 
 protected:
-	matrix	m_n1;	//!< integration weights n1_AB
-	matrix	m_n2;	//!< integration weights n2_AB
+	MortarWeights	m_n1;	//!< integration weights n1_AB (NS x NS)
+	MortarWeights	m_n2;	//!< integration weights n2_AB (NS x NM)
+
+	double	m_srad;	//!< search radius for finding overlapping facets
 
 private:
 	// integration rule
 	FESurfaceElementTraits*	m_pT;
+
+	DECLARE_FECORE_CLASS();
 };
@@ -210,15 +210,17 @@ void FEMortarSlidingContact::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 		vector<int> en(1);
 		vector<int> lm(3);
 		vector<double> fe(3);
-		for (int B=0; B<NS; ++B)
+		const MortarWeights::ROW& n1 = m_n1.Row(A);
+		for (size_t i=0; i<n1.size(); ++i)
 		{
+			int B = n1[i].col;
 			FENode& nodeB = m_ss.Node(B);
 			en[0] = m_ss.NodeIndex(B);
 			lm[0] = nodeB.m_ID[m_dofX];
 			lm[1] = nodeB.m_ID[m_dofY];
 			lm[2] = nodeB.m_ID[m_dofZ];
 
-			double nAB = -m_n1[A][B];
+			double nAB = -n1[i].val;
 			if (nAB != 0.0)
 			{
 				fe[0] = tA.x*nAB;
@@ -230,15 +232,17 @@ void FEMortarSlidingContact::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 		}
 
 		// loop over secondary side
-		for (int C=0; C<NM; ++C)
+		const MortarWeights::ROW& n2 = m_n2.Row(A);
+		for (size_t i=0; i<n2.size(); ++i)
 		{
+			int C = n2[i].col;
 			FENode& nodeC = m_ms.Node(C);
 			en[0] = m_ms.NodeIndex(C);
 			lm[0] = nodeC.m_ID[m_dofX];
 			lm[1] = nodeC.m_ID[m_dofY];
 			lm[2] = nodeC.m_ID[m_dofZ];
 
-			double nAC = m_n2[A][C];
+			double nAC = n2[i].val;
 			if (nAC != 0.0)
 			{
 				fe[0] = tA.x*nAC;
@@ -276,15 +280,20 @@ void FEMortarSlidingContact::ContactGapStiffness(FELinearSystem& LS)
 		vec3d nuA = m_ss.m_nu[A];
 		double eps = m_eps*m_ss.m_A[A];
 
+		// the weights of the nodes that share a patch with A
+		const MortarWeights::ROW& n1 = m_n1.Row(A);
+		const MortarWeights::ROW& n2 = m_n2.Row(A);
+
 		// loop over all primary nodes
-		for (int B=0; B<NS; ++B)
+		for (size_t iB=0; iB<n1.size(); ++iB)
 		{
+			int B = n1[iB].col;
 			FENode& nodeB = m_ss.Node(B);
 			lmi[0] = nodeB.m_ID[0];
 			lmi[1] = nodeB.m_ID[1];
 			lmi[2] = nodeB.m_ID[2];
 
-			double nAB = m_n1[A][B];
+			double nAB = n1[iB].val;
 			if (nAB != 0.0)
 			{
 				kA[0][0] = eps*nAB*(nuA.x*nuA.x); kA[0][1] = eps*nAB*(nuA.x*nuA.y); kA[0][2] = eps*nAB*(nuA.x*nuA.z);
@@ -292,14 +301,15 @@ void FEMortarSlidingContact::ContactGapStiffness(FELinearSystem& LS)
 				kA[2][0] = eps*nAB*(nuA.z*nuA.x); kA[2][1] = eps*nAB*(nuA.z*nuA.y); kA[2][2] = eps*nAB*(nuA.z*nuA.z);
 
 				// loop over primary nodes
-				for (int C=0; C<NS; ++C)
+				for (size_t iC=0; iC<n1.size(); ++iC)
 				{
+					int C = n1[iC].col;
 					FENode& nodeC = m_ss.Node(C);
 					lmj[0] = nodeC.m_ID[0];
 					lmj[1] = nodeC.m_ID[1];
 					lmj[2] = nodeC.m_ID[2];
 
-					double nAC = m_n1[A][C];
+					double nAC = n1[iC].val;
 					if (nAC != 0.0)
 					{
 						kG[0][0] = nAC; kG[0][1] = 0.0; kG[0][2] = 0.0;
@@ -314,14 +324,15 @@ void FEMortarSlidingContact::ContactGapStiffness(FELinearSystem& LS)
 				}
 
 				// loop over secondary nodes
-				for (int C=0; C<NM; ++C)
+				for (size_t iC=0; iC<n2.size(); ++iC)
 				{
+					int C = n2[iC].col;
 					FENode& nodeC = m_ms.Node(C);
 					lmj[0] = nodeC.m_ID[0];
 					lmj[1] = nodeC.m_ID[1];
 					lmj[2] = nodeC.m_ID[2];
 
-					double nAC = -m_n2[A][C];
+					double nAC = -n2[iC].val;
 					if (nAC != 0.0)
 					{
 						kG[0][0] = nAC; kG[0][1] = 0.0; kG[0][2] = 0.0;
@@ -338,14 +349,15 @@ void FEMortarSlidingContact::ContactGapStiffness(FELinearSystem& LS)
 		}
 
 		// loop over all secondary nodes
-		for (int B=0; B<NM; ++B)
+		for (size_t iB=0; iB<n2.size(); ++iB)
 		{
+			int B = n2[iB].col;
 			FENode& nodeB = m_ms.Node(B);
 			lmi[0] = nodeB.m_ID[0];
 			lmi[1] = nodeB.m_ID[1];
 			lmi[2] = nodeB.m_ID[2];
 
-			double nAB = -m_n2[A][B];
+			double nAB = -n2[iB].val;
 			if (nAB != 0.0)
 			{
 				kA[0][0] = eps*nAB*(nuA.x*nuA.x); kA[0][1] = eps*nAB*(nuA.x*nuA.y); kA[0][2] = eps*nAB*(nuA.x*nuA.z);
@@ -353,14 +365,15 @@ void FEMortarSlidingContact::ContactGapStiffness(FELinearSystem& LS)
 				kA[2][0] = eps*nAB*(nuA.z*nuA.x); kA[2][1] = eps*nAB*(nuA.z*nuA.y); kA[2][2] = eps*nAB*(nuA.z*nuA.z);
 
 				// loop over primary nodes
-				for (int C=0; C<NS; ++C)
+				for (size_t iC=0; iC<n1.size(); ++iC)
 				{
+					int C = n1[iC].col;
 					FENode& nodeC = m_ss.Node(C);
 					lmj[0] = nodeC.m_ID[0];
 					lmj[1] = nodeC.m_ID[1];
 					lmj[2] = nodeC.m_ID[2];
 
-					double nAC = m_n1[A][C];
+					double nAC = n1[iC].val;
 					if (nAC != 0.0)
 					{
 						kG[0][0] = nAC; kG[0][1] = 0.0; kG[0][2] = 0.0;
@@ -375,14 +388,15 @@ void FEMortarSlidingContact::ContactGapStiffness(FELinearSystem& LS)
 				}
 
 				// loop over secondary nodes
-				for (int C=0; C<NM; ++C)
+				for (size_t iC=0; iC<n2.size(); ++iC)
 				{
+					int C = n2[iC].col;
 					FENode& nodeC = m_ms.Node(C);
 					lmj[0] = nodeC.m_ID[0];
 					lmj[1] = nodeC.m_ID[1];
 					lmj[2] = nodeC.m_ID[2];
 
-					double nAC = -m_n2[A][C];
+					double nAC = -n2[iC].val;
 					if (nAC != 0.0)
 					{
 						kG[0][0] = nAC; kG[0][1] = 0.0; kG[0][2] = 0.0;
@@ -444,12 +458,17 @@ void FEMortarSlidingContact::ContactNormalStiffness(FELinearSystem& LS)
 			lm2[1] = nodej2.m_ID[1];
 			lm2[2] = nodej2.m_ID[2];
 
+			// the weights of the nodes that share a patch with A
+			const MortarWeights::ROW& n1 = m_n1.Row(A);
+			const MortarWeights::ROW& n2 = m_n2.Row(A);
+
 			// loop over primary nodes
-			for (int B=0; B<NS; ++B)
+			for (size_t iB=0; iB<n1.size(); ++iB)
 			{
+				int B = n1[iB].col;
 				FENode& nodeB = m_ss.Node(B);
 				
-				double nAB = m_n1[A][B];
+				double nAB = n1[iB].val;
 				if (nAB != 0.0)
 				{
 					vector<int> lmi(3);
@@ -476,11 +495,12 @@ void FEMortarSlidingContact::ContactNormalStiffness(FELinearSystem& LS)
 			}
 
 			// loop over secondary nodes
-			for (int B=0; B<NM; ++B)
+			for (size_t iB=0; iB<n2.size(); ++iB)
 			{
+				int B = n2[iB].col;
 				FENode& nodeB = m_ms.Node(B);
 				
-				double nAB = m_n2[A][B];
+				double nAB = n2[iB].val;
 				if (nAB != 0.0)
 				{
 					vector<int> lmi(3);
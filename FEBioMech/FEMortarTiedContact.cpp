@@ -148,15 +148,17 @@ void FEMortarTiedContact::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 		vector<int> en(1);
 		vector<int> lm(3);
 		vector<double> fe(3);
-		for (int B=0; B<NS; ++B)
+		const MortarWeights::ROW& n1 = m_n1.Row(A);
+		for (size_t i=0; i<n1.size(); ++i)
 		{
+			int B = n1[i].col;
 			FENode& nodeB = m_ss.Node(B);
 			en[0] = m_ss.NodeIndex(B);
 			lm[0] = nodeB.m_ID[m_dofX];
 			lm[1] = nodeB.m_ID[m_dofY];
 			lm[2] = nodeB.m_ID[m_dofZ];
 
-			double nAB = -m_n1[A][B];
+			double nAB = -n1[i].val;
 			if (nAB != 0.0)
 			{
 				fe[0] = tA.x*nAB;
@@ -168,15 +170,17 @@ void FEMortarTiedContact::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 		}
 
 		// loop over secondary side
-		for (int C=0; C<NM; ++C)
+		const MortarWeights::ROW& n2 = m_n2.Row(A);
+		for (size_t i=0; i<n2.size(); ++i)
 		{
+			int C = n2[i].col;
 			FENode& nodeC = m_ms.Node(C);
 			en[0] = m_ms.NodeIndex(C);
 			lm[0] = nodeC.m_ID[m_dofX];
 			lm[1] = nodeC.m_ID[m_dofY];
 			lm[2] = nodeC.m_ID[m_dofZ];
 
-			double nAC = m_n2[A][C];
+			double nAC = n2[i].val;
 			if (nAC != 0.0)
 			{
 				fe[0] = tA.x*nAC;
@@ -204,26 +208,32 @@ void FEMortarTiedContact::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo&
 	{
 		double eps = m_eps*m_ss.m_A[A];
 
+		// the weights of the nodes that share a patch with A
+		const MortarWeights::ROW& n1 = m_n1.Row(A);
+		const MortarWeights::ROW& n2 = m_n2.Row(A);
+
 		// loop over all primary nodes
-		for (int B=0; B<NS; ++B)
+		for (size_t iB=0; iB<n1.size(); ++iB)
 		{
+			int B = n1[iB].col;
 			FENode& nodeB = m_ss.Node(B);
 			lmi[0] = nodeB.m_ID[0];
 			lmi[1] = nodeB.m_ID[1];
 			lmi[2] = nodeB.m_ID[2];
 
-			double nAB = m_n1[A][B]*eps;
+			double nAB = n1[iB].val*eps;
 			if (nAB != 0.0)
 			{
 				// loop over primary nodes
-				for (int C=0; C<NS; ++C)
+				for (size_t iC=0; iC<n1.size(); ++iC)
 				{
+					int C = n1[iC].col;
 					FENode& nodeC = m_ss.Node(C);
 					lmj[0] = nodeC.m_ID[0];
 					lmj[1] = nodeC.m_ID[1];
 					lmj[2] = nodeC.m_ID[2];
 
-					double nAC = m_n1[A][C]*nAB;
+					double nAC = n1[iC].val*nAB;
 					if (nAC != 0.0)
 					{
 						ke[0][0] = nAC; ke[0][1] = 0.0; ke[0][2] = 0.0;
@@ -236,14 +246,15 @@ void FEMortarTiedContact::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo&
 				}
 
 				// loop over secondary nodes
-				for (int C=0; C<NM; ++C)
+				for (size_t iC=0; iC<n2.size(); ++iC)
 				{
+					int C = n2[iC].col;
 					FENode& nodeC = m_ms.Node(C);
 					lmj[0] = nodeC.m_ID[0];
 					lmj[1] = nodeC.m_ID[1];
 					lmj[2] = nodeC.m_ID[2];
 
-					double nAC = -m_n2[A][C]*nAB;
+					double nAC = -n2[iC].val*nAB;
 					if (nAC != 0.0)
 					{
 						ke[0][0] = nAC; ke[0][1] = 0.0; ke[0][2] = 0.0;
@@ -258,25 +269,27 @@ void FEMortarTiedContact::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo&
 		}
 
 		// loop over all secondary nodes
-		for (int B=0; B<NM; ++B)
+		for (size_t iB=0; iB<n2.size(); ++iB)
 		{
+			int B = n2[iB].col;
 			FENode& nodeB = m_ms.Node(B);
 			lmi[0] = nodeB.m_ID[0];
 			lmi[1] = nodeB.m_ID[1];
 			lmi[2] = nodeB.m_ID[2];
 
-			double nAB = -m_n2[A][B]*eps;
+			double nAB = -n2[iB].val*eps;
 			if (nAB != 0.0)
 			{
 				// loop over primary nodes
-				for (int C=0; C<NS; ++C)
+				for (size_t iC=0; iC<n1.size(); ++iC)
 				{
+					int C = n1[iC].col;
 					FENode& nodeC = m_ss.Node(C);
 					lmj[0] = nodeC.m_ID[0];
 					lmj[1] = nodeC.m_ID[1];
 					lmj[2] = nodeC.m_ID[2];
 
-					double nAC = m_n1[A][C]*nAB;
+					double nAC = n1[iC].val*nAB;
 					if (nAC != 0.0)
 					{
 						ke[0][0] = nAC; ke[0][1] = 0.0; ke[0][2] = 0.0;
@@ -289,14 +302,15 @@ void FEMortarTiedContact::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo&
 				}
 
 				// loop over secondary nodes
-				for (int C=0; C<NM; ++C)
+				for (size_t iC=0; iC<n2.size(); ++iC)
 				{
+					int C = n2[iC].col;
 					FENode& nodeC = m_ms.Node(C);
 					lmj[0] = nodeC.m_ID[0];
 					lmj[1] = nodeC.m_ID[1];
 					lmj[2] = nodeC.m_ID[2];
 
-					double nAC = -m_n2[A][C]*nAB;
+					double nAC = -n2[iC].val*nAB;
 					if (nAC != 0.0)
 					{
 						ke[0][0] = nAC; ke[0][1] = 0.0; ke[0][2] = 0.0;
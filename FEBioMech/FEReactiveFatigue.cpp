@@ -43,6 +43,8 @@ SOFTWARE.*/
 BEGIN_FECORE_CLASS(FEReactiveFatigue, FEElasticMaterial)
 	ADD_PARAMETER(m_k0   , FE_RANGE_GREATER_OR_EQUAL(0.0), "k0"  );
 	ADD_PARAMETER(m_beta , FE_RANGE_GREATER_OR_EQUAL(0.0), "beta");
+	ADD_PARAMETER(m_gen.m_ngmax, FE_RANGE_GREATER_OR_EQUAL(0), "max_generations");
+	ADD_PARAMETER(m_gen.m_gtol , FE_RANGE_GREATER_OR_EQUAL(0.0), "generation_tol");
 
 	// set material properties
 	ADD_PROPERTY(m_pBase, "elastic");
@@ -90,8 +90,8 @@ FEReactiveFatigueMaterialPoint::FEReactiveFatigueMaterialPoint(FEMaterialPoint *
     m_wft = rfmp.m_wft;
     
     m_fb.clear();
-    for (int ig=0; ig<m_fb.size(); ++ig)
-        m_fb.push_back(rfmp.m_fb[ig]);
+    
+    m_pgen = nullptr;
 }
 
 //-----------------------------------------------------------------------------
@@ -112,9 +112,9 @@ FEReactiveFatigueMaterialPoint::FEReactiveFatigueMaterialPoint(const FEReactiveF
     m_wbp = rfmp.m_wbp;
     m_wft = rfmp.m_wft;
     
-    m_fb.clear();
-    for (int ig=0; ig<m_fb.size(); ++ig)
-        m_fb.push_back(rfmp.m_fb[ig]);
+    m_fb = rfmp.m_fb;
+    
+    m_pgen = rfmp.m_pgen;
 }
 
 FEReactiveFatigueMaterialPoint::FEReactiveFatigueMaterialPoint(FEReactiveFatigueMaterialPoint& rfmp)
@@ -133,9 +133,9 @@ FEReactiveFatigueMaterialPoint::FEReactiveFatigueMaterialPoint(FEReactiveFatigue
     m_wbp = rfmp.m_wbp;
     m_wft = rfmp.m_wft;
     
-    m_fb.clear();
-    for (int ig=0; ig<m_fb.size(); ++ig)
-        m_fb.push_back(rfmp.m_fb[ig]);
+    m_fb = rfmp.m_fb;
+    
+    m_pgen = rfmp.m_pgen;
 }
 
 //-----------------------------------------------------------------------------
@@ -184,11 +184,11 @@ void FEReactiveFatigueMaterialPoint::Update(const FETimeInfo& timeInfo)
         }
     }
     // cull generations that have been marked for erasure
-    std::deque<FatigueBond>::iterator it = m_fb.begin();
-    while (it != m_fb.end()) {
-        if (it->m_erase) it = m_fb.erase(it);
-        else ++it;
+    int nfb = 0;
+    for (int ig=0; ig < m_fb.size(); ++ig) {
+        if (m_fb[ig].m_erase == false) m_fb[nfb++] = m_fb[ig];
     }
+    m_fb.resize(nfb);
     
     // update intact and damage bonds
     m_wip = m_wit;
@@ -202,6 +202,9 @@ void FEReactiveFatigueMaterialPoint::Update(const FETimeInfo& timeInfo)
     
     // update damage response for fatigues bonds
     for (int ig=0; ig<m_fb.size(); ++ig) m_fb[ig].Update();
+    
+    // limit the number of generations
+    CompactGenerations();
 
     // evaluate total fatigue bond fraction
     m_wft = 0;
@@ -245,3 +248,47 @@ void FEReactiveFatigueMaterialPoint::Serialize(DumpStream& ar)
         }
     }
 }
+
+//-----------------------------------------------------------------------------
+// Merge adjacent generations of fatigued bonds once their number exceeds the 
+// maximum number of generations of the parent material.
+// Generations with (nearly) equal damage criteria evolve identically, so pairs whose
+// criteria differ by less than the tolerance are merged first, then the closest pairs
+// are merged until the limit is met. The newest generation is never merged.
+void FEReactiveFatigueMaterialPoint::CompactGenerations()
+{
+    if (m_pgen == nullptr) return;
+    const int ngmax = m_pgen->m_ngmax;
+    const double gtol = m_pgen->m_gtol;
+    
+    int ng = m_fb.size();
+    if ((ngmax <= 0) || (ng <= ngmax)) return;
+    
+    while (ng > 2) {
+        // find the adjacent generations with the closest damage criterion
+        int imin = 0;
+        double dmin = fabs(m_fb[1].m_Xfmax - m_fb[0].m_Xfmax);
+        for (int ig=1; ig<ng-2; ++ig) {
+            double d = fabs(m_fb[ig+1].m_Xfmax - m_fb[ig].m_Xfmax);
+            if (d < dmin) { dmin = d; imin = ig; }
+        }
+        
+        if ((dmin > gtol) && (ng <= ngmax)) break;
+        
+        // merge generation imin into imin+1, weighing by bond fractions
+        FatigueBond& f0 = m_fb[imin];
+        FatigueBond& f1 = m_fb[imin+1];
+        double w0 = f0.m_wfp, w1 = f1.m_wfp;
+        if (w0 + w1 <= 0) w0 = w1 = 1;
+        double w = w0 + w1;
+        f1.m_Xfmax = (w0*f0.m_Xfmax + w1*f1.m_Xfmax)/w;
+        f1.m_Xftrl = (w0*f0.m_Xftrl + w1*f1.m_Xftrl)/w;
+        f1.m_Fft = (w0*f0.m_Fft + w1*f1.m_Fft)/w;
+        f1.m_Ffp = (w0*f0.m_Ffp + w1*f1.m_Ffp)/w;
+        f1.m_time = (w0*f0.m_time + w1*f1.m_time)/w;
+        f1.m_wft += f0.m_wft;
+        f1.m_wfp += f0.m_wfp;
+        m_fb.erase(imin);
+        ng--;
+    }
+}
@@ -27,8 +27,8 @@
 
 
 #pragma once
-#include <deque>
 #include <FECore/FEMaterialPoint.h>
+#include <FECore/ring_buffer.h>
 
 //-----------------------------------------------------------------------------
 // structure for fatigue bonds
@@ -55,6 +55,19 @@ public:
     bool    m_erase;    //!< flag for erasing a generation
 };
 
+//-----------------------------------------------------------------------------
+// parameters that limit the number of fatigue bond generations
+// (owned by the fatigue material, so they are not stored at each material point)
+class FatigueGenerationLimits
+{
+public:
+    FatigueGenerationLimits() : m_ngmax(0), m_gtol(0) {}
+    
+public:
+    int     m_ngmax;    //!< maximum number of fatigue generations (0 = no limit)
+    double  m_gtol;     //!< damage criterion tolerance for merging generations
+};
+
 //-----------------------------------------------------------------------------
 // Define a material point that stores the fatigue and damage variables.
 class FEReactiveFatigueMaterialPoint : public FEMaterialPoint
@@ -73,6 +86,9 @@ public:
     
     void Serialize(DumpStream& ar);
     
+    // merge generations when the maximum number of generations is exceeded
+    void CompactGenerations();
+    
 public:
     double      m_D;            //!< damage (0 = no damage, 1 = complete damage)
     
@@ -95,6 +111,8 @@ public:
     double      m_wft;          //!< fatigue bond fraction at current time
     
     
-    deque <FatigueBond> m_fb;   //!< generations of fatigued bonds
+    ring_buffer<FatigueBond> m_fb;  //!< generations of fatigued bonds
+    
+    const FatigueGenerationLimits*  m_pgen;  //!< generation limits of the parent material (can be null)
 };
 
@@ -78,14 +78,10 @@ FEMaterialPoint* FEReactiveVEMaterialPoint::Copy()
 void FEReactiveVEMaterialPoint::Init()
 {
 	// initialize data to zero
-	m_Uv.clear();
-	m_Jv.clear();
-	m_v.clear();
-	m_f.clear();
+	m_gen.clear();
     
     m_Et = 0;
     m_Em = 0;
-    m_wv.clear();
     
     // don't forget to initialize the base class
     FEMaterialPoint::Init();
@@ -106,18 +102,45 @@ void FEReactiveVEMaterialPoint::Serialize(DumpStream& ar)
     
     if (ar.IsSaving())
     {
-        int n = (int)m_Uv.size();
+        int n = m_gen.size();
         ar << n;
-        for (int i=0; i<n; ++i) ar << m_Uv[i] << m_Jv[i] << m_v[i] << m_f[i];
+        for (int i=0; i<n; ++i)
+        {
+            BondGeneration& g = m_gen[i];
+            ar << g.m_Uv << g.m_Jv << g.m_v << g.m_f << g.m_wv;
+        }
     }
     else
     {
         int n;
         ar >> n;
-		m_Uv.resize(n);
-		m_Jv.resize(n);
-		m_v.resize(n);
-		m_f.resize(n);
-        for (int i=0; i<n; ++i) ar >> m_Uv[i] >> m_Jv[i] >> m_v[i] >> m_f[i];
+        m_gen.resize(n);
+        for (int i=0; i<n; ++i)
+        {
+            BondGeneration& g = m_gen[i];
+            ar >> g.m_Uv >> g.m_Jv >> g.m_v >> g.m_f >> g.m_wv;
+        }
     }
 }
+
+//-----------------------------------------------------------------------------
+//! Merge generation ig into generation ig+1. The generation data are averaged
+//! using the breaking bond mass fractions w0 and w1 of the two generations.
+void FEReactiveVEMaterialPoint::MergeGenerations(int ig, double w0, double w1)
+{
+    assert((ig >= 0) && (ig < m_gen.size() - 1));
+    BondGeneration& g0 = m_gen[ig];
+    BondGeneration& g1 = m_gen[ig+1];
+    
+    // use equal weights if both generations have fully relaxed
+    if (w0 + w1 <= 0) w0 = w1 = 1;
+    double w = w0 + w1;
+    
+    g1.m_v = (w0*g0.m_v + w1*g1.m_v)/w;
+    g1.m_Uv = (g0.m_Uv*w0 + g1.m_Uv*w1)/w;
+    g1.m_Jv = g1.m_Uv.det();
+    g1.m_f = (w0*g0.m_f + w1*g1.m_f)/w;
+    g1.m_wv = (w0*g0.m_wv + w1*g1.m_wv)/w;
+    
+    m_gen.erase(ig);
+}
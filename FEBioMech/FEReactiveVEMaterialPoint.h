@@ -30,7 +30,7 @@ SOFTWARE.*/
 #include "FECore/FEMaterialPoint.h"
 #include "FEReactiveViscoelastic.h"
 #include "FEUncoupledReactiveViscoelastic.h"
-#include <deque>
+#include <FECore/ring_buffer.h>
 
 class FEReactiveViscoelasticMaterial;
 class FEUncoupledReactiveViscoelasticMaterial;
@@ -54,6 +54,21 @@ public:
     void Serialize(DumpStream& ar);
 };
 
+//-----------------------------------------------------------------------------
+//! Data for one generation of reactive bonds
+class BondGeneration
+{
+public:
+    BondGeneration() : m_Uv(mat3dd(1)), m_Jv(1), m_v(0), m_f(0), m_wv(1) {}
+    
+public:
+    mat3ds m_Uv;    //!< right stretch tensor at tv (when generation u starts breaking)
+    double m_Jv;    //!< determinant of Uv (store for efficiency)
+    double m_v;     //!< time tv when generation starts breaking
+    double m_f;     //!< mass fraction when generation starts breaking
+    double m_wv;    //!< total mass fraction of weak bonds
+};
+
 //-----------------------------------------------------------------------------
 //! Material point data for reactive viscoelastic materials
 class FEReactiveVEMaterialPoint : public FEMaterialPoint
@@ -74,16 +89,15 @@ public:
     //! Serialize data to archive
     void Serialize(DumpStream& ar) override;
     
+    //! merge generation ig into generation ig+1, using the weights w0 and w1
+    void MergeGenerations(int ig, double w0, double w1);
+    
 public:
-    // multigenerational material data
-    deque <mat3ds> m_Uv;	//!< right stretch tensor at tv (when generation u starts breaking)
-    deque <double> m_Jv;	//!< determinant of Uv (store for efficiency)
-    deque <double> m_v;     //!< time tv when generation starts breaking
-    deque <double> m_f;     //!< mass fraction when generation starts breaking
+    // multigenerational material data, oldest generation first
+    ring_buffer<BondGeneration> m_gen;
     
 public:
     // weak bond recruitment parameters
     double m_Et;            //!< trial strain value at time t
     double m_Em;            //!< max strain value up to time t
-    deque <double> m_wv;    //!< total mass fraction of weak bonds
 };
@@ -77,6 +77,9 @@ public:
     //! cull generations
     void CullGenerations(FEMaterialPoint& pt);
     
+    //! merge generations when the maximum number of generations is exceeded
+    void CompactGenerations(FEMaterialPoint& pt);
+    
     //! evaluate bond mass fraction for a given generation
     double BreakingBondMassFraction(FEMaterialPoint& pt, const int ig, const mat3ds D);
     
@@ -120,6 +123,8 @@ public:
     int     m_btype;    //!< bond kinetics type
     int     m_ttype;    //!< bond breaking trigger type
     double  m_emin;     //!< strain threshold for triggering new generation
+    int     m_ngmax;    //!< maximum number of generations (0 = no limit)
+    double  m_gtol;     //!< relaxation tolerance for merging generations
     
     int     m_nmax;     //!< highest number of generations achieved in analysis
     
@@ -31,6 +31,7 @@ SOFTWARE.*/
 #include <FECore/FELinearConstraintManager.h>
 #include <FECore/FEAnalysis.h>
 #include "FESolidSolver2.h"
+#include <FECore/sys.h>
 using namespace std;
 
 //-----------------------------------------------------------------------------
@@ -43,11 +44,54 @@ FEResidualVector::~FEResidualVector()
 {
 }
 
+//-----------------------------------------------------------------------------
+void FEResidualVector::UseThreadBuffers(FEGlobalVectorBuffers* buf)
+{
+	FEGlobalVector::UseThreadBuffers(buf);
+
+	// the rigid body reaction forces are reduced separately
+	m_RBF.clear();
+	m_RBM.clear();
+	FEMechModel* fem = dynamic_cast<FEMechModel*>(&m_fem);
+	if ((m_buf == nullptr) || (fem == nullptr)) return;
+
+	int nt = m_buf->Threads();
+	int NRB = fem->RigidBodies();
+	m_RBF.assign(nt, vector<vec3d>(NRB, vec3d(0, 0, 0)));
+	m_RBM.assign(nt, vector<vec3d>(NRB, vec3d(0, 0, 0)));
+}
+
+//-----------------------------------------------------------------------------
+void FEResidualVector::Reduce()
+{
+	FEGlobalVector::Reduce();
+
+	FEMechModel* fem = dynamic_cast<FEMechModel*>(&m_fem);
+	if (m_RBF.empty() || (fem == nullptr)) return;
+
+	int nt = (int)m_RBF.size();
+	int NRB = fem->RigidBodies();
+	for (int i = 0; i < NRB; ++i)
+	{
+		FERigidBody& RB = *fem->GetRigidBody(i);
+		for (int t = 0; t < nt; ++t)
+		{
+			RB.m_Fr += m_RBF[t][i]; m_RBF[t][i] = vec3d(0, 0, 0);
+			RB.m_Mr += m_RBM[t][i]; m_RBM[t][i] = vec3d(0, 0, 0);
+		}
+	}
+}
+
 //-----------------------------------------------------------------------------
 void FEResidualVector::Assemble(vector<int>& en, vector<int>& elm, vector<double>& fe, bool bdom)
 {
-    
-    vector<double>& R = m_R;
+	// with thread buffers, the base class takes care of the element vector
+	// and we assemble the constraint and rigid contributions into the thread's buffers
+	bool bbuf = (m_buf != nullptr);
+	if (bbuf) FEGlobalVector::Assemble(en, elm, fe, bdom);
+	int thread = (bbuf ? omp_get_thread_num() : 0);
+
+	vector<double>& R = ThreadResidual();
     
     int i, I, n;
     
@@ -56,7 +100,7 @@ void FEResidualVector::Assemble(vector<int>& en, vector<int>& elm, vector<double
     {
         // assemble the element residual into the global residual
         int ndof = (int)fe.size();
-        for (i=0; i<ndof; ++i)
+        for (i=0; (i<ndof) && !bbuf; ++i)
         {
             
             I = elm[i];
@@ -125,6 +169,15 @@ void FEResidualVector::Assemble(vector<int>& en, vector<int>& elm, vector<double
 								}
 							}
 
+							if (bbuf)
+							{
+								for (int k = 0; k < 3; ++k) if (lm[k] >= 0) R[lm[k]] += f(k);
+								for (int k = 0; k < 3; ++k) if (lm[k + 3] >= 0) R[lm[k + 3]] += m(k);
+								m_RBF[thread][node.m_rid] -= f;
+								m_RBM[thread][node.m_rid] -= m;
+								continue;
+							}
+
 							n = lm[3];
 							if (n >= 0)
 							{
@@ -208,15 +261,18 @@ void FEResidualVector::Assemble(int node_id, int dof, double f)
 
 	// assemble into global vector
 	if (n >= 0) {
+		if (m_buf) m_buf->m_R[omp_get_thread_num()][n] += f;
+		else {
 #pragma omp atomic
-		m_R[n] += f;
+			m_R[n] += f;
+		}
 	}
 	else {
 		FESolidSolver2* solver = dynamic_cast<FESolidSolver2*>(m_fem.GetCurrentStep()->GetFESolver());
 		if (solver)
 		{
 			FERigidSolver* rigidSolver = solver->GetRigidSolver();
-			rigidSolver->AssembleResidual(node_id, dof, f, m_R);
+			rigidSolver->AssembleResidual(node_id, dof, f, ThreadResidual());
 		}
 	}
 }
@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #pragma once
 #include <FECore/FEGlobalVector.h>
+#include <FECore/vec3d.h>
 #include <vector>
 #include "febiomech_api.h"
 
@@ -51,4 +52,14 @@ public:
 
 	//! Assemble into this global vector
 	void Assemble(int node, int dof, double f) override;
+
+	//! Use per-thread buffers instead of atomic updates when assembling
+	void UseThreadBuffers(FEGlobalVectorBuffers* buf) override;
+
+	//! add the per-thread buffers to the global vector and the rigid body reaction forces
+	void Reduce() override;
+
+private:
+	std::vector< std::vector<vec3d> >	m_RBF;	//!< per-thread rigid body reaction forces
+	std::vector< std::vector<vec3d> >	m_RBM;	//!< per-thread rigid body reaction moments
 };
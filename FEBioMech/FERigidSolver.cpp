@@ -93,6 +93,7 @@ int FERigidSolver::InitEquations(int neq)
 	// we assign the rigid body equation number to
 	// Also make sure that the nodes are NOT constrained!
 	FEMesh& mesh = m_fem->GetMesh();
+	mesh.EquationsChanged();
 	for (int i = 0; i<mesh.Nodes(); ++i)
 	{
 		FENode& node = mesh.Node(i);
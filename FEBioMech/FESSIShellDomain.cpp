@@ -952,8 +952,10 @@ void FESSIShellDomain::Update(const FETimeInfo& tp)
 {
 	int NS = Elements();
 	FEMesh& mesh = *GetMesh();
-	ForEachShellElement([=, &mesh](FEShellElement& e) {
-
+	#pragma omp parallel for shared(NS)
+	for (int i = 0; i < NS; ++i)
+	{
+		FEShellElement& e = Element(i);
 		int n = e.Nodes();
 		for (int j = 0; j<n; ++j)
 		{
@@ -963,7 +965,7 @@ void FESSIShellDomain::Update(const FETimeInfo& tp)
 
 			e.m_ht[j] = h;
 		}
-	});
+	}
 }
 
 //=================================================================================================
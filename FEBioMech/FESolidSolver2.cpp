@@ -49,7 +49,10 @@ SOFTWARE.*/
 #include <FECore/FELinearConstraintManager.h>
 #include <FECore/vector.h>
 #include "FESolidLinearSystem.h"
+#include "FEElasticMatrixFree.h"
 #include "FEBioMech.h"
+#include <FECore/LinearSolver.h>
+#include <typeinfo>
 
 //-----------------------------------------------------------------------------
 // define the parameter list
@@ -62,6 +65,9 @@ BEGIN_FECORE_CLASS(FESolidSolver2, FENewtonSolver)
 	ADD_PARAMETER(m_logSolve     , "logSolve"    );
 	ADD_PARAMETER(m_arcLength    , "arc_length"  );
 	ADD_PARAMETER(m_al_scale     , "arc_length_scale");
+	ADD_PARAMETER(m_matrixFree   , "matrix_free" );
+	ADD_PARAMETER(m_mfCacheTangents, "matrix_free_cache_tangents");
+	ADD_PARAMETER(m_residualBuffers, "residual_thread_buffers");
 END_FECORE_CLASS();
 
 //-----------------------------------------------------------------------------
@@ -82,6 +88,12 @@ m_dofU(pfem), m_dofV(pfem), m_dofSQ(pfem), m_dofRQ(pfem), m_dofSU(pfem), m_dofSV
 
 	m_logSolve = false;
 
+	m_matrixFree = false;
+	m_mfCacheTangents = true;
+	m_pMF = nullptr;
+
+	m_residualBuffers = false;
+
 	// default Newmark parameters (trapezoidal rule)
     m_rhoi = -2;
     m_alpha = m_alphaf = 1.0;
@@ -195,6 +207,35 @@ bool FESolidSolver2::Init()
 
 	FEModel& fem = *GetFEModel();
 
+	// replace the stiffness matrix with the matrix-free version
+	if (m_matrixFree)
+	{
+		IterativeLinearSolver* ls = dynamic_cast<IterativeLinearSolver*>(m_plinsolve);
+		if (ls == nullptr)
+		{
+			feLogError("The matrix_free option requires an iterative linear solver.");
+			return false;
+		}
+
+		// If the linear system of the previous solve is reused, m_pK still holds
+		// the matrix-free stiffness, so we only need to allocate a new one otherwise.
+		m_pMF = dynamic_cast<FEElasticMatrixFree*>(m_pK->GetSparseMatrixPtr());
+		if (m_pMF == nullptr)
+		{
+			m_pMF = new FEElasticMatrixFree(&fem);
+			delete m_pK;
+			m_pK = new FEGlobalMatrix(m_pMF);
+
+			// the new matrix still needs to be created, even if the base class
+			// decided to reuse the profile of the previous solve.
+			m_breshape = true;
+		}
+		m_pMF->SetCacheTangents(m_mfCacheTangents);
+		ls->SetSparseMatrix(m_pMF);
+		if (ls->GetLeftPreconditioner()) ls->GetLeftPreconditioner()->SetSparseMatrix(m_pMF);
+		if (ls->GetRightPreconditioner()) ls->GetRightPreconditioner()->SetSparseMatrix(m_pMF);
+	}
+
     if (m_rhoi == -1) {
         // Euler integration
         m_alpha = m_alphaf = m_alpham = 1.0;
@@ -772,6 +813,9 @@ bool FESolidSolver2::Quasin()
 	// Initialize the QN-method
 	if (QNInit() == false) return false;
 
+	// the (line search scaled) displacement increment
+	vector<double> ui(m_ui.size());
+
 	// loop until converged or when max nr of reformations reached
 	bool bconv = false;		// convergence flag
 	do
@@ -801,18 +845,15 @@ bool FESolidSolver2::Quasin()
 
 		// calculate actual displacement increment
 		// NOTE: We don't apply the line search directly to m_ui since we need the unscaled search direction for the QN update below
-		int neq = (int)m_Ui.size();
-		vector<double> ui(m_ui);
-		for (int i = 0; i<neq; ++i) ui[i] *= s;
+		vcopys(ui, m_ui, s);
 
 		// update total displacements
 		UpdateIncrements(m_Ui, ui, false);
 
 		// calculate norms
-		normR1 = m_R1*m_R1;
-		normu  = ui*ui;
+		vdot3(ui, m_R1, normu, normE1, normR1);
 		normU  = m_Ui*m_Ui;
-		normE1 = fabs(ui*m_R1);
+		normE1 = fabs(normE1);
 
 		// check for nans
 		if (ISNAN(normR1) || ISNAN(normu)) throw NANDetected();
@@ -991,8 +1032,10 @@ void FESolidSolver2::DoArcLength()
 			// setup quadratic equation
 			double Fe_norm2 = m_Fext*m_Fext;
 			double a = uF*uF + (psi*psi)*Fe_norm2;
-			double b = 2.0*(uF*(m_Ui + m_ui)) + 2 * m_al_inc*(psi*psi)*Fe_norm2;
-			double c = m_ui*(m_Ui*2.0 + m_ui) + m_Ui*m_Ui - m_al_ds*m_al_ds + (psi*psi)*(m_al_inc*m_al_inc)*Fe_norm2;
+			double UU, Uu, uu;
+			vdot3(m_Ui, m_ui, UU, Uu, uu);
+			double b = 2.0*(uF*m_Ui + uF*m_ui) + 2 * m_al_inc*(psi*psi)*Fe_norm2;
+			double c = 2.0*Uu + uu + UU - m_al_ds*m_al_ds + (psi*psi)*(m_al_inc*m_al_inc)*Fe_norm2;
 
 			// solve quadratic equation
 			double g[2];
@@ -1049,11 +1092,13 @@ void FESolidSolver2::DoArcLength()
 
 		m_al_inc += m_al_gamma;
 		m_al_lam += m_al_gamma;
-		m_ui = m_ui + uF*m_al_gamma;
+		vadds(m_ui, uF, m_al_gamma);
 	}
 
 	// evaluate the arc-length equation. 
-	double sk2 = (m_Ui + m_ui)*(m_Ui + m_ui) + (psi*psi)*m_al_inc*m_al_inc*(m_Fext*m_Fext);
+	double UU, Uu, uu;
+	vdot3(m_Ui, m_ui, UU, Uu, uu);
+	double sk2 = UU + 2.0*Uu + uu + (psi*psi)*m_al_inc*m_al_inc*(m_Fext*m_Fext);
 	double sk = sqrt(sk2);
 	double serr = fabs((sk - m_al_ds) / m_al_ds);
 	feLog("\tarc-length increment : %lg (%lg)\n", m_al_inc, m_al_gamma);
@@ -1076,11 +1121,22 @@ bool FESolidSolver2::StiffnessMatrix()
 	// setup the linear system
 	FESolidLinearSystem LS(this, &m_rigidSolver, *m_pK, m_Fd, m_ui, (m_msymm == REAL_SYMMETRIC), m_alpha, m_nreq);
 
+	// The matrix-free operator cannot deal with linear constraints
+	bool bmatrixFree = (m_pMF && (fem.GetLinearConstraintManager().LinearConstraints() == 0));
+
 	// calculate the stiffness matrix for each domain
 	for (int i=0; i<mesh.Domains(); ++i) 
 	{
 		if (mesh.Domain(i).IsActive()) 
 		{
+			// see if the matrix-free operator can handle this domain
+			// (derived domain classes have their own stiffness so we need an exact type match)
+			if (bmatrixFree && (typeid(mesh.Domain(i)) == typeid(FEElasticSolidDomain)))
+			{
+				FEElasticSolidDomain& dom = static_cast<FEElasticSolidDomain&>(mesh.Domain(i));
+				if (m_pMF->AddDomain(dom, m_Fd, m_ui, m_nreq)) continue;
+			}
+
 			FEElasticDomain& dom = dynamic_cast<FEElasticDomain&>(mesh.Domain(i));
 			dom.StiffnessMatrix(LS);
 		}
@@ -1208,12 +1264,14 @@ bool FESolidSolver2::Residual(vector<double>& R)
 	// setup the global vector
 	zero(R);
 	FEResidualVector RHS(fem, R, m_Fr);
+	RHS.UseThreadBuffers(m_residualBuffers ? &m_residualBuf : nullptr);
 
 	// zero rigid body reaction forces
 	m_rigidSolver.Residual();
 
 	// calculate the internal (stress) forces
 	InternalForces(RHS);
+	RHS.Reduce();
 
 	// extract the internal forces
 	// (only when we really need it, below)
@@ -1232,6 +1290,7 @@ bool FESolidSolver2::Residual(vector<double>& R)
 
 	// calculate external forces
 	ExternalForces(RHS);
+	RHS.Reduce();
 
 	// For arc-length we need the external loads
 	if (m_arcLength > 0)
@@ -1369,6 +1428,10 @@ void FESolidSolver2::ExternalForces(FEGlobalVector& RHS)
 		}
 	}
 
+	// the reaction forces must include the external forces that were 
+	// assembled into the thread buffers, so add those first.
+	RHS.Reduce();
+
 	// set the nodal reaction forces
 	// TODO: Is this a good place to do this?
 	for (int i = 0; i<mesh.Nodes(); ++i)
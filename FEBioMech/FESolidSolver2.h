@@ -34,6 +34,8 @@ SOFTWARE.*/
 #include "FERigidSolver.h"
 #include <FECore/FEDofList.h>
 
+class FEElasticMatrixFree;
+
 //-----------------------------------------------------------------------------
 //! The FESolidSolver2 class solves large deformation solid mechanics problems
 //! It can deal with quasi-static and dynamic problems
@@ -142,6 +144,13 @@ public:
 	// equation numbers
 	int		m_nreq;			//!< start of rigid body equations
 
+	// matrix-free solution
+	bool	m_matrixFree;	//!< evaluate elastic domain stiffness matrix-free (requires iterative solver)
+	bool	m_mfCacheTangents;	//!< cache material tangents for matrix-free evaluation
+
+	bool	m_residualBuffers;	//!< assemble the residual into per-thread buffers instead of using atomics
+	FEGlobalVectorBuffers	m_residualBuf;	//!< the per-thread residual buffers (kept between residual evaluations)
+
 public:
 	vector<double> m_Fn;	//!< concentrated nodal force vector
 	vector<double> m_Fr;	//!< nodal reaction forces
@@ -174,6 +183,8 @@ protected:
 protected:
     FERigidSolverNew	m_rigidSolver;
 
+	FEElasticMatrixFree*	m_pMF;	//!< matrix-free stiffness (owned by m_pK)
+
 	// declare the parameter list
 	DECLARE_FECORE_CLASS();
 };
@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #include "stdafx.h"
 #include "FEUDGHexDomain.h"
+#include <FECore/log.h>
 #include "FEElasticMaterial.h"
 #include <FECore/FEModel.h>
 #include <FECore/FELinearSystem.h>
@@ -498,55 +499,68 @@ void FEUDGHexDomain::UDGMaterialStiffness(FESolidElement &el, matrix &ke)
 //-----------------------------------------------------------------------------
 void FEUDGHexDomain::Update(const FETimeInfo& tp)
 {
-	int nint, neln;
-	double* gw;
-	vec3d r0[8], rt[8];
-
-	for (int i=0; i<(int) m_Elem.size(); ++i)
+	bool berr = false;
+	int NE = (int) m_Elem.size();
+	#pragma omp parallel for shared(NE, berr)
+	for (int i=0; i<NE; ++i)
 	{
-		// get the solid element
-		FESolidElement& el = m_Elem[i];
+		try
+		{
+			vec3d r0[8], rt[8];
 
-		// get the number of integration points
-		nint = el.GaussPoints();
+			// get the solid element
+			FESolidElement& el = m_Elem[i];
 
-		// number of nodes
-		neln = el.Nodes();
+			// number of nodes
+			int neln = el.Nodes();
 
-		// nodal coordinates
-		for (int j=0; j<neln; ++j)
-		{
-			r0[j] = m_pMesh->Node(el.m_node[j]).m_r0;
-			rt[j] = m_pMesh->Node(el.m_node[j]).m_rt;
-		}
+			// nodal coordinates
+			for (int j=0; j<neln; ++j)
+			{
+				r0[j] = m_pMesh->Node(el.m_node[j]).m_r0;
+				rt[j] = m_pMesh->Node(el.m_node[j]).m_rt;
+			}
 
-		// get the integration weights
-		gw = el.GaussWeights();
+			// for the enhanced strain hex we need a slightly different procedure
+			// for calculating the element's stress. For this element, the stress
+			// is evaluated using an average deformation gradient.
 
-		// for the enhanced strain hex we need a slightly different procedure
-		// for calculating the element's stress. For this element, the stress
-		// is evaluated using an average deformation gradient.
+			// get the material point data
+			FEMaterialPoint& mp = *el.GetMaterialPoint(0);
+			FEElasticMaterialPoint& pt = *(mp.ExtractData<FEElasticMaterialPoint>());
 
-		// get the material point data
-		FEMaterialPoint& mp = *el.GetMaterialPoint(0);
-		FEElasticMaterialPoint& pt = *(mp.ExtractData<FEElasticMaterialPoint>());
+			// material point coordinates
+			// TODO: I'm not entirly happy with this solution
+			//		 since the material point coordinates are used by most materials.
+			pt.m_r0 = el.Evaluate(r0, 0);
+			pt.m_rt = el.Evaluate(rt, 0);
 
-		// material point coordinates
-		// TODO: I'm not entirly happy with this solution
-		//		 since the material point coordinates are used by most materials.
-		pt.m_r0 = el.Evaluate(r0, 0);
-		pt.m_rt = el.Evaluate(rt, 0);
+			// get the average cartesian derivatives
+			double GX[8], GY[8], GZ[8];
+			AvgCartDerivs(el, GX, GY, GZ);
 
-		// get the average cartesian derivatives
-		double GX[8], GY[8], GZ[8];
-		AvgCartDerivs(el, GX, GY, GZ);
+			// get the average deformation gradient and determinant
+			AvgDefGrad(el, pt.m_F, GX, GY, GZ);
+			pt.m_J = pt.m_F.det();
 
-		// get the average deformation gradient and determinant
-		AvgDefGrad(el, pt.m_F, GX, GY, GZ);
-		pt.m_J = pt.m_F.det();
+			// calculate the stress at this material point
+			pt.m_s = m_pMat->Stress(mp);
+		}
+		catch (NegativeJacobian e)
+		{
+			#pragma omp critical
+			{
+				berr = true;
+				if (e.DoOutput()) feLogError(e.what());
+			}
+		}
+	}
 
-		// calculate the stress at this material point
-		pt.m_s = m_pMat->Stress(mp);
+	// if we encountered an error, we request a running restart
+	if (berr)
+	{
+		if (NegativeJacobian::DoOutput() == false) feLogError("Negative jacobian was detected.");
+		throw DoRunningRestart();
 	}
 }
 
@@ -31,6 +31,8 @@ SOFTWARE.*/
 #include "FECore/FEMesh.h"
 #include "FECore/FEModel.h"
 #include "FECore/FEGlobalMatrix.h"
+#include <FECore/sys.h>
+#include <FECore/log.h>
 
 //-----------------------------------------------------------------------------
 // This function converts the Cauchy stress to a 2nd-PK stress
@@ -167,7 +169,9 @@ FEUT4Domain::FEUT4Domain(FEModel* pfem) : FEElasticSolidDomain(pfem)
 
 	m_Be = 0;
 	m_DB = 0;
+	m_nbuf = 0;
 	m_Ge = 0;
+	m_nthreads = 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -184,13 +188,8 @@ void FEUT4Domain::Serialize(DumpStream& ar)
 		// create the node-element list
 		m_NEL.Create(*this);
 		
-		// find the largest valence
-		int Nmax = m_NEL.MaxValence();
-
 		// allocate buffers
-		m_Ge = new double[Nmax*4][4][3];
-		m_Be = new double[Nmax*4][6][3];
-		m_DB = new double[Nmax*4][6][3];
+		AllocBuffers();
 	}
 }
 
@@ -305,15 +304,33 @@ bool FEUT4Domain::Init()
 	// create the node-element list
 	m_NEL.Create(*this);
 
+	// allocate buffers
+	AllocBuffers();
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//! Allocate the work buffers for the nodal stiffness. Each thread gets its own
+//! set of buffers, so the nodal stiffness can be evaluated in parallel.
+void FEUT4Domain::AllocBuffers()
+{
+	if (m_DB) delete [] m_DB;
+	if (m_Be) delete [] m_Be;
+	if (m_Ge) delete [] m_Ge;
+
 	// find the largest valence
 	int Nmax = m_NEL.MaxValence();
+	m_nbuf = Nmax*4;
 
 	// allocate buffers
-	m_Ge = new double[Nmax*4][4][3];
-	m_Be = new double[Nmax*4][6][3];
-	m_DB = new double[Nmax*4][6][3];
-
-	return true;
+	// NOTE: The number of threads can change after initialization, so
+	// NodalStiffnessMatrix checks this again before it uses the buffers.
+	int nt = omp_get_max_threads();
+	m_nthreads = nt;
+	m_Ge = new double[nt*m_nbuf][4][3];
+	m_Be = new double[nt*m_nbuf][6][3];
+	m_DB = new double[nt*m_nbuf][6][3];
 }
 
 //-----------------------------------------------------------------------------
@@ -325,56 +342,87 @@ void FEUT4Domain::Update(const FETimeInfo& tp)
 	FEElasticSolidDomain::Update(tp);
 
 	// next we update the nodal data
-	int i, j, NE = Elements();
-	for (i=0; i<(int) m_NODE.size(); ++i) { m_NODE[i].vi = 0; m_NODE[i].Fi.zero(); }
-	double Ve, ve;
-	mat3d Fe;
-	vec3d rt[4];
-	for (i=0; i<NE; ++i)
+	int NE = Elements();
+	int NN = (int) m_NODE.size();
+	for (int i=0; i<NN; ++i) { m_NODE[i].vi = 0; m_NODE[i].Fi.zero(); }
+
+	// evaluate the element volumes and deformation gradients
+	vector<double> ve(NE);
+	vector<mat3d> Fe(NE);
+	bool berr = false;
+	#pragma omp parallel for shared(NE, berr)
+	for (int i=0; i<NE; ++i)
 	{
-		FESolidElement& el = m_Elem[i];
+		try
+		{
+			FESolidElement& el = m_Elem[i];
 
-		// nodal coordinates
-		for (j=0; j<4; ++j) rt[j] = m_pMesh->Node(el.m_node[j]).m_rt;
+			// nodal coordinates
+			vec3d rt[4];
+			for (int j=0; j<4; ++j) rt[j] = m_pMesh->Node(el.m_node[j]).m_rt;
 
-		// calculate the volume
-		Ve = m_Ve0[i];
-		ve = TetVolume(rt);
+			// calculate the volume
+			ve[i] = TetVolume(rt);
+
+			// calculate the deformation gradient
+			defgrad(el, Fe[i], 0);
+		}
+		catch (NegativeJacobian e)
+		{
+			#pragma omp critical
+			{
+				berr = true;
+				if (e.DoOutput()) feLogError(e.what());
+			}
+		}
+	}
 
-		// calculate the deformation gradient
-		defgrad(el, Fe, 0);
+	// if we encountered an error, we request a running restart
+	if (berr)
+	{
+		if (NegativeJacobian::DoOutput() == false) feLogError("Negative jacobian was detected.");
+		throw DoRunningRestart();
+	}
 
-		// now assign one-quart to each node
-		for (j=0; j<4; ++j) 
+	// now assign one-quart to each node
+	for (int i=0; i<NE; ++i)
+	{
+		FESolidElement& el = m_Elem[i];
+		double Ve = m_Ve0[i];
+		for (int j=0; j<4; ++j) 
 		{
 			UT4NODE& n = m_NODE[ m_tag[el.m_node[j]]];
-			n.vi += 0.25*ve;
-			n.Fi += Fe*(0.25*Ve / n.Vi);
+			n.vi += 0.25*ve[i];
+			n.Fi += Fe[i]*(0.25*Ve / n.Vi);
 		}
 	}
 
-	// create a material point
-	// TODO: this will set the Q variable to a unit-matrix
-	//		 in other words, we loose the material axis orientation
-	//		 For now, I solve this by copying the Q parameter
-	//       from the first element that the node connects to
-	FEElasticMaterialPoint pt;
-	pt.Init();
-
 	// loop over all the nodes
-	for (i=0; i<(int) m_NODE.size(); ++i)
+	#pragma omp parallel
 	{
-		UT4NODE& node = m_NODE[i];
+		// create a material point
+		// TODO: this will set the Q variable to a unit-matrix
+		//		 in other words, we loose the material axis orientation
+		//		 For now, I solve this by copying the Q parameter
+		//       from the first element that the node connects to
+		FEElasticMaterialPoint pt;
+		pt.Init();
+
+		#pragma omp for
+		for (int i=0; i<NN; ++i)
+		{
+			UT4NODE& node = m_NODE[i];
 
-		// set the material point data
-		pt.m_r0 = m_pMesh->Node(node.inode).m_r0;
-		pt.m_rt = m_pMesh->Node(node.inode).m_rt;
+			// set the material point data
+			pt.m_r0 = m_pMesh->Node(node.inode).m_r0;
+			pt.m_rt = m_pMesh->Node(node.inode).m_rt;
 
-		pt.m_F = node.Fi;
-		pt.m_J = pt.m_F.det();
+			pt.m_F = node.Fi;
+			pt.m_J = pt.m_F.det();
 
-		// calculate the stress
-		node.si = m_pMat->Stress(pt);
+			// calculate the stress
+			node.si = m_pMat->Stress(pt);
+		}
 	}
 }
 
@@ -639,14 +687,19 @@ void FEUT4Domain::StiffnessMatrix(FELinearSystem& LS)
 //! Calculates the nodal contribution to the global stiffness matrix
 void FEUT4Domain::NodalStiffnessMatrix(FELinearSystem& LS)
 {
-	vector<int> elm;
-	vector<int> LM;
-	vector<int> en;
+	// make sure we have work buffers for each thread
+	if (omp_get_max_threads() > m_nthreads) AllocBuffers();
 
 	// loop over all the nodes
-	int NN = (int) m_NODE.size(), ni, nj;
+	int NN = (int) m_NODE.size();
+	#pragma omp parallel for shared(NN)
 	for (int i=0; i<NN; ++i)
 	{
+		vector<int> elm;
+		vector<int> LM;
+		vector<int> en;
+		int ni, nj;
+
 		// get the next node
 		UT4NODE& node = m_NODE[i];
 		FEElement** ppe = m_NEL.ElementList(node.inode);
@@ -680,13 +733,13 @@ void FEUT4Domain::NodalStiffnessMatrix(FELinearSystem& LS)
 		{
 			FEElement& el = *ppe[ni];
 			UnpackLM(el, elm);
-			for (int i=0; i<4; ++i)
+			for (int k=0; k<4; ++k)
 			{
-				LM[ni*4*3+3*i  ] = elm[3*i  ];
-				LM[ni*4*3+3*i+1] = elm[3*i+1];
-				LM[ni*4*3+3*i+2] = elm[3*i+2];
+				LM[ni*4*3+3*k  ] = elm[3*k  ];
+				LM[ni*4*3+3*k+1] = elm[3*k+1];
+				LM[ni*4*3+3*k+2] = elm[3*k+2];
 
-				en[ni*4+i] = el.m_node[i];
+				en[ni*4+k] = el.m_node[k];
 			}
 		}
 	
@@ -701,6 +754,11 @@ void FEUT4Domain::NodalStiffnessMatrix(FELinearSystem& LS)
 //! calculates the nodal geometry stiffness contribution
 void FEUT4Domain::NodalGeometryStiffness(UT4NODE& node, matrix& ke)
 {
+	// get this thread's work buffer
+	int tid = omp_get_thread_num();
+	assert(tid < m_nthreads);
+	double (*Ge)[4][3] = m_Ge + m_nbuf*tid;
+
 	int i, j, ni, nj;
 
 	// get the element list 
@@ -741,9 +799,9 @@ void FEUT4Domain::NodalGeometryStiffness(UT4NODE& node, matrix& ke)
 		{
 			// calculate global gradient of shape functions
 			// note that we need the transposed of Ji, not Ji itself !
-			m_Ge[ni][j][0] = Ji[0][0]*Gr[j]+Ji[1][0]*Gs[j]+Ji[2][0]*Gt[j];
-			m_Ge[ni][j][1] = Ji[0][1]*Gr[j]+Ji[1][1]*Gs[j]+Ji[2][1]*Gt[j];
-			m_Ge[ni][j][2] = Ji[0][2]*Gr[j]+Ji[1][2]*Gs[j]+Ji[2][2]*Gt[j];
+			Ge[ni][j][0] = Ji[0][0]*Gr[j]+Ji[1][0]*Gs[j]+Ji[2][0]*Gt[j];
+			Ge[ni][j][1] = Ji[0][1]*Gr[j]+Ji[1][1]*Gs[j]+Ji[2][1]*Gt[j];
+			Ge[ni][j][2] = Ji[0][2]*Gr[j]+Ji[1][2]*Gs[j]+Ji[2][2]*Gt[j];
 		}
 	}
 
@@ -772,12 +830,12 @@ void FEUT4Domain::NodalGeometryStiffness(UT4NODE& node, matrix& ke)
 			double sg[3];
 			for (i=0; i<4; ++i)
 			{
-				double (&Gi)[3] = *(m_Ge[ni] + i);
+				double (&Gi)[3] = *(Ge[ni] + i);
 				int mi = ni*12+i*3;
 				int j0 = (ni==nj?i:0);
 				for (j=j0; j<4; ++j)
 				{
-					double (&Gj)[3] = *(m_Ge[nj] + j);
+					double (&Gj)[3] = *(Ge[nj] + j);
 					int mj = nj*12+j*3;
 
 					sg[0] = S.xx()*Gj[0] + S.xy()*Gj[1] + S.xz()*Gj[2];
@@ -815,6 +873,12 @@ tens4ds FEUT4Domain::Cvol(const tens4ds& C, const mat3ds& S)
 //! Calculates the nodal material stiffness contribution
 void FEUT4Domain::NodalMaterialStiffness(UT4NODE& node, matrix& ke, FESolidMaterial* pme)
 {
+	// get this thread's work buffers
+	int tid = omp_get_thread_num();
+	assert(tid < m_nthreads);
+	double (*Be)[6][3] = m_Be + m_nbuf*tid;
+	double (*DB)[6][3] = m_DB + m_nbuf*tid;
+
 	// get the number of elements this nodes connects
 	int NE = m_NEL.Valence(node.inode);
 	FEElement** ppe = m_NEL.ElementList(node.inode);
@@ -886,7 +950,7 @@ void FEUT4Domain::NodalMaterialStiffness(UT4NODE& node, matrix& ke, FESolidMater
 			Gy = Ji[0][1]*Gr[j]+Ji[1][1]*Gs[j]+Ji[2][1]*Gt[j];
 			Gz = Ji[0][2]*Gr[j]+Ji[1][2]*Gs[j]+Ji[2][2]*Gt[j];
 
-			double (&Bi)[6][3] = *(m_Be+(4*ni+j));
+			double (&Bi)[6][3] = *(Be+(4*ni+j));
 			Bi[0][0] = Fe[0][0]*Gx; Bi[0][1] = Fe[1][0]*Gx; Bi[0][2] = Fe[2][0]*Gx;
 			Bi[1][0] = Fe[0][1]*Gy; Bi[1][1] = Fe[1][1]*Gy; Bi[1][2] = Fe[2][1]*Gy;
 			Bi[2][0] = Fe[0][2]*Gz; Bi[2][1] = Fe[1][2]*Gz; Bi[2][2] = Fe[2][2]*Gz;
@@ -894,7 +958,7 @@ void FEUT4Domain::NodalMaterialStiffness(UT4NODE& node, matrix& ke, FESolidMater
 			Bi[4][0] = Fe[0][1]*Gz + Fe[0][2]*Gy; Bi[4][1] = Fe[1][1]*Gz + Fe[1][2]*Gy; Bi[4][2] = Fe[2][1]*Gz + Fe[2][2]*Gy;
 			Bi[5][0] = Fe[0][2]*Gx + Fe[0][0]*Gz; Bi[5][1] = Fe[1][2]*Gx + Fe[1][0]*Gz; Bi[5][2] = Fe[2][2]*Gx + Fe[2][0]*Gz;
 
-			double (&DBi)[6][3] = *(m_DB+(4*ni+j));
+			double (&DBi)[6][3] = *(DB+(4*ni+j));
 			DBi[0][0] = (D[0][0]*Bi[0][0]+D[0][1]*Bi[1][0]+D[0][2]*Bi[2][0]+D[0][3]*Bi[3][0]+D[0][4]*Bi[4][0]+D[0][5]*Bi[5][0]);
 			DBi[0][1] = (D[0][0]*Bi[0][1]+D[0][1]*Bi[1][1]+D[0][2]*Bi[2][1]+D[0][3]*Bi[3][1]+D[0][4]*Bi[4][1]+D[0][5]*Bi[5][1]);
 			DBi[0][2] = (D[0][0]*Bi[0][2]+D[0][1]*Bi[1][2]+D[0][2]*Bi[2][2]+D[0][3]*Bi[3][2]+D[0][4]*Bi[4][2]+D[0][5]*Bi[5][2]);
@@ -940,14 +1004,14 @@ void FEUT4Domain::NodalMaterialStiffness(UT4NODE& node, matrix& ke, FESolidMater
 			// We're ready to rock and roll!
 			for (i=0; i<4; ++i)
 			{
-				double (&Bi)[6][3] = *(m_Be+(ni*4 + i));
+				double (&Bi)[6][3] = *(Be+(ni*4 + i));
 				int mi = ni*12+i*3;
 				int j0 = (nj==ni?i:0);
 
 				for (j=j0; j<4; ++j)
 				{
 					// calculate the Bi*D*Bj term
-					double (&DBj)[6][3] = *(m_DB+(nj*4 + j));
+					double (&DBj)[6][3] = *(DB+(nj*4 + j));
 					int mj = nj*12+j*3;
 
 					ke[mi  ][mj  ] += wij*(Bi[0][0]*DBj[0][0]+Bi[1][0]*DBj[1][0]+Bi[2][0]*DBj[2][0]+Bi[3][0]*DBj[3][0]+Bi[4][0]*DBj[4][0]+Bi[5][0]*DBj[5][0]);
@@ -130,6 +130,9 @@ protected:
 
 	tens4ds Cvol(const tens4ds& C, const mat3ds& S);
 
+	//! allocate the work buffers
+	void AllocBuffers();
+
 	double	m_alpha;	//!< stabilization factor alpha
 	bool	m_bdev;		//!< use deviatoric components only for the element contribution
 
@@ -138,9 +141,12 @@ private:
 	vector<UT4NODE>	m_NODE;	//!< Nodal data
 	vector<double>	m_Ve0;	//!< initial element volumes
 
+	// work buffers (one set per thread, each of size m_nbuf)
 	double	(*m_Be)[6][3];
 	double	(*m_DB)[6][3];
 	double	(*m_Ge)[4][3];
+	int		m_nbuf;
+	int		m_nthreads;	//!< number of threads the buffers were allocated for
 
 	FENodeElemList	m_NEL;
 
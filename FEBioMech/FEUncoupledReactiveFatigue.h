@@ -59,7 +59,9 @@ public:
     // returns a pointer to a new material point object
     FEMaterialPoint* CreateMaterialPointData() override
     {
-        return new FEReactiveFatigueMaterialPoint(m_pBase->CreateMaterialPointData());
+        FEReactiveFatigueMaterialPoint* pt = new FEReactiveFatigueMaterialPoint(m_pBase->CreateMaterialPointData());
+        pt->m_pgen = &m_gen;
+        return pt;
     }
     
     // get the elastic material
@@ -78,6 +80,7 @@ public:
 public:
     double      m_k0;       // reaction rate for fatigue reaction
     double      m_beta;     // power exponent for fatigue reaction
+    FatigueGenerationLimits m_gen;  // limits on the number of fatigue generations
     
     DECLARE_FECORE_CLASS();
 };
@@ -48,6 +48,8 @@ BEGIN_FECORE_CLASS(FEUncoupledReactiveViscoelasticMaterial, FEUncoupledMaterial)
 	ADD_PARAMETER(m_btype, FE_RANGE_CLOSED(1, 2), "kinetics");
 	ADD_PARAMETER(m_ttype, FE_RANGE_CLOSED(0, 2), "trigger" );
     ADD_PARAMETER(m_emin , FE_RANGE_GREATER_OR_EQUAL(0.0), "emin");
+	ADD_PARAMETER(m_ngmax, FE_RANGE_GREATER_OR_EQUAL(0), "max_generations");
+	ADD_PARAMETER(m_gtol , FE_RANGE_GREATER_OR_EQUAL(0.0), "generation_tol");
 
 	// set material properties
 	ADD_PROPERTY(m_pBase, "elastic");
@@ -66,6 +68,9 @@ FEUncoupledReactiveViscoelasticMaterial::FEUncoupledReactiveViscoelasticMaterial
     m_ttype = 0;
     m_emin = 0;
 
+    m_ngmax = 0;
+    m_gtol = 0;
+    
     m_nmax = 0;
 
     m_pBase = nullptr;
@@ -185,8 +190,8 @@ bool FEUncoupledReactiveViscoelasticMaterial::NewGeneration(FEMaterialPoint& mp)
     // the last generation, in which case store the current state
     // evaluate the relative deformation gradient
     mat3d F = ep.m_F;
-    int lg = (int)pt.m_Uv.size() - 1;
-    mat3ds Ui = (lg > -1) ? pt.m_Uv[lg].inverse() : mat3dd(1);
+    int lg = pt.m_gen.size() - 1;
+    mat3ds Ui = (lg > -1) ? pt.m_gen[lg].m_Uv.inverse() : mat3dd(1);
     mat3d Fu = F*Ui;
     
     switch (m_ttype) {
@@ -242,13 +247,13 @@ double FEUncoupledReactiveViscoelasticMaterial::BreakingBondMassFraction(FEMater
     
     // current time
     double time = GetFEModel()->GetTime().currentTime;
-    double dtv = time - pt.m_v[ig];
+    double dtv = time - pt.m_gen[ig].m_v;
 
     switch (m_btype) {
         case 1:
         {
             if (dtv >= 0)
-                w = pt.m_f[ig]*m_pRelx->Relaxation(mp, dtv, D);
+                w = pt.m_gen[ig].m_f*m_pRelx->Relaxation(mp, dtv, D);
         }
             break;
         case 2:
@@ -258,7 +263,7 @@ double FEUncoupledReactiveViscoelasticMaterial::BreakingBondMassFraction(FEMater
             }
             else
             {
-                double dtu = time - pt.m_v[ig-1];
+                double dtu = time - pt.m_gen[ig-1].m_v;
                 w = m_pRelx->Relaxation(mp, dtv, D) - m_pRelx->Relaxation(mp, dtu, D);
             }
         }
@@ -290,15 +295,15 @@ double FEUncoupledReactiveViscoelasticMaterial::ReformingBondMassFraction(FEMate
     double J = ep.m_J;
     
     // get current number of generations
-    int ng = (int)pt.m_Uv.size();
+    int ng = pt.m_gen.size();
     
-    double f = (!pt.m_wv.empty()) ? pt.m_wv.back() : 1;
+    double f = (!pt.m_gen.empty()) ? pt.m_gen.back().m_wv : 1;
     
     for (int ig=0; ig<ng-1; ++ig)
     {
         // evaluate deformation gradient when this generation starts breaking
-        ep.m_F = pt.m_Uv[ig];
-        ep.m_J = pt.m_Jv[ig];
+        ep.m_F = pt.m_gen[ig].m_Uv;
+        ep.m_J = pt.m_gen[ig].m_Jv;
         // evaluate the breaking bond mass fraction for this generation
         f -= BreakingBondMassFraction(mp, ig, D);
     }
@@ -345,7 +350,7 @@ mat3ds FEUncoupledReactiveViscoelasticMaterial::DevStressWeakBonds(FEMaterialPoi
     mat3ds s; s.zero();
     
     // current number of breaking generations
-    int ng = (int)pt.m_Uv.size();
+    int ng = pt.m_gen.size();
     
     // no bonds have broken
     if (ng == 0) {
@@ -363,14 +368,14 @@ mat3ds FEUncoupledReactiveViscoelasticMaterial::DevStressWeakBonds(FEMaterialPoi
         // calculate the bond stresses for breaking generations
         for (int ig=0; ig<ng; ++ig) {
             // evaluate bond mass fraction for this generation
-            ep.m_F = pt.m_Uv[ig];
-            ep.m_J = pt.m_Jv[ig];
+            ep.m_F = pt.m_gen[ig].m_Uv;
+            ep.m_J = pt.m_gen[ig].m_Jv;
             w = BreakingBondMassFraction(wb, ig, D);
             // evaluate relative deformation gradient for this generation
             if (ig > 0) {
-                ep.m_F = F*pt.m_Uv[ig-1].inverse();
-                ep.m_J = J/pt.m_Jv[ig-1];
-                if (fp) fp->SetPreStretch(pt.m_Uv[ig-1]);
+                ep.m_F = F*pt.m_gen[ig-1].m_Uv.inverse();
+                ep.m_J = J/pt.m_gen[ig-1].m_Jv;
+                if (fp) fp->SetPreStretch(pt.m_gen[ig-1].m_Uv);
             }
             else {
                 ep.m_F = F;
@@ -380,7 +385,7 @@ mat3ds FEUncoupledReactiveViscoelasticMaterial::DevStressWeakBonds(FEMaterialPoi
             // evaluate bond stress
             sb = m_pBond->DevStress(wb);
             // add bond stress to total stress
-            s += (ig > 0) ? sb*w/pt.m_Jv[ig-1] : sb*w;
+            s += (ig > 0) ? sb*w/pt.m_gen[ig-1].m_Jv : sb*w;
         }
         
         // restore safe copy of deformation gradient
@@ -434,7 +439,7 @@ tens4ds FEUncoupledReactiveViscoelasticMaterial::DevTangentWeakBonds(FEMaterialP
     tens4ds c; c.zero();
     
     // current number of breaking generations
-    int ng = (int)pt.m_Uv.size();
+    int ng = pt.m_gen.size();
     
     // no bonds have broken
     if (ng == 0) {
@@ -452,14 +457,14 @@ tens4ds FEUncoupledReactiveViscoelasticMaterial::DevTangentWeakBonds(FEMaterialP
         // calculate the bond tangents for breaking generations
         for (int ig=0; ig<ng; ++ig) {
             // evaluate bond mass fraction for this generation
-            ep.m_F = pt.m_Uv[ig];
-            ep.m_J = pt.m_Jv[ig];
+            ep.m_F = pt.m_gen[ig].m_Uv;
+            ep.m_J = pt.m_gen[ig].m_Jv;
             w = BreakingBondMassFraction(wb, ig, D);
             // evaluate relative deformation gradient for this generation
             if (ig > 0) {
-                ep.m_F = F*pt.m_Uv[ig-1].inverse();
-                ep.m_J = J/pt.m_Jv[ig-1];
-                if (fp) fp->SetPreStretch(pt.m_Uv[ig-1]);
+                ep.m_F = F*pt.m_gen[ig-1].m_Uv.inverse();
+                ep.m_J = J/pt.m_gen[ig-1].m_Jv;
+                if (fp) fp->SetPreStretch(pt.m_gen[ig-1].m_Uv);
             }
             else {
                 ep.m_F = F;
@@ -469,7 +474,7 @@ tens4ds FEUncoupledReactiveViscoelasticMaterial::DevTangentWeakBonds(FEMaterialP
             // evaluate bond tangent
             cb = m_pBond->DevTangent(wb);
             // add bond tangent to total tangent
-            c += (ig > 0) ? cb*w/pt.m_Jv[ig-1] : cb*w;
+            c += (ig > 0) ? cb*w/pt.m_gen[ig-1].m_Jv : cb*w;
         }
         
         // restore safe copy of deformation gradient
@@ -523,7 +528,7 @@ double FEUncoupledReactiveViscoelasticMaterial::WeakBondDevSED(FEMaterialPoint&
     double sed = 0;
     
     // current number of breaking generations
-    int ng = (int)pt.m_Uv.size();
+    int ng = pt.m_gen.size();
     
     // no bonds have broken
     if (ng == 0) {
@@ -541,14 +546,14 @@ double FEUncoupledReactiveViscoelasticMaterial::WeakBondDevSED(FEMaterialPoint&
         // calculate the strain energy density for breaking generations
         for (int ig=0; ig<ng; ++ig) {
             // evaluate bond mass fraction for this generation
-            ep.m_F = pt.m_Uv[ig];
-            ep.m_J = pt.m_Jv[ig];
+            ep.m_F = pt.m_gen[ig].m_Uv;
+            ep.m_J = pt.m_gen[ig].m_Jv;
             w = BreakingBondMassFraction(wb, ig, D);
             // evaluate relative deformation gradient for this generation
             if (ig > 0) {
-                ep.m_F = F*pt.m_Uv[ig-1].inverse();
-                ep.m_J = J/pt.m_Jv[ig-1];
-                if (fp) fp->SetPreStretch(pt.m_Uv[ig-1]);
+                ep.m_F = F*pt.m_gen[ig-1].m_Uv.inverse();
+                ep.m_J = J/pt.m_gen[ig-1].m_Jv;
+                if (fp) fp->SetPreStretch(pt.m_gen[ig-1].m_Uv);
             }
             else {
                 ep.m_F = F;
@@ -596,8 +601,9 @@ void FEUncoupledReactiveViscoelasticMaterial::CullGenerations(FEMaterialPoint& m
     mat3d F = ep.m_F;
     double J = ep.m_J;
     
-    int ng = (int)pt.m_v.size();
+    int ng = pt.m_gen.size();
     m_nmax = max(m_nmax, ng);
+    if ((m_ngmax > 0) && (m_nmax > m_ngmax)) m_nmax = m_ngmax;
     
     // don't cull if we have too few generations
     if (ng < 3) return;
@@ -606,23 +612,14 @@ void FEUncoupledReactiveViscoelasticMaterial::CullGenerations(FEMaterialPoint& m
     if (ng < m_nmax) return;
 
     // always check oldest generation
-    ep.m_F = pt.m_Uv[0];
-    ep.m_J = pt.m_Jv[0];
+    ep.m_F = pt.m_gen[0].m_Uv;
+    ep.m_J = pt.m_gen[0].m_Jv;
     double w0 = BreakingBondMassFraction(mp, 0, D);
     if (w0 < m_wmin) {
-        ep.m_F = pt.m_Uv[1];
-        ep.m_J = pt.m_Jv[1];
+        ep.m_F = pt.m_gen[1].m_Uv;
+        ep.m_J = pt.m_gen[1].m_Jv;
         double w1 = BreakingBondMassFraction(mp, 1, D);
-        pt.m_v[1] = (w0*pt.m_v[0] + w1*pt.m_v[1])/(w0+w1);
-        pt.m_Uv[1] = (pt.m_Uv[0]*w0 + pt.m_Uv[1]*w1)/(w0+w1);
-        pt.m_Jv[1] = pt.m_Uv[1].det();
-        pt.m_f[1] = (w0*pt.m_f[0] + w1*pt.m_f[1])/(w0+w1);
-        pt.m_wv[1] = (w0*pt.m_wv[0] + w1*pt.m_wv[1])/(w0+w1);
-        pt.m_Uv.pop_front();
-        pt.m_Jv.pop_front();
-        pt.m_v.pop_front();
-        pt.m_f.pop_front();
-        pt.m_wv.pop_front();
+        pt.MergeGenerations(0, w0, w1);
     }
     
     // restore safe copy of deformation gradient
@@ -632,6 +629,64 @@ void FEUncoupledReactiveViscoelasticMaterial::CullGenerations(FEMaterialPoint& m
     return;
 }
 
+//-----------------------------------------------------------------------------
+//! Merge adjacent generations once their number exceeds the user-defined limit.
+//! Pairs whose relaxation differs by less than m_gtol are merged first, then the
+//! closest pairs are merged until the limit is met. The reforming (newest)
+//! generation is never merged.
+void FEUncoupledReactiveViscoelasticMaterial::CompactGenerations(FEMaterialPoint& mp)
+{
+    // get the reactive viscoelastic point data
+    FEReactiveVEMaterialPoint& pt = *mp.ExtractData<FEReactiveVEMaterialPoint>();
+    
+    int ng = pt.m_gen.size();
+    if ((m_ngmax <= 0) || (ng <= m_ngmax)) return;
+    
+    // get the elastic material point data
+    FEElasticMaterialPoint& ep = *mp.ExtractData<FEElasticMaterialPoint>();
+    
+    mat3ds D = ep.RateOfDeformation();
+    
+    // keep safe copy of deformation gradient
+    mat3d F = ep.m_F;
+    double J = ep.m_J;
+    
+    // evaluate the bond mass fraction and relaxation of each generation
+    double time = GetFEModel()->GetTime().currentTime;
+    vector<double> w(ng), g(ng);
+    for (int ig=0; ig<ng; ++ig) {
+        ep.m_F = pt.m_gen[ig].m_Uv;
+        ep.m_J = pt.m_gen[ig].m_Jv;
+        w[ig] = BreakingBondMassFraction(mp, ig, D);
+        g[ig] = m_pRelx->Relaxation(mp, time - pt.m_gen[ig].m_v, D);
+    }
+    
+    // restore safe copy of deformation gradient
+    ep.m_F = F;
+    ep.m_J = J;
+    
+    while (ng > 2) {
+        // find the adjacent breaking generations with the closest relaxation
+        int imin = 0;
+        double dmin = fabs(g[1] - g[0]);
+        for (int ig=1; ig<ng-2; ++ig) {
+            double d = fabs(g[ig+1] - g[ig]);
+            if (d < dmin) { dmin = d; imin = ig; }
+        }
+        
+        if ((dmin > m_gtol) && (ng <= m_ngmax)) break;
+        
+        // merge them
+        double w0 = w[imin], w1 = w[imin+1];
+        pt.MergeGenerations(imin, w0, w1);
+        g[imin+1] = (w0 + w1 > 0 ? (w0*g[imin] + w1*g[imin+1])/(w0 + w1) : (g[imin] + g[imin+1])/2);
+        w[imin+1] = w0 + w1;
+        g.erase(g.begin() + imin);
+        w.erase(w.begin() + imin);
+        ng--;
+    }
+}
+
 //-----------------------------------------------------------------------------
 //! Update specialized material points
 void FEUncoupledReactiveViscoelasticMaterial::UpdateSpecializedMaterialPoints(FEMaterialPoint& mp, const FETimeInfo& tp)
@@ -653,38 +708,41 @@ void FEUncoupledReactiveViscoelasticMaterial::UpdateSpecializedMaterialPoints(FE
     double Jv = ep.m_J;
 
     // if new generation not already created for current time, check if it should
-    if (pt.m_v.empty() || (pt.m_v.back() < tp.currentTime)) {
+    if (pt.m_gen.empty() || (pt.m_gen.back().m_v < tp.currentTime)) {
         // check if the current deformation gradient is different from that of
         // the last generation, in which case store the current state
         if (NewGeneration(wb)) {
-            pt.m_v.push_back(tp.currentTime);
-            pt.m_Uv.push_back(Uv);
-            pt.m_Jv.push_back(Jv);
-            double f = (!pt.m_v.empty()) ? ReformingBondMassFraction(wb) : 1;
-            pt.m_f.push_back(f);
+            BondGeneration g;
+            g.m_v = tp.currentTime;
+            g.m_Uv = Uv;
+            g.m_Jv = Jv;
+            g.m_wv = (!pt.m_gen.empty()) ? pt.m_gen.back().m_wv : 1;
+            pt.m_gen.push_back(g);
+            pt.m_gen.back().m_f = ReformingBondMassFraction(wb);
             if (m_pWCDF) {
                 pt.m_Et = ScalarStrain(pt);
                 if (pt.m_Et > pt.m_Em)
-                    pt.m_wv.push_back(m_pWCDF->cdf(pt.m_Et));
+                    pt.m_gen.back().m_wv = m_pWCDF->cdf(pt.m_Et);
                 else
-                    pt.m_wv.push_back(m_pWCDF->cdf(pt.m_Em));
+                    pt.m_gen.back().m_wv = m_pWCDF->cdf(pt.m_Em);
             }
-            else pt.m_wv.push_back(1);
+            else pt.m_gen.back().m_wv = 1;
             CullGenerations(wb);
+            CompactGenerations(wb);
         }
     }
     // otherwise, if we already have a generation for the current time, update the stored values
-    else if (pt.m_v.back() == tp.currentTime) {
-        pt.m_Uv.back() = Uv;
-        pt.m_Jv.back() = Jv;
+    else if (pt.m_gen.back().m_v == tp.currentTime) {
+        pt.m_gen.back().m_Uv = Uv;
+        pt.m_gen.back().m_Jv = Jv;
         if (m_pWCDF) {
             pt.m_Et = ScalarStrain(pt);
             if (pt.m_Et > pt.m_Em)
-                pt.m_wv.back() = m_pWCDF->cdf(pt.m_Et);
+                pt.m_gen.back().m_wv = m_pWCDF->cdf(pt.m_Et);
             else
-                pt.m_wv.back() = m_pWCDF->cdf(pt.m_Em);
+                pt.m_gen.back().m_wv = m_pWCDF->cdf(pt.m_Em);
         }
-        pt.m_f.back() = ReformingBondMassFraction(wb);
+        pt.m_gen.back().m_f = ReformingBondMassFraction(wb);
     }
 }
 
@@ -698,7 +756,7 @@ int FEUncoupledReactiveViscoelasticMaterial::RVEGenerations(FEMaterialPoint& mp)
     FEReactiveVEMaterialPoint& pt = *wb.ExtractData<FEReactiveVEMaterialPoint>();
     
     // return the bond mass fraction of the reforming generation
-    return (int)pt.m_v.size();
+    return pt.m_gen.size();
 }
 
 //-----------------------------------------------------------------------------
@@ -0,0 +1,241 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FEBatchSolver.h"
+#include <FEBioLib/FEBioModel.h>
+#include <FEBioLib/Logfile.h>
+#include <stdio.h>
+#ifndef WIN32
+#include <unistd.h>
+#include <poll.h>
+#include <sys/wait.h>
+#endif
+
+#ifdef WIN32
+extern "C" void __cdecl omp_set_num_threads(int);
+#else
+extern "C" void omp_set_num_threads(int);
+#endif
+
+//-----------------------------------------------------------------------------
+FEBatchSolver::FEBatchSolver(int workers, FEModel* fem)
+{
+	m_workers = (workers < 1 ? 1 : workers);
+	m_fem = fem;
+}
+
+//-----------------------------------------------------------------------------
+// The log of worker i is written to <log>.<i+1> (e.g. run.log -> run.3.log)
+void FEBatchSolver::OpenWorkerLog(int job)
+{
+	FEBioModel* fem = dynamic_cast<FEBioModel*>(m_fem);
+	if (fem == nullptr) return;
+
+	Logfile& log = fem->GetLogFile();
+	if (log.is_valid() == false) return;
+
+	string fileName = log.FileName();
+	if (fileName.empty()) return;
+
+	char szext[16];
+	sprintf(szext, ".%d", job + 1);
+	size_t n = fileName.rfind('.');
+	size_t m = fileName.find_last_of("/\\");
+	if ((n == string::npos) || ((m != string::npos) && (n < m))) fileName += szext;
+	else fileName.insert(n, szext);
+
+	// this closes the file we inherited from the parent
+	log.open(fileName.c_str());
+}
+
+//-----------------------------------------------------------------------------
+bool FEBatchSolver::Solve(const vector< vector<double> >& a, vector< vector<double> >& y, SolveFunction f)
+{
+	int N = (int)a.size();
+	y.assign(N, vector<double>());
+
+	int workers = m_workers;
+	if (workers > N) workers = N;
+
+#ifndef WIN32
+	if (workers > 1) return SolveForked(a, y, f, workers);
+#endif
+
+	for (int i = 0; i < N; ++i)
+	{
+		if (f(i, a[i], y[i]) == false) return false;
+	}
+	return true;
+}
+
+#ifndef WIN32
+//-----------------------------------------------------------------------------
+// write the buffer to a pipe
+static bool write_all(int fd, const void* pd, size_t n)
+{
+	const char* p = (const char*)pd;
+	while (n > 0)
+	{
+		ssize_t m = write(fd, p, n);
+		if (m <= 0) return false;
+		p += m; n -= (size_t)m;
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// read the buffer from a pipe
+static bool read_all(int fd, void* pd, size_t n)
+{
+	char* p = (char*)pd;
+	while (n > 0)
+	{
+		ssize_t m = read(fd, p, n);
+		if (m <= 0) return false;
+		p += m; n -= (size_t)m;
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// The message a worker sends back is the status flag, the size of the result
+// vector and the result vector itself.
+bool FEBatchSolver::SolveForked(const vector< vector<double> >& a, vector< vector<double> >& y, SolveFunction f, int workers)
+{
+	struct WORKER
+	{
+		pid_t	pid;
+		int		fd;		// read end of the pipe
+		int		job;	// index of the solve
+	};
+
+	int N = (int)a.size();
+	vector<WORKER> running;
+	int next = 0;
+	bool bok = true;
+	while ((bok && (next < N)) || (running.empty() == false))
+	{
+		// start new workers
+		while (bok && (next < N) && ((int)running.size() < workers))
+		{
+			int job = next++;
+
+			// make sure buffered output is not written twice
+			fflush(NULL);
+
+			int fd[2];
+			pid_t pid = -1;
+			if (pipe(fd) == 0)
+			{
+				pid = fork();
+				if (pid < 0) { close(fd[0]); close(fd[1]); }
+			}
+
+			if (pid == 0)
+			{
+				// this is the worker
+				close(fd[0]);
+
+				// A forked child cannot use more than one OpenMP thread: the runtime 
+				// deadlocks when the child starts a team after the parent already had one.
+				omp_set_num_threads(1);
+
+				OpenWorkerLog(job);
+
+				vector<double> yi;
+				int status = 0;
+				try {
+					status = (f(job, a[job], yi) ? 1 : 0);
+				}
+				catch (...)
+				{
+					status = 0;
+				}
+
+				int n = (int)yi.size();
+				bool b = write_all(fd[1], &status, sizeof(int)) && write_all(fd[1], &n, sizeof(int));
+				if (b && (n > 0)) b = write_all(fd[1], &yi[0], n*sizeof(double));
+				close(fd[1]);
+				fflush(NULL);
+				_exit(b ? 0 : 1);
+			}
+			else if (pid > 0)
+			{
+				close(fd[1]);
+				WORKER w = { pid, fd[0], job };
+				running.push_back(w);
+			}
+			else
+			{
+				// we could not start a worker, so do this one ourselves
+				if (f(job, a[job], y[job]) == false) bok = false;
+			}
+		}
+
+		if (running.empty()) break;
+
+		// wait for one of the workers to send its results
+		vector<pollfd> pfd(running.size());
+		for (size_t i = 0; i < running.size(); ++i)
+		{
+			pfd[i].fd = running[i].fd;
+			pfd[i].events = POLLIN;
+			pfd[i].revents = 0;
+		}
+		if (poll(&pfd[0], (nfds_t)pfd.size(), -1) < 0) continue;
+
+		for (size_t i = 0; i < pfd.size(); ++i)
+		{
+			if (pfd[i].revents == 0) continue;
+
+			// find the worker (the list shrinks while we go)
+			size_t k = 0;
+			while (running[k].fd != pfd[i].fd) ++k;
+			WORKER w = running[k];
+			running.erase(running.begin() + k);
+
+			// collect the results
+			int status = 0, n = 0;
+			bool b = read_all(w.fd, &status, sizeof(int)) && read_all(w.fd, &n, sizeof(int));
+			if (b && (n > 0))
+			{
+				y[w.job].resize(n);
+				b = read_all(w.fd, &(y[w.job])[0], n*sizeof(double));
+			}
+			close(w.fd);
+
+			int wstatus = 0;
+			waitpid(w.pid, &wstatus, 0);
+			if ((b == false) || (status == 0) || (WIFEXITED(wstatus) == 0) || (WEXITSTATUS(wstatus) != 0)) bok = false;
+		}
+	}
+
+	return bok;
+}
+#endif
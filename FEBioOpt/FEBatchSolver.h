@@ -0,0 +1,73 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include <vector>
+#include <functional>
+using namespace std;
+
+class FEModel;
+
+//-----------------------------------------------------------------------------
+//! Runs a batch of independent forward solves, e.g. the perturbed solves of a
+//! finite-difference Jacobian or the points of a parameter scan.
+//! On Linux and macOS each solve runs in a forked copy of the process, so the
+//! solves share nothing but the model state at the time of the fork. The result
+//! vector of each solve is passed back to the parent through a pipe. 
+//! The workers are single-threaded, since the OpenMP runtime cannot start new 
+//! threads in a forked child once the parent has used a parallel region. When 
+//! a model is given, each worker writes its log output to its own file. 
+//! On Windows, or when only one worker is requested, the solves simply run one 
+//! after another.
+class FEBatchSolver
+{
+public:
+	//! Function that does solve i for the parameters a and returns its results in y.
+	//! It should return false when the solve failed.
+	typedef std::function<bool (int i, const vector<double>& a, vector<double>& y)> SolveFunction;
+
+public:
+	FEBatchSolver(int workers, FEModel* fem = nullptr);
+
+	//! number of solves that may run at the same time
+	int Workers() const { return m_workers; }
+
+	//! Solve all the parameter vectors in a. The results are returned in y, 
+	//! in the same order as a. Returns false if any of the solves failed.
+	bool Solve(const vector< vector<double> >& a, vector< vector<double> >& y, SolveFunction f);
+
+private:
+	bool SolveForked(const vector< vector<double> >& a, vector< vector<double> >& y, SolveFunction f, int workers);
+
+	// redirect the log of a worker to its own file
+	void OpenWorkerLog(int job);
+
+private:
+	int			m_workers;
+	FEModel*	m_fem;
+};
@@ -43,6 +43,8 @@ BEGIN_FECORE_CLASS(FEConstrainedLMOptimizeMethod, FEOptimizeMethod)
 	ADD_PARAMETER(m_fdiff , "f_diff_scale");
 	ADD_PARAMETER(m_nmax  , "max_iter"    );
 	ADD_PARAMETER(m_scaleParams, "scale_parameters");
+	ADD_PARAMETER(m_breuse, "reuse_solver_data");
+	ADD_PARAMETER(m_bseed , "seed_time_steps");
 END_FECORE_CLASS();
 
 //-----------------------------------------------------------------------------
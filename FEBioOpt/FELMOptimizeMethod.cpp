@@ -39,6 +39,9 @@ BEGIN_FECORE_CLASS(FELMOptimizeMethod, FEOptimizeMethod)
 	ADD_PARAMETER(m_fdiff , "f_diff_scale");
 	ADD_PARAMETER(m_nmax  , "max_iter"    );
 	ADD_PARAMETER(m_bcov  , "print_cov"   );
+	ADD_PARAMETER(m_nworkers, "parallel_solves");
+	ADD_PARAMETER(m_breuse, "reuse_solver_data");
+	ADD_PARAMETER(m_bseed , "seed_time_steps");
 END_FECORE_CLASS();
 
 //-----------------------------------------------------------------------------
@@ -196,30 +199,35 @@ void FELMOptimizeMethod::ObjFun(vector<double>& x, vector<double>& a, vector<dou
 		}
 	}
 	
-	// evaluate at a
-	if (opt.FESolve(a) == false) throw FEErrorTermination();
-	
-	opt.GetObjective().Evaluate(y);
-	m_yopt = y;
-
-	// now calculate the derivatives using forward differences
-	int ndata = (int)x.size();
-	vector<double> a1(a);
-	vector<double> y1(ndata);
+	// Setup the parameters of the solve at a and of the forward differences.
+	// These solves are independent, so they can run concurrently.
 	int ma = (int)a.size();
+	vector< vector<double> > A(ma + 1, a);
 	for (int i=0; i<ma; ++i)
 	{
 		FEInputParameter& var = *opt.GetInputParameter(i);
 
 		double b = var.ScaleFactor();
 
-		a1[i] = a1[i] + dir*m_fdiff*(fabs(b) + fabs(a[i]));
-		assert(a1[i] != a[i]);
+		A[i + 1][i] = a[i] + dir*m_fdiff*(fabs(b) + fabs(a[i]));
+		assert(A[i + 1][i] != a[i]);
+	}
+
+	vector< vector<double> > Y;
+	vector<double> fobj;
+	if (opt.FESolveBatch(A, Y, fobj, m_nworkers) == false) throw FEErrorTermination();
 
-		if (opt.FESolve(a1) == false) throw FEErrorTermination();
-		opt.GetObjective().Evaluate(y1);
-		for (int j=0; j<ndata; ++j) dyda[j][i] = (y1[j] - y[j])/(a1[i] - a[i]);
-		a1[i] = a[i];
+	// the solution at a
+	y = Y[0];
+	m_yopt = y;
+
+	// now calculate the derivatives using forward differences
+	int ndata = (int)x.size();
+	for (int i=0; i<ma; ++i)
+	{
+		vector<double>& y1 = Y[i + 1];
+		double da = A[i + 1][i] - a[i];
+		for (int j=0; j<ndata; ++j) dyda[j][i] = (y1[j] - y[j])/da;
 	}
 }
 
@@ -30,6 +30,7 @@ SOFTWARE.*/
 #include "FEOptimizeData.h"
 #include "FELMOptimizeMethod.h"
 #include "FEOptimizeInput.h"
+#include "FEBatchSolver.h"
 #include <FECore/FECoreKernel.h>
 #include <FECore/FEModel.h>
 #include <FECore/FEAnalysis.h>
@@ -178,6 +179,12 @@ bool FEOptimizeData::Solve()
 	vector<double> amin(NVAR, 0.0);
 	vector<double> ymin;
 	double minObj = 0.0;
+
+	// the forward solves only differ in the parameter values, so the model 
+	// can hold on to its solver data between solves if requested
+	m_fem->SetReuseSolverData(m_pSolver->m_breuse);
+	m_fem->SetSeedTimeSteps(m_pSolver->m_bseed);
+
 	bool bret = m_pSolver->Solve(this, amin, ymin, &minObj);
 	if (bret)
 	{
@@ -267,3 +274,35 @@ bool FEOptimizeData::FESolve(const vector<double>& a)
 
 	return bret;
 }
+
+//-----------------------------------------------------------------------------
+bool FEOptimizeData::FESolveBatch(const vector< vector<double> >& a, vector< vector<double> >& y, vector<double>& fobj, int workers)
+{
+	FEObjectiveFunction& obj = GetObjective();
+
+	// The solves may run in worker processes, which cannot update our iteration
+	// counter, so each solve sets its own iteration number.
+	int niter = m_niter;
+	FEBatchSolver batch(workers, GetFEModel());
+	bool bret = batch.Solve(a, y, [&](int i, const vector<double>& ai, vector<double>& yi) {
+		m_niter = niter + i;
+		if (FESolve(ai) == false) return false;
+
+		// the objective value is passed back as the last entry
+		double f = obj.Evaluate(yi);
+		yi.push_back(f);
+		return true;
+	});
+	m_niter = niter + (int)a.size();
+	if (bret == false) return false;
+
+	int N = (int)a.size();
+	fobj.resize(N);
+	for (int i = 0; i < N; ++i)
+	{
+		fobj[i] = y[i].back();
+		y[i].pop_back();
+	}
+
+	return true;
+}
@@ -144,6 +144,11 @@ public:
 	//! solve the FE problem with a new set of parameters
 	bool FESolve(const vector<double>& a);
 
+	//! Solve the FE problem for several sets of parameters, running up to workers
+	//! solves at the same time. For each set, the function values are returned in y
+	//! and the objective value in fobj.
+	bool FESolveBatch(const vector< vector<double> >& a, vector< vector<double> >& y, vector<double>& fobj, int workers);
+
 public:
 	// return the number of input parameters
 	int InputParameters() { return (int)m_Var.size(); }
@@ -52,7 +52,7 @@ enum LogLevel {
 class FEOptimizeMethod : public FEParamContainer
 {
 public:
-	FEOptimizeMethod() { m_print_level = PRINT_ITERATIONS; }
+	FEOptimizeMethod() { m_print_level = PRINT_ITERATIONS; m_nworkers = 1; m_breuse = false; m_bseed = false; }
 
 	// Implement this function for solve an optimization problem
 	// should return the optimal values for the input parameters in a, the optimal
@@ -64,4 +64,7 @@ public:
 public:
 	int		m_loglevel;		//!< log file output level
 	int		m_print_level;	//!< level of detailed output
+	int		m_nworkers;		//!< number of forward solves that may run at the same time
+	bool	m_breuse;		//!< keep the solver data between forward solves
+	bool	m_bseed;		//!< start the time stepper from the previous solve's step size
 };
@@ -29,6 +29,7 @@ SOFTWARE.*/
 #include <FECore/FEModel.h>
 #include <FECore/FEAnalysis.h>
 #include <FECore/log.h>
+#include "FEBatchSolver.h"
 
 FESweepParam::FESweepParam()
 {
@@ -62,6 +63,7 @@ void FESweepParam::SetValue(double v)
 FEParameterSweep::FEParameterSweep(FEModel* fem) : FECoreTask(fem)
 {
 	m_niter = 0;
+	m_nworkers = 1;
 }
 
 //! initialization
@@ -163,6 +165,23 @@ bool FEParameterSweep::Input(const char* szfile)
 			// looks good, so throw it on the pile
 			m_params.push_back(p);
 		}
+		else if (tag == "parallel_solves")
+		{
+			tag.value(m_nworkers);
+			if (m_nworkers < 1) throw XMLReader::InvalidValue(tag);
+		}
+		else if (tag == "reuse_solver_data")
+		{
+			bool b = false;
+			tag.value(b);
+			GetFEModel()->SetReuseSolverData(b);
+		}
+		else if (tag == "seed_time_steps")
+		{
+			bool b = false;
+			tag.value(b);
+			GetFEModel()->SetSeedTimeSteps(b);
+		}
 		else throw XMLReader::InvalidTag(tag);
 		++tag;
 	} while (!tag.isend());
@@ -184,12 +203,12 @@ bool FEParameterSweep::Run()
 		a[i] = pi.m_min;
 	}
 
-	// run the parameter sweep
+	// collect the parameters of all the runs
+	vector< vector<double> > A;
 	bool bdone = false;
 	do
 	{
-		// solve the problem with the new input parameters
-		if (FESolve(a) == false) return false;
+		A.push_back(a);
 
 		// update indices
 		for (size_t i = 0; i<ma; ++i)
@@ -203,7 +222,26 @@ bool FEParameterSweep::Run()
 	}
 	while (!bdone);
 
-	return true;
+	// run the parameter sweep
+	if (m_nworkers <= 1)
+	{
+		for (size_t n = 0; n < A.size(); ++n)
+		{
+			if (FESolve(A[n]) == false) return false;
+		}
+		return true;
+	}
+
+	FEBatchSolver batch(m_nworkers, GetFEModel());
+	vector< vector<double> > Y;
+	int niter = m_niter;
+	bool bret = batch.Solve(A, Y, [=](int i, const vector<double>& ai, vector<double>& yi) {
+		m_niter = niter + i;
+		return FESolveWorker(ai);
+	});
+	m_niter = niter + (int)A.size();
+
+	return bret;
 }
 
 bool FEParameterSweep::FESolve(const vector<double>& a)
@@ -237,3 +275,18 @@ bool FEParameterSweep::FESolve(const vector<double>& a)
 
 	return bret;
 }
+
+//-----------------------------------------------------------------------------
+// Does one run of a parallel sweep. The runs execute in separate processes that 
+// would all append to the same plot file, so the plot output is turned off and
+// the run is only reported in the log.
+bool FEParameterSweep::FESolveWorker(const vector<double>& a)
+{
+	FEModel& fem = *GetFEModel();
+	fem.GetCurrentStep()->SetPlotLevel(FE_PLOT_NEVER);
+
+	bool bret = FESolve(a);
+	feLog("Iteration %d %s\n", m_niter, (bret ? "converged" : "failed"));
+
+	return bret;
+}
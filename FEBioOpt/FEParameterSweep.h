@@ -60,8 +60,10 @@ private:
 	bool Input(const char* szfile);
 	bool InitParams();
 	bool FESolve(const vector<double>& a);
+	bool FESolveWorker(const vector<double>& a);
 
 private:
 	vector<FESweepParam>	m_params;
 	int						m_niter;
+	int						m_nworkers;	//!< number of runs that may execute at the same time
 };
@@ -32,7 +32,9 @@ SOFTWARE.*/
 #include "FECore/log.h"
 
 BEGIN_FECORE_CLASS(FEScanOptimizeMethod, FEOptimizeMethod)
-
+	ADD_PARAMETER(m_nworkers, "parallel_solves");
+	ADD_PARAMETER(m_breuse, "reuse_solver_data");
+	ADD_PARAMETER(m_bseed , "seed_time_steps");
 END_FECORE_CLASS();
 
 //-----------------------------------------------------------------------------
@@ -43,7 +45,6 @@ bool FEScanOptimizeMethod::Solve(FEOptimizeData* pOpt, vector<double>& amin, vec
 {
 	if (pOpt == 0) return false;
 	FEOptimizeData& opt = *pOpt;
-	FEObjectiveFunction& obj = opt.GetObjective();
 
 	// set the intial values for the variables
 	int ma = opt.InputParameters();
@@ -54,25 +55,12 @@ bool FEScanOptimizeMethod::Solve(FEOptimizeData* pOpt, vector<double>& amin, vec
 		a[i] = var->MinValue();
 	}
 
-	// loop until done
-	vector<double> y(ma, 0.0);
+	// collect all the points of the scan
+	vector< vector<double> > A;
 	bool bdone = false;
-	double fmin = 0.0;
 	do
 	{
-		// solve the problem with the new input parameters
-		if (opt.FESolve(a) == false) return false;
-
-		// calculate objective function
-		double fobj = obj.Evaluate(y);
-
-		// update minimum
-		if ((fmin == 0.0) || (fobj < fmin))
-		{
-			fmin = fobj;
-			amin = a;
-			ymin = y;
-		}
+		A.push_back(a);
 
 		// update indices
 		for (int i=0; i<ma; ++i)
@@ -86,6 +74,23 @@ bool FEScanOptimizeMethod::Solve(FEOptimizeData* pOpt, vector<double>& amin, vec
 	}
 	while (!bdone);
 
+	// solve the problem for all the input parameters
+	vector< vector<double> > Y;
+	vector<double> fobj;
+	if (opt.FESolveBatch(A, Y, fobj, m_nworkers) == false) return false;
+
+	// find the minimum
+	double fmin = 0.0;
+	for (size_t n=0; n<A.size(); ++n)
+	{
+		if ((fmin == 0.0) || (fobj[n] < fmin))
+		{
+			fmin = fobj[n];
+			amin = A[n];
+			ymin = Y[n];
+		}
+	}
+
 	// store the optimum data
 	if (minObj) *minObj = fmin;
 
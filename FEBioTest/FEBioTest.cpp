@@ -35,6 +35,12 @@ SOFTWARE.*/
 #include "FEJFNKTangentDiagnostic.h"
 #include "FEBioEigenSolver.h"
 #include "FEResetTest.h"
+#include "FEDumpBenchmark.h"
+#include "FELinearSolverTest.h"
+#include "FEWorkspaceTest.h"
+#include "FEDumpFileTest.h"
+#include "FEResidualBufferTest.h"
+#include "FEMatrixFreeTest.h"
 
 namespace FEBioTest
 {
@@ -46,5 +52,11 @@ void InitModule()
 	REGISTER_FECORE_CLASS(FEJFNKTangentDiagnostic, "jfnk tangent test");
 	REGISTER_FECORE_CLASS(FEBioEigenSolver, "eigen");
 	REGISTER_FECORE_CLASS(FEResetTest, "reset_test");
+	REGISTER_FECORE_CLASS(FEDumpBenchmark, "dump_benchmark");
+	REGISTER_FECORE_CLASS(FELinearSolverTest, "linear_solver_test");
+	REGISTER_FECORE_CLASS(FEWorkspaceTest, "workspace_test");
+	REGISTER_FECORE_CLASS(FEDumpFileTest, "dump_file_test");
+	REGISTER_FECORE_CLASS(FEResidualBufferTest, "residual_buffer_test");
+	REGISTER_FECORE_CLASS(FEMatrixFreeTest, "matrix_free_test");
 }
 }
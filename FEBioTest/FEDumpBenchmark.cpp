@@ -0,0 +1,120 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FEDumpBenchmark.h"
+#include <FEBioLib/FEBioModel.h>
+#include <FEBioLib/Logfile.h>
+#include <FECore/DumpMemStream.h>
+#include <FECore/Timer.h>
+#include <iostream>
+#include <iomanip>
+using namespace std;
+
+//-----------------------------------------------------------------------------
+// Small object that is serialized through a pointer. Each instance adds one
+// entry to the pointer table of the dump stream.
+class DumpBenchmarkItem
+{
+public:
+	DumpBenchmarkItem() : m_val(0.0) {}
+
+	void Serialize(DumpStream& ar) { ar & m_val; }
+
+	static void SaveClass(DumpStream& ar, DumpBenchmarkItem* p) {}
+	static DumpBenchmarkItem* LoadClass(DumpStream& ar, DumpBenchmarkItem* p) { return new DumpBenchmarkItem; }
+
+public:
+	double	m_val;
+};
+
+//-----------------------------------------------------------------------------
+FEDumpBenchmark::FEDumpBenchmark(FEModel* pfem) : FECoreTask(pfem)
+{
+}
+
+//-----------------------------------------------------------------------------
+// initialize the benchmark
+bool FEDumpBenchmark::Init(const char* sz)
+{
+	FEBioModel& fem = dynamic_cast<FEBioModel&>(*GetFEModel());
+
+	Logfile& log = fem.GetLogFile();
+	log.SetMode(Logfile::MODE::LOG_FILE);
+
+	// do the FE initialization
+	return fem.Init();
+}
+
+//-----------------------------------------------------------------------------
+// run the benchmark
+bool FEDumpBenchmark::Run()
+{
+	FEModel* fem = GetFEModel();
+
+	DumpMemStream ar(*fem);
+	Timer timer;
+
+	// serialize the model, both as for a restart (deep) and as for a time step retry (shallow)
+	for (int i = 0; i < 2; ++i)
+	{
+		bool bshallow = (i == 1);
+		ar.clear();
+		ar.Open(true, bshallow);
+		timer.reset();
+		timer.start();
+		fem->Serialize(ar);
+		timer.stop();
+		size_t nbytes = ar.size();
+		double t = timer.GetTime();
+		cerr << (bshallow ? "shallow" : "deep   ") << " model dump: " << nbytes << " bytes in " << t << " s";
+		if (t > 0) cerr << " (" << (nbytes / t) / 1048576.0 << " MB/s)";
+		cerr << endl;
+	}
+
+	// serialize an increasing number of distinct objects. Each pointer is looked up and
+	// added to the pointer table, so the time per object should not grow with their number.
+	cerr << endl << setw(10) << "objects" << setw(15) << "time (s)" << setw(20) << "time/object (ns)" << endl;
+	for (int n = 1000; n <= 1000000; n *= 10)
+	{
+		vector<DumpBenchmarkItem*> items(n);
+		for (int i = 0; i < n; ++i) { items[i] = new DumpBenchmarkItem; items[i]->m_val = i; }
+
+		ar.clear();
+		timer.reset();
+		timer.start();
+		ar << items;
+		timer.stop();
+		double t = timer.GetTime();
+		cerr << setw(10) << n << setw(15) << t << setw(20) << 1e9*t / n << endl;
+
+		for (int i = 0; i < n; ++i) delete items[i];
+	}
+
+	return true;
+}
@@ -0,0 +1,138 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#include "stdafx.h"
+#include "FEDumpFileTest.h"
+#include <FEBioLib/FEBioModel.h>
+#include <FEBioLib/Logfile.h>
+#include <FECore/DumpFile.h>
+#include <FECore/Timer.h>
+#include <iostream>
+#include <stdio.h>
+using namespace std;
+
+//-----------------------------------------------------------------------------
+// write the data to the file, read it back, and compare
+static bool DumpFileRoundTrip(FEModel& fem, const char* szfile, const vector<double>& data, bool bcompress)
+{
+	const size_t N = data.size();
+
+	// write the data in blocks of different sizes
+	Timer timer;
+	timer.start();
+	DumpFile out(fem);
+	out.SetChunkSize(1048576);
+	out.SetCompression(bcompress);
+	if (out.Create(szfile) == false) { cerr << "Failed creating " << szfile << endl; return false; }
+	size_t n = 0, nblock = 1;
+	while (n < N)
+	{
+		size_t m = (n + nblock > N ? N - n : nblock);
+		if (out.write(&data[n], sizeof(double), m) != m*sizeof(double)) { cerr << "Write failed" << endl; return false; }
+		n += m;
+		nblock = (nblock % 100000) + 7777;
+	}
+	if (out.Close() == false) { cerr << "Failed writing " << szfile << endl; return false; }
+	timer.stop();
+	double twrite = timer.GetTime();
+
+	// get the file size
+	FILE* fp = fopen(szfile, "rb");
+	if (fp == nullptr) return false;
+	fseek(fp, 0, SEEK_END);
+	long fileSize = ftell(fp);
+	fclose(fp);
+
+	// read it back
+	timer.reset();
+	timer.start();
+	vector<double> tmp(N, 0.0);
+	DumpFile in(fem);
+	if (in.Open(szfile) == false) { cerr << "Failed opening " << szfile << endl; return false; }
+	n = 0; nblock = 3;
+	while (n < N)
+	{
+		size_t m = (n + nblock > N ? N - n : nblock);
+		if (in.read(&tmp[n], sizeof(double), m) != m*sizeof(double)) { cerr << "Read failed" << endl; return false; }
+		n += m;
+		nblock = (nblock % 100000) + 5555;
+	}
+	bool beos = in.EndOfStream();
+	in.Close();
+	timer.stop();
+	double tread = timer.GetTime();
+
+	bool bok = (tmp == data) && beos;
+	cerr << (bcompress ? "compressed  " : "uncompressed") << ": " << N*sizeof(double) << " bytes -> " << fileSize << " bytes, ";
+	cerr << "write " << twrite << " s, read " << tread << " s" << (bok ? "" : " (data mismatch)") << endl;
+
+	return bok;
+}
+
+//-----------------------------------------------------------------------------
+FEDumpFileTest::FEDumpFileTest(FEModel* pfem) : FECoreTask(pfem)
+{
+}
+
+//-----------------------------------------------------------------------------
+// initialize the test
+bool FEDumpFileTest::Init(const char* sz)
+{
+	FEBioModel& fem = dynamic_cast<FEBioModel&>(*GetFEModel());
+
+	Logfile& log = fem.GetLogFile();
+	log.SetMode(Logfile::MODE::LOG_FILE);
+
+	// do the FE initialization
+	return fem.Init();
+}
+
+//-----------------------------------------------------------------------------
+// run the test
+bool FEDumpFileTest::Run()
+{
+	FEModel& fem = *GetFEModel();
+
+	// 24 MB of data that compresses somewhat, but not trivially
+	const size_t N = 3000000;
+	vector<double> data(N);
+	unsigned int state = 1;
+	for (size_t i = 0; i < N; ++i)
+	{
+		state = 1664525u * state + 1013904223u;
+		data[i] = (i % 3 == 0 ? (double)(i / 3) : (double)(state >> 16));
+	}
+
+	const char* szfile = "dump_file_test.dmp";
+	bool bok = DumpFileRoundTrip(fem, szfile, data, true);
+	if (bok) bok = DumpFileRoundTrip(fem, szfile, data, false);
+	remove(szfile);
+
+	cerr << " --> Dump file test " << (bok ? "PASSED" : "FAILED") << endl;
+
+	return bok;
+}
@@ -0,0 +1,251 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#include "stdafx.h"
+#include "FELinearSolverTest.h"
+#include <FEBioLib/FEBioModel.h>
+#include <FEBioLib/Logfile.h>
+#include <FECore/FEGlobalMatrix.h>
+#include <FECore/LinearSolver.h>
+#include <FECore/FECoreKernel.h>
+#include <FECore/Timer.h>
+#include <iostream>
+#include <iomanip>
+#include <math.h>
+#include <algorithm>
+using namespace std;
+
+//-----------------------------------------------------------------------------
+// Simple linear congruential generator, so that the test is reproducible.
+class TestRNG
+{
+public:
+	TestRNG(unsigned int seed) : m_state(seed) {}
+
+	// returns a value in [-1, 1]
+	double next()
+	{
+		m_state = 1664525u * m_state + 1013904223u;
+		return 2.0*((double)m_state / 4294967295.0) - 1.0;
+	}
+
+private:
+	unsigned int	m_state;
+};
+
+//-----------------------------------------------------------------------------
+// Structured hexahedral grid with m nodes in each direction and 3 dofs per node
+class TestGrid
+{
+public:
+	TestGrid(int m) : m_m(m) {}
+
+	int Equations() const { return 3 * m_m*m_m*m_m; }
+	int Elements() const { return (m_m - 1)*(m_m - 1)*(m_m - 1); }
+
+	// equation numbers of element n
+	void ElementLM(int n, vector<int>& lm) const
+	{
+		int e = m_m - 1;
+		int i = n % e, j = (n / e) % e, k = n / (e*e);
+		lm.resize(24);
+		for (int l = 0; l < 8; ++l)
+		{
+			int node = (i + (l & 1)) + m_m*((j + ((l >> 1) & 1)) + m_m*(k + ((l >> 2) & 1)));
+			for (int d = 0; d < 3; ++d) lm[3 * l + d] = 3 * node + d;
+		}
+	}
+
+	// element matrix of element n: B^T*B + I with a random B
+	void ElementMatrix(int n, matrix& ke) const
+	{
+		TestRNG rng(n + 1);
+		matrix B(24, 24);
+		for (int i = 0; i < 24; ++i)
+			for (int j = 0; j < 24; ++j) B[i][j] = rng.next();
+
+		ke.resize(24, 24);
+		for (int i = 0; i < 24; ++i)
+			for (int j = 0; j < 24; ++j)
+			{
+				double kij = (i == j ? 1.0 : 0.0);
+				for (int k = 0; k < 24; ++k) kij += B[k][i] * B[k][j];
+				ke[i][j] = kij;
+			}
+	}
+
+private:
+	int	m_m;
+};
+
+//-----------------------------------------------------------------------------
+// Assemble the grid's matrix with the given solver and solve it. Returns the matrix.
+static FEGlobalMatrix* SolveGrid(LinearSolver* ls, const TestGrid& grid, vector<double>& b, vector<double>& x, double& tfactor)
+{
+	SparseMatrix* pS = ls->CreateSparseMatrix(REAL_SYMMETRIC);
+	if (pS == nullptr) return nullptr;
+	FEGlobalMatrix* pK = new FEGlobalMatrix(pS);
+
+	// build the matrix profile
+	int neq = grid.Equations();
+	int NE = grid.Elements();
+	vector<int> lm;
+	pK->build_begin(neq);
+	for (int n = 0; n < NE; ++n)
+	{
+		grid.ElementLM(n, lm);
+		pK->build_add(lm);
+	}
+	pK->build_end();
+	pS->Zero();
+
+	// assemble the matrix
+	matrix ke;
+	for (int n = 0; n < NE; ++n)
+	{
+		grid.ElementLM(n, lm);
+		grid.ElementMatrix(n, ke);
+		pS->Assemble(ke, lm);
+	}
+
+	// solve
+	Timer timer;
+	timer.start();
+	bool bok = ls->PreProcess() && ls->Factor();
+	timer.stop();
+	tfactor = timer.GetTime();
+
+	x.assign(neq, 0.0);
+	if (bok) bok = ls->BackSolve(&x[0], &b[0]);
+	if (bok == false)
+	{
+		delete pK;
+		return nullptr;
+	}
+
+	return pK;
+}
+
+//-----------------------------------------------------------------------------
+FELinearSolverTest::FELinearSolverTest(FEModel* pfem) : FECoreTask(pfem)
+{
+}
+
+//-----------------------------------------------------------------------------
+// initialize the test
+bool FELinearSolverTest::Init(const char* sz)
+{
+	FEBioModel& fem = dynamic_cast<FEBioModel&>(*GetFEModel());
+
+	Logfile& log = fem.GetLogFile();
+	log.SetMode(Logfile::MODE::LOG_FILE);
+
+	// do the FE initialization
+	return fem.Init();
+}
+
+//-----------------------------------------------------------------------------
+// run the test
+bool FELinearSolverTest::Run()
+{
+	FEModel* fem = GetFEModel();
+
+	const char* szsolver[2] = { "cholesky", "skyline" };
+
+	cerr << setw(10) << "equations" << setw(12) << "solver" << setw(15) << "factor (s)" << setw(15) << "residual" << endl;
+	bool bok = true;
+	for (int m = 6; m <= 16; m += 5)
+	{
+		TestGrid grid(m);
+		int neq = grid.Equations();
+
+		TestRNG rng(12345);
+		vector<double> b(neq);
+		for (int i = 0; i < neq; ++i) b[i] = rng.next();
+
+		// solve with both solvers
+		vector<double> x[2];
+		FEGlobalMatrix* pK[2] = { nullptr, nullptr };
+		double tfactor[2] = { 0.0, 0.0 };
+		LinearSolver* ls[2];
+		for (int i = 0; i < 2; ++i)
+		{
+			ls[i] = fecore_new<LinearSolver>(szsolver[i], fem);
+			if (ls[i]) pK[i] = SolveGrid(ls[i], grid, b, x[i], tfactor[i]);
+			if (pK[i] == nullptr)
+			{
+				cerr << "Failed solving with " << szsolver[i] << " solver" << endl;
+				bok = false;
+			}
+		}
+
+		// calculate the residuals with the matrix of the Cholesky solver,
+		// since the skyline solver factors its matrix in place.
+		if (pK[0] && pK[1])
+		{
+			SparseMatrix* A = pK[0]->GetSparseMatrixPtr();
+			double bnorm = 0.0;
+			for (int j = 0; j < neq; ++j) bnorm += b[j] * b[j];
+			bnorm = sqrt(bnorm);
+
+			vector<double> r(neq);
+			for (int i = 0; i < 2; ++i)
+			{
+				A->mult_vector(&x[i][0], &r[0]);
+				double rnorm = 0.0;
+				for (int j = 0; j < neq; ++j) rnorm += (r[j] - b[j])*(r[j] - b[j]);
+				double res = sqrt(rnorm) / bnorm;
+
+				cerr << setw(10) << neq << setw(12) << szsolver[i] << setw(15) << tfactor[i] << setw(15) << res << endl;
+				if (res > 1e-10) bok = false;
+			}
+
+			// compare the solutions
+			double dmax = 0.0, xmax = 0.0;
+			for (int j = 0; j < neq; ++j)
+			{
+				dmax = max(dmax, fabs(x[0][j] - x[1][j]));
+				xmax = max(xmax, fabs(x[1][j]));
+			}
+			if (dmax > 1e-8*xmax)
+			{
+				cerr << "Solutions differ: " << dmax << endl;
+				bok = false;
+			}
+		}
+
+		for (int i = 0; i < 2; ++i)
+		{
+			if (ls[i]) { ls[i]->Destroy(); delete ls[i]; }
+			delete pK[i];
+		}
+	}
+
+	cerr << (bok ? "Linear solver test passed." : "Linear solver test FAILED.") << endl;
+
+	return bok;
+}
@@ -0,0 +1,214 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#include "stdafx.h"
+#include "FEMatrixFreeTest.h"
+#include <FEBioLib/FEBioModel.h>
+#include <FEBioLib/Logfile.h>
+#include <FEBioMech/FESolidSolver2.h>
+#include <FEBioMech/FEElasticSolidDomain.h>
+#include <FEBioMech/FEElasticMatrixFree.h>
+#include <FECore/FEAnalysis.h>
+#include <FECore/FEGlobalMatrix.h>
+#include <FECore/log.h>
+#include <NumCore/CompactSymmMatrix.h>
+#include <iostream>
+#include <typeinfo>
+#include <math.h>
+using namespace std;
+
+//-----------------------------------------------------------------------------
+// Assemble an element matrix the way the solid solver does, including the
+// contributions of the prescribed dofs to the right-hand side.
+static void AssembleElement(SparseMatrix& K, const matrix& ke, const vector<int>& lm, const vector<double>& u, int nreq, vector<double>& F)
+{
+	K.Assemble(ke, lm);
+
+	const int N = ke.rows();
+	for (int j = 0; j < N; ++j)
+	{
+		int J = -lm[j] - 2;
+		if ((J >= 0) && (J < nreq))
+		{
+			for (int i = 0; i < N; ++i)
+			{
+				if (lm[i] >= 0) F[lm[i]] -= ke[i][j] * u[J];
+			}
+			K.set(J, J, 1);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// returns max|a - b| and sets amax to max|a|
+static double MaxDifference(const vector<double>& a, const vector<double>& b, double& amax)
+{
+	double d = 0.0;
+	amax = 0.0;
+	for (size_t i = 0; i < a.size(); ++i)
+	{
+		amax = max(amax, fabs(a[i]));
+		d = max(d, fabs(a[i] - b[i]));
+	}
+	return d;
+}
+
+//-----------------------------------------------------------------------------
+FEMatrixFreeTest::FEMatrixFreeTest(FEModel* pfem) : FECoreTask(pfem)
+{
+}
+
+//-----------------------------------------------------------------------------
+// initialize the test
+bool FEMatrixFreeTest::Init(const char* sz)
+{
+	FEBioModel& fem = dynamic_cast<FEBioModel&>(*GetFEModel());
+
+	Logfile& log = fem.GetLogFile();
+	log.SetMode(Logfile::MODE::LOG_FILE);
+
+	// do the FE initialization
+	return fem.Init();
+}
+
+//-----------------------------------------------------------------------------
+// run the test
+bool FEMatrixFreeTest::Run()
+{
+	FEModel* fem = GetFEModel();
+
+	// solve the model first, so we have a deformed configuration
+	if (fem->Solve() == false)
+	{
+		feLogEx(fem, "Failed to run model.");
+		return false;
+	}
+
+	FESolidSolver2* solver = dynamic_cast<FESolidSolver2*>(fem->GetCurrentStep()->GetFESolver());
+	if (solver == nullptr)
+	{
+		cerr << "The matrix-free test requires the solid solver." << endl;
+		return false;
+	}
+	const int neq = solver->m_neq;
+	const int nreq = solver->m_nreq;
+	const FETimeInfo& tp = fem->GetTime();
+
+	// random values for the prescribed dofs and for the vector we multiply with
+	vector<double> u(neq), x(neq);
+	unsigned int state = 12345;
+	for (int i = 0; i < neq; ++i)
+	{
+		state = 1664525u * state + 1013904223u;
+		u[i] = 2.0*((double)state / 4294967295.0) - 1.0;
+		state = 1664525u * state + 1013904223u;
+		x[i] = 2.0*((double)state / 4294967295.0) - 1.0;
+	}
+
+	// the assembled reference matrix
+	FEMesh& mesh = fem->GetMesh();
+	FEGlobalMatrix G(new CompactSymmMatrix(0));
+	G.Create(mesh, neq);
+	SparseMatrix& K = *G.GetSparseMatrixPtr();
+	K.Zero();
+
+	// the matrix-free operator
+	FEElasticMatrixFree MF(fem);
+	SparseMatrixProfile MP(neq, neq);
+	MF.Create(MP);
+
+	vector<double> F1(neq, 0.0), F2(neq, 0.0);
+	int ndom = 0;
+	matrix ke;
+	vector<int> lm;
+	for (int n = 0; n < mesh.Domains(); ++n)
+	{
+		FEDomain& d = mesh.Domain(n);
+		if ((d.IsActive() == false) || (typeid(d) != typeid(FEElasticSolidDomain))) continue;
+		FEElasticSolidDomain& dom = static_cast<FEElasticSolidDomain&>(d);
+
+		if (MF.AddDomain(dom, F2, u, nreq) == false) continue;
+		ndom++;
+
+		for (int i = 0; i < dom.Elements(); ++i)
+		{
+			FESolidElement& el = dom.Element(i);
+			if (el.isActive() == false) continue;
+
+			int ndof = 3 * el.Nodes();
+			ke.resize(ndof, ndof);
+			ke.zero();
+			dom.ElementStiffness(tp, i, ke);
+			dom.UnpackLM(el, lm);
+			AssembleElement(K, ke, lm, u, nreq, F1);
+
+			// add some of the element matrices a second time through the assembly
+			// interface, which stores them as separate element matrices
+			if (i % 3 == 0)
+			{
+				K.Assemble(ke, lm);
+				MF.Assemble(ke, lm);
+			}
+		}
+	}
+
+	if (ndom == 0)
+	{
+		cerr << "The model has no domains that can be evaluated matrix-free." << endl;
+		return false;
+	}
+
+	// compare the products with a random vector
+	vector<double> y1(neq, 0.0), y2(neq, 0.0);
+	K.mult_vector(&x[0], &y1[0]);
+	MF.mult_vector(&x[0], &y2[0]);
+
+	double ymax, fmax;
+	double ey = MaxDifference(y1, y2, ymax);
+	double ef = MaxDifference(F1, F2, fmax);
+
+	// compare the diagonals
+	double dmax = 0.0, ed = 0.0;
+	for (int i = 0; i < neq; ++i)
+	{
+		dmax = max(dmax, fabs(K.diag(i)));
+		ed = max(ed, fabs(K.diag(i) - MF.diag(i)));
+	}
+
+	cerr << "equations             = " << neq << endl;
+	cerr << "max |K*x|             = " << ymax << endl;
+	cerr << "max product diff      = " << ey << endl;
+	cerr << "max diagonal diff     = " << ed << endl;
+	cerr << "max prescribed rhs    = " << fmax << endl;
+	cerr << "max rhs diff          = " << ef << endl;
+
+	const double tol = 1e-10;
+	bool success = (ey <= tol*ymax) && (ed <= tol*dmax) && (ef <= tol*fmax);
+	cerr << " --> Matrix-free test " << (success ? "PASSED" : "FAILED") << endl;
+
+	return success;
+}
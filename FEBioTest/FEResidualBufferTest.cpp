@@ -0,0 +1,130 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#include "stdafx.h"
+#include "FEResidualBufferTest.h"
+#include <FEBioLib/FEBioModel.h>
+#include <FEBioLib/Logfile.h>
+#include <FECore/FEAnalysis.h>
+#include <FECore/FESolver.h>
+#include <FECore/log.h>
+#include <iostream>
+#include <math.h>
+using namespace std;
+
+//-----------------------------------------------------------------------------
+FEResidualBufferTest::FEResidualBufferTest(FEModel* pfem) : FECoreTask(pfem)
+{
+}
+
+//-----------------------------------------------------------------------------
+// initialize the test
+bool FEResidualBufferTest::Init(const char* sz)
+{
+	FEBioModel& fem = dynamic_cast<FEBioModel&>(*GetFEModel());
+
+	Logfile& log = fem.GetLogFile();
+	log.SetMode(Logfile::MODE::LOG_FILE);
+
+	// do the FE initialization
+	return fem.Init();
+}
+
+//-----------------------------------------------------------------------------
+bool FEResidualBufferTest::Solve(bool buffers, vector<double>& Fr)
+{
+	FEModel* fem = GetFEModel();
+
+	// set the residual buffers option on all solvers that have it
+	for (int i = 0; i < fem->Steps(); ++i)
+	{
+		FESolver* solver = fem->GetStep(i)->GetFESolver();
+		FEParam* p = (solver ? solver->FindParameter(ParamString("residual_thread_buffers")) : nullptr);
+		if (p == nullptr)
+		{
+			cerr << "The solver of step " << i + 1 << " has no residual_thread_buffers option." << endl;
+			return false;
+		}
+		p->value<bool>() = buffers;
+	}
+
+	if (fem->Solve() == false)
+	{
+		feLogEx(fem, "Failed to run model.");
+		return false;
+	}
+
+	// collect the nodal reaction forces
+	FEMesh& mesh = fem->GetMesh();
+	int ndofs = fem->GetDOFS().GetTotalDOFS();
+	Fr.assign(mesh.Nodes()*ndofs, 0.0);
+	for (int i = 0; i < mesh.Nodes(); ++i)
+	{
+		FENode& node = mesh.Node(i);
+		for (int j = 0; j < ndofs; ++j) Fr[i*ndofs + j] = node.get_load(j);
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// run the test
+bool FEResidualBufferTest::Run()
+{
+	FEModel* fem = GetFEModel();
+
+	// run without the buffers
+	vector<double> Fr1;
+	cerr << "Running model without residual buffers.\n";
+	if (Solve(false, Fr1) == false) return false;
+
+	// reset the model and run it again with the buffers
+	if (fem->Reset() == false)
+	{
+		feLogEx(fem, "Failed to reset model.");
+		return false;
+	}
+
+	vector<double> Fr2;
+	cerr << "Running model with residual buffers.\n";
+	if (Solve(true, Fr2) == false) return false;
+
+	// the forces are only summed in a different order, so they should agree to round-off
+	double fmax = 0.0, emax = 0.0;
+	for (size_t i = 0; i < Fr1.size(); ++i)
+	{
+		fmax = max(fmax, fabs(Fr1[i]));
+		emax = max(emax, fabs(Fr1[i] - Fr2[i]));
+	}
+
+	cerr << "max reaction force = " << fmax << endl;
+	cerr << "max difference     = " << emax << endl;
+	bool success = (emax <= 1e-8*fmax);
+	cerr << " --> Residual buffer test " << (success ? "PASSED" : "FAILED") << endl;
+
+	return success;
+}
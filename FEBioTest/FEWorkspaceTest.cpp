@@ -0,0 +1,171 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#include "stdafx.h"
+#include "FEWorkspaceTest.h"
+#include <FEBioLib/FEBioModel.h>
+#include <FEBioLib/Logfile.h>
+#include <FEBioMech/FEElasticDomain.h>
+#include <FECore/FEAnalysis.h>
+#include <FECore/FEDomain.h>
+#include <FECore/FESolver.h>
+#include <FECore/FEGlobalVector.h>
+#include <FECore/FEGlobalMatrix.h>
+#include <FECore/FELinearSystem.h>
+#include <FECore/log.h>
+#include <NumCore/CompactSymmMatrix.h>
+#include <iostream>
+#include <stdlib.h>
+#include <new>
+using namespace std;
+
+//-----------------------------------------------------------------------------
+// The global allocation functions are replaced so that the test can count the
+// heap allocations. Counting is only enabled while the test is measuring.
+static volatile bool count_allocations = false;
+static int heap_allocations = 0;
+
+void* operator new(size_t size)
+{
+	if (count_allocations)
+	{
+#pragma omp atomic
+		heap_allocations++;
+	}
+	void* p = malloc(size > 0 ? size : 1);
+	if (p == nullptr) throw std::bad_alloc();
+	return p;
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* p) noexcept
+{
+	free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+	free(p);
+}
+
+//-----------------------------------------------------------------------------
+FEWorkspaceTest::FEWorkspaceTest(FEModel* pfem) : FECoreTask(pfem)
+{
+}
+
+//-----------------------------------------------------------------------------
+// initialize the test
+bool FEWorkspaceTest::Init(const char* sz)
+{
+	FEBioModel& fem = dynamic_cast<FEBioModel&>(*GetFEModel());
+
+	Logfile& log = fem.GetLogFile();
+	log.SetMode(Logfile::MODE::LOG_FILE);
+
+	// count the allocations after each converged time step
+	fem.AddCallback(Callback, CB_MAJOR_ITERS, this);
+
+	// do the FE initialization
+	return fem.Init();
+}
+
+//-----------------------------------------------------------------------------
+bool FEWorkspaceTest::Callback(FEModel* fem, unsigned int nwhen, void* pd)
+{
+	FEWorkspaceTest* test = (FEWorkspaceTest*)pd;
+	test->m_allocs.push_back(test->CountAllocations());
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+int FEWorkspaceTest::CountAllocations()
+{
+	FEModel* fem = GetFEModel();
+	FESolver* solver = fem->GetCurrentStep()->GetFESolver();
+	FEMesh& mesh = fem->GetMesh();
+	int neq = solver->m_neq;
+
+	// setup the global vector and matrix
+	vector<double> R(neq, 0.0), Fr(neq, 0.0), F(neq, 0.0), u(neq, 0.0);
+	FEGlobalVector RHS(*fem, R, Fr);
+	FEGlobalMatrix K(new CompactSymmMatrix(0));
+	K.Create(mesh, neq);
+	K.Zero();
+	FELinearSystem LS(solver, K, F, u, true);
+
+	// assemble all the elastic domains
+	heap_allocations = 0;
+	count_allocations = true;
+	for (int i = 0; i < mesh.Domains(); ++i)
+	{
+		FEElasticDomain* dom = dynamic_cast<FEElasticDomain*>(&mesh.Domain(i));
+		if (dom && mesh.Domain(i).IsActive())
+		{
+			dom->InternalForces(RHS);
+			dom->StiffnessMatrix(LS);
+		}
+	}
+	count_allocations = false;
+
+	return heap_allocations;
+}
+
+//-----------------------------------------------------------------------------
+// run the test
+bool FEWorkspaceTest::Run()
+{
+	FEModel* fem = GetFEModel();
+
+	m_allocs.clear();
+	if (fem->Solve() == false)
+	{
+		feLogEx(fem, "Failed to run model.");
+		return false;
+	}
+
+	if (m_allocs.empty())
+	{
+		cerr << "The workspace test needs at least one time step." << endl;
+		return false;
+	}
+
+	// The assembly should not allocate once the first time step has converged.
+	cerr << "time steps            = " << m_allocs.size() << endl;
+	bool success = true;
+	for (size_t i = 0; i < m_allocs.size(); ++i)
+	{
+		cerr << "allocations (step " << i + 1 << ")  = " << m_allocs[i] << endl;
+		if (m_allocs[i] != 0) success = false;
+	}
+	cerr << " --> Workspace test " << (success ? "PASSED" : "FAILED") << endl;
+
+	return success;
+}
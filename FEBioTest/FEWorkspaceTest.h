@@ -0,0 +1,58 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#pragma once
+#include <FECore/FECoreTask.h>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// This task solves the model and, after each converged time step, counts the
+// heap allocations during one evaluation of the internal forces and stiffness
+// matrix of all the elastic domains. Since the element matrices and vectors are 
+// taken from the element workspaces (see FEElementWorkspace), these assembly 
+// loops should not allocate any memory once the model is running.
+class FEWorkspaceTest : public FECoreTask
+{
+public:
+	// constructor
+	FEWorkspaceTest(FEModel* pfem);
+
+	// initialize the test
+	bool Init(const char* sz) override;
+
+	// run the test
+	bool Run() override;
+
+private:
+	static bool Callback(FEModel* fem, unsigned int nwhen, void* pd);
+
+	// count the heap allocations of one assembly of the elastic domains
+	int CountAllocations();
+
+private:
+	std::vector<int>	m_allocs;	//!< nr of heap allocations after each time step
+};
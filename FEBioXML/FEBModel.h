@@ -211,6 +211,7 @@ public:
 		int Domains() const { return (int)m_Dom.size(); }
 		void AddDomain(Domain* dom);
 		const Domain& GetDomain(int i) const { return *m_Dom[i]; }
+		Domain& GetDomain(int i) { return *m_Dom[i]; }
 		Domain* FindDomain(const string& name);
 
 		int Surfaces() const { return (int) m_Surf.size(); }
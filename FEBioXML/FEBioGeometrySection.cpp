@@ -1183,10 +1183,6 @@ void FEBioGeometrySection25::ParseNodeSection(XMLTag& tag)
 	int max_id = 0;
 	if (N0 > 0) max_id = mesh.Node(N0 - 1).GetID();
 
-	// first we need to figure out how many nodes there are
-	XMLTag t(tag);
-	int nodes = tag.children();
-
 	// see if this list defines a set
 	const char* szl = tag.AttributeValue("name", true);
 	FENodeSet* ps = 0;
@@ -1198,30 +1194,63 @@ void FEBioGeometrySection25::ParseNodeSection(XMLTag& tag)
 		mesh.AddNodeSet(ps);
 	}
 
-	// resize node's array
-	mesh.AddNodes(nodes);
-
-	// read nodal coordinates
-	++tag;
-	for (int i = 0; i<nodes; ++i)
+	// try the fast path first
+	int nodes = 0;
+	vector<FEBModel::NODE> nodeList;
+	if (ReadNodeBlock(tag, nodeList))
 	{
-		FENode& node = mesh.Node(N0 + i);
-		value(tag, node.m_r0);
-		node.m_rt = node.m_r0;
+		// resize node's array
+		nodes = (int)nodeList.size();
+		mesh.AddNodes(nodes);
 
-		// get the nodal ID
-		int nid = -1;
-		tag.AttributeValue("id", nid);
+		for (int i = 0; i<nodes; ++i)
+		{
+			FENode& node = mesh.Node(N0 + i);
+			node.m_r0 = nodeList[i].r;
+			node.m_rt = node.m_r0;
 
-		// Make sure it is valid
-		if (nid <= max_id) throw XMLReader::InvalidAttributeValue(tag, "id");
+			// Make sure the ID is valid
+			int nid = nodeList[i].id;
+			if (nid <= max_id) throw XMLReader::InvalidAttributeValue(tag, "id");
 
-		// set the ID
-		node.SetID(nid);
-		max_id = nid;
+			// set the ID
+			node.SetID(nid);
+			max_id = nid;
+		}
 
-		// go on to the next node
+		// read the end tag
+		++tag;
+	}
+	else
+	{
+		// first we need to figure out how many nodes there are
+		nodes = tag.children();
+
+		// resize node's array
+		mesh.AddNodes(nodes);
+
+		// read nodal coordinates
 		++tag;
+		for (int i = 0; i<nodes; ++i)
+		{
+			FENode& node = mesh.Node(N0 + i);
+			value(tag, node.m_r0);
+			node.m_rt = node.m_r0;
+
+			// get the nodal ID
+			int nid = -1;
+			tag.AttributeValue("id", nid);
+
+			// Make sure it is valid
+			if (nid <= max_id) throw XMLReader::InvalidAttributeValue(tag, "id");
+
+			// set the ID
+			node.SetID(nid);
+			max_id = nid;
+
+			// go on to the next node
+			++tag;
+		}
 	}
 
 	// If a node set is defined add these nodes to the node-set
@@ -1242,10 +1271,6 @@ void FEBioGeometrySection25::ParsePartNodeSection(XMLTag& tag, FEBModel::Part* p
 	FEMesh& mesh = fem.GetMesh();
 	int N0 = mesh.Nodes();
 
-	// first we need to figure out how many nodes there are
-	XMLTag t(tag);
-	int nodes = tag.children();
-
 	// see if this list defines a set
 	const char* szname = tag.AttributeValue("name", true);
 	FEBModel::NodeSet* ps = 0;
@@ -1255,25 +1280,38 @@ void FEBioGeometrySection25::ParsePartNodeSection(XMLTag& tag, FEBModel::Part* p
 		part->AddNodeSet(ps);
 	}
 
-	// allocate node
-	vector<FEBModel::NODE> node(nodes);
-	vector<int> nodeList(nodes);
-
-	// read nodal coordinates
-	++tag;
-	for (int i = 0; i<nodes; ++i)
+	// try the fast path first
+	vector<FEBModel::NODE> node;
+	if (ReadNodeBlock(tag, node))
 	{
-		FEBModel::NODE& nd = node[i];
-		value(tag, nd.r);
-
-		// get the nodal ID
-		tag.AttributeValue("id", nd.id);
-		nodeList[i] = nd.id;
+		// read the end tag
+		++tag;
+	}
+	else
+	{
+		// first we need to figure out how many nodes there are
+		int nodes = tag.children();
+		node.resize(nodes);
 
-		// go on to the next node
+		// read nodal coordinates
 		++tag;
+		for (int i = 0; i<nodes; ++i)
+		{
+			FEBModel::NODE& nd = node[i];
+			value(tag, nd.r);
+
+			// get the nodal ID
+			tag.AttributeValue("id", nd.id);
+
+			// go on to the next node
+			++tag;
+		}
 	}
 
+	int nodes = (int)node.size();
+	vector<int> nodeList(nodes);
+	for (int i = 0; i < nodes; ++i) nodeList[i] = node[i].id;
+
 	// add nodes to the part
 	part->AddNodes(node);
 
@@ -1334,21 +1372,43 @@ void FEBioGeometrySection25::ParseElementSection(XMLTag& tag)
 	}
 
 	// count elements
-	vector<FEModelBuilder::ELEMENT> elemList; elemList.reserve(512000);
-	++tag;
-	do
-	{
-		if ((tag == "elem") == false) throw XMLReader::InvalidTag(tag);
+	vector<FEModelBuilder::ELEMENT> elemList;
 
-		// get the element ID
-		FEModelBuilder::ELEMENT el;
-		tag.AttributeValue("id", el.nid);
+	// try the fast path first
+	vector<FEBModel::ELEMENT> elem;
+	vector<int> nodeCount;
+	if (ReadElementBlock(tag, elem, &nodeCount))
+	{
+		elemList.resize(elem.size());
+		for (size_t i = 0; i < elem.size(); ++i)
+		{
+			FEModelBuilder::ELEMENT& el = elemList[i];
+			el.nid = elem[i].id;
+			el.nodes = nodeCount[i];
+			for (int j = 0; j < el.nodes; ++j) el.node[j] = elem[i].node[j];
+		}
 
-		el.nodes = tag.value(el.node, FEElement::MAX_NODES);
-		elemList.push_back(el);
+		// read the end tag
 		++tag;
 	}
-	while (!tag.isend());
+	else
+	{
+		elemList.reserve(512000);
+		++tag;
+		do
+		{
+			if ((tag == "elem") == false) throw XMLReader::InvalidTag(tag);
+
+			// get the element ID
+			FEModelBuilder::ELEMENT el;
+			tag.AttributeValue("id", el.nid);
+
+			el.nodes = tag.value(el.node, FEElement::MAX_NODES);
+			elemList.push_back(el);
+			++tag;
+		}
+		while (!tag.isend());
+	}
 
 	int elems = (int) elemList.size();
 	assert(elems);
@@ -1424,12 +1484,7 @@ void FEBioGeometrySection25::ParsePartElementSection(XMLTag& tag, FEBModel::Part
 	if (szname) dom->SetName(szname);
 	if (szmat) dom->SetMaterialName(szmat);
 
-	// count elements
-	int elems = tag.children();
-	assert(elems);
-
 	// add domain it to the mesh
-	dom->Create(elems);
 	part->AddDomain(dom);
 
 	// for named domains, we'll also create an element set
@@ -1440,25 +1495,46 @@ void FEBioGeometrySection25::ParsePartElementSection(XMLTag& tag, FEBModel::Part
 		part->AddElementSet(pg);
 	}
 
-	vector<int> elemList(elems);
+	vector<int> elemList;
 
-	// read element data
-	++tag;
-	for (int i = 0; i<elems; ++i)
+	// try the fast path first
+	vector<FEBModel::ELEMENT> elem;
+	if (ReadElementBlock(tag, elem))
 	{
-		if ((tag == "elem") == false) throw XMLReader::InvalidTag(tag);
+		int elems = (int)elem.size();
+		elemList.resize(elems);
+		for (int i = 0; i < elems; ++i) elemList[i] = elem[i].id;
+		dom->SetElementList(elem);
+
+		// read the end tag
+		++tag;
+	}
+	else
+	{
+		// count elements
+		int elems = tag.children();
+		assert(elems);
+		dom->Create(elems);
+		elemList.resize(elems);
 
-		FEBModel::ELEMENT& el = dom->GetElement(i);
+		// read element data
+		++tag;
+		for (int i = 0; i<elems; ++i)
+		{
+			if ((tag == "elem") == false) throw XMLReader::InvalidTag(tag);
 
-		// get the element ID
-		tag.AttributeValue("id", el.id);
-		elemList[i] = el.id;
+			FEBModel::ELEMENT& el = dom->GetElement(i);
 
-		// read the element data
-		tag.value(el.node, FEElement::MAX_NODES);
+			// get the element ID
+			tag.AttributeValue("id", el.id);
+			elemList[i] = el.id;
 
-		// go to next tag
-		++tag;
+			// read the element data
+			tag.value(el.node, FEElement::MAX_NODES);
+
+			// go to next tag
+			++tag;
+		}
 	}
 
 	// set the element list
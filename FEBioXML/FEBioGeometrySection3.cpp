@@ -275,10 +275,6 @@ void FEBioGeometrySection3::ParseNodeSection(XMLTag& tag)
 	int max_id = 0;
 	if (N0 > 0) max_id = mesh.Node(N0 - 1).GetID();
 
-	// first we need to figure out how many nodes there are
-	XMLTag t(tag);
-	int nodes = tag.children();
-
 	// see if this list defines a set
 	const char* szl = tag.AttributeValue("name", true);
 	FENodeSet* ps = 0;
@@ -290,31 +286,64 @@ void FEBioGeometrySection3::ParseNodeSection(XMLTag& tag)
 		mesh.AddNodeSet(ps);
 	}
 
-	// resize node's array
-	mesh.AddNodes(nodes);
-
-	// read nodal coordinates
-	++tag;
-	for (int i = 0; i<nodes; ++i)
+	// try the fast path first
+	int nodes = 0;
+	vector<FEBModel::NODE> nodeList;
+	if (ReadNodeBlock(tag, nodeList))
 	{
-		FENode& node = mesh.Node(N0 + i);
-		value(tag, node.m_r0);
-		node.m_rt = node.m_r0;
+		// resize node's array
+		nodes = (int)nodeList.size();
+		mesh.AddNodes(nodes);
 
-		// get the nodal ID
-		int nid = -1;
-		tag.AttributeValue("id", nid);
+		for (int i = 0; i<nodes; ++i)
+		{
+			FENode& node = mesh.Node(N0 + i);
+			node.m_r0 = nodeList[i].r;
+			node.m_rt = node.m_r0;
 
-		// Make sure it is valid
-		if (nid <= max_id) throw XMLReader::InvalidAttributeValue(tag, "id");
+			// Make sure the ID is valid
+			int nid = nodeList[i].id;
+			if (nid <= max_id) throw XMLReader::InvalidAttributeValue(tag, "id");
 
-		// set the ID
-		node.SetID(nid);
-		max_id = nid;
+			// set the ID
+			node.SetID(nid);
+			max_id = nid;
+		}
 
-		// go on to the next node
+		// read the end tag
 		++tag;
 	}
+	else
+	{
+		// first we need to figure out how many nodes there are
+		nodes = tag.children();
+
+		// resize node's array
+		mesh.AddNodes(nodes);
+
+		// read nodal coordinates
+		++tag;
+		for (int i = 0; i<nodes; ++i)
+		{
+			FENode& node = mesh.Node(N0 + i);
+			value(tag, node.m_r0);
+			node.m_rt = node.m_r0;
+
+			// get the nodal ID
+			int nid = -1;
+			tag.AttributeValue("id", nid);
+
+			// Make sure it is valid
+			if (nid <= max_id) throw XMLReader::InvalidAttributeValue(tag, "id");
+
+			// set the ID
+			node.SetID(nid);
+			max_id = nid;
+
+			// go on to the next node
+			++tag;
+		}
+	}
 
 	// If a node set is defined add these nodes to the node-set
 	if (ps)
@@ -334,10 +363,6 @@ void FEBioGeometrySection3::ParsePartNodeSection(XMLTag& tag, FEBModel::Part* pa
 	FEMesh& mesh = fem.GetMesh();
 	int N0 = mesh.Nodes();
 
-	// first we need to figure out how many nodes there are
-	XMLTag t(tag);
-	int nodes = tag.children();
-
 	// see if this list defines a set
 	const char* szname = tag.AttributeValue("name", true);
 	FEBModel::NodeSet* ps = 0;
@@ -347,25 +372,38 @@ void FEBioGeometrySection3::ParsePartNodeSection(XMLTag& tag, FEBModel::Part* pa
 		part->AddNodeSet(ps);
 	}
 
-	// allocate node
-	vector<FEBModel::NODE> node(nodes);
-	vector<int> nodeList(nodes);
-
-	// read nodal coordinates
-	++tag;
-	for (int i = 0; i<nodes; ++i)
+	// try the fast path first
+	vector<FEBModel::NODE> node;
+	if (ReadNodeBlock(tag, node))
 	{
-		FEBModel::NODE& nd = node[i];
-		value(tag, nd.r);
-
-		// get the nodal ID
-		tag.AttributeValue("id", nd.id);
-		nodeList[i] = nd.id;
+		// read the end tag
+		++tag;
+	}
+	else
+	{
+		// first we need to figure out how many nodes there are
+		int nodes = tag.children();
+		node.resize(nodes);
 
-		// go on to the next node
+		// read nodal coordinates
 		++tag;
+		for (int i = 0; i<nodes; ++i)
+		{
+			FEBModel::NODE& nd = node[i];
+			value(tag, nd.r);
+
+			// get the nodal ID
+			tag.AttributeValue("id", nd.id);
+
+			// go on to the next node
+			++tag;
+		}
 	}
 
+	int nodes = (int)node.size();
+	vector<int> nodeList(nodes);
+	for (int i = 0; i < nodes; ++i) nodeList[i] = node[i].id;
+
 	// add nodes to the part
 	part->AddNodes(node);
 
@@ -495,12 +533,7 @@ void FEBioGeometrySection3::ParsePartElementSection(XMLTag& tag, FEBModel::Part*
 	if (szname) dom->SetName(szname);
 	if (szmat) dom->SetMaterialName(szmat);
 
-	// count elements
-	int elems = tag.children();
-	assert(elems);
-
 	// add domain it to the mesh
-	dom->Create(elems);
 	part->AddDomain(dom);
 
 	// for named domains, we'll also create an element set
@@ -511,23 +544,44 @@ void FEBioGeometrySection3::ParsePartElementSection(XMLTag& tag, FEBModel::Part*
 		part->AddElementSet(pg);
 	}
 
-	vector<int> elemList(elems);
+	vector<int> elemList;
 
-	// read element data
-	++tag;
-	for (int i = 0; i<elems; ++i)
+	// try the fast path first
+	vector<FEBModel::ELEMENT> elem;
+	if (ReadElementBlock(tag, elem))
 	{
-		FEBModel::ELEMENT& el = dom->GetElement(i);
-
-		// get the element ID
-		tag.AttributeValue("id", el.id);
-		elemList[i] = el.id;
+		int elems = (int)elem.size();
+		elemList.resize(elems);
+		for (int i = 0; i < elems; ++i) elemList[i] = elem[i].id;
+		dom->SetElementList(elem);
 
-		// read the element data
-		tag.value(el.node, FEElement::MAX_NODES);
+		// read the end tag
+		++tag;
+	}
+	else
+	{
+		// count elements
+		int elems = tag.children();
+		assert(elems);
+		dom->Create(elems);
+		elemList.resize(elems);
 
-		// go to next tag
+		// read element data
 		++tag;
+		for (int i = 0; i<elems; ++i)
+		{
+			FEBModel::ELEMENT& el = dom->GetElement(i);
+
+			// get the element ID
+			tag.AttributeValue("id", el.id);
+			elemList[i] = el.id;
+
+			// read the element data
+			tag.value(el.node, FEElement::MAX_NODES);
+
+			// go to next tag
+			++tag;
+		}
 	}
 
 	// set the element list
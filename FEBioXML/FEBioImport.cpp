@@ -63,11 +63,62 @@ SOFTWARE.*/
 #include <string.h>
 #include <stdarg.h>
 #include "xmltool.h"
+#include "XMLBlockReader.h"
 
 FEBioFileSection::FEBioFileSection(FEBioImport* feb) : FEFileSection(feb) {}
 
 FEBioImport* FEBioFileSection::GetFEBioImport() { return static_cast<FEBioImport*>(GetFileReader()); }
 
+//-----------------------------------------------------------------------------
+bool FEBioFileSection::ReadNodeBlock(XMLTag& tag, std::vector<FEBModel::NODE>& nodes)
+{
+	XMLBlockReader block;
+	if (block.Read(tag, "node") == false) return false;
+
+	const int N = block.Records();
+	nodes.resize(N);
+
+	bool bok = true;
+#pragma omp parallel for shared(bok) if (N > 10000)
+	for (int i = 0; i < N; ++i)
+	{
+		FEBModel::NODE& nd = nodes[i];
+		double r[3];
+		int nread = 0;
+		if ((block.GetRecord(i, nd.id, r, 3, nread) == false) || (nread != 3)) bok = false;
+		else nd.r = vec3d(r[0], r[1], r[2]);
+	}
+	if (bok == false) { nodes.clear(); return false; }
+
+	block.Finish(tag);
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool FEBioFileSection::ReadElementBlock(XMLTag& tag, std::vector<FEBModel::ELEMENT>& elems, std::vector<int>* nodeCount)
+{
+	XMLBlockReader block;
+	if (block.Read(tag, "elem") == false) return false;
+
+	const int N = block.Records();
+	elems.resize(N);
+	if (nodeCount) nodeCount->resize(N);
+
+	bool bok = true;
+#pragma omp parallel for shared(bok) if (N > 10000)
+	for (int i = 0; i < N; ++i)
+	{
+		FEBModel::ELEMENT& el = elems[i];
+		int nread = 0;
+		if (block.GetRecord(i, el.id, el.node, FEElement::MAX_NODES, nread) == false) bok = false;
+		if (nodeCount) (*nodeCount)[i] = nread;
+	}
+	if (bok == false) { elems.clear(); return false; }
+
+	block.Finish(tag);
+	return true;
+}
+
 //-----------------------------------------------------------------------------
 FEBioImport::InvalidVersion::InvalidVersion()
 {
@@ -244,6 +295,12 @@ void FEBioImport::BuildFileSectionMap(int nversion)
 	}
 }
 
+//-----------------------------------------------------------------------------
+bool FEBioImport::m_useMeshCache = false;
+
+void FEBioImport::SetMeshCache(bool b) { m_useMeshCache = b; }
+bool FEBioImport::UseMeshCache() { return m_useMeshCache; }
+
 //-----------------------------------------------------------------------------
 bool FEBioImport::Load(FEModel& fem, const char* szfile)
 {
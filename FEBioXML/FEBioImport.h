@@ -50,6 +50,14 @@ public:
 	FEBioFileSection(FEBioImport* feb);
 
 	FEBioImport* GetFEBioImport();
+
+protected:
+	// Fast paths for reading the records of large Nodes and Elements sections.
+	// These return false if the section cannot be read this way, in which case the 
+	// tag is not modified and the regular tag-by-tag parsing should be used. 
+	// On success, the tag is positioned so that the next ++tag reads the end tag.
+	bool ReadNodeBlock(XMLTag& tag, std::vector<FEBModel::NODE>& nodes);
+	bool ReadElementBlock(XMLTag& tag, std::vector<FEBModel::ELEMENT>& elems, std::vector<int>* nodeCount = nullptr);
 };
 
 //=============================================================================
@@ -159,6 +167,13 @@ public:
 
 	void AddDataRecord(DataRecord* pd);
 
+public:
+	// Enable the binary mesh cache. When enabled, the content of the Mesh section 
+	// is stored in a binary file next to the input file, which is read instead of
+	// the Mesh section on subsequent runs, as long as the Mesh section is unchanged.
+	static void SetMeshCache(bool b);
+	static bool UseMeshCache();
+
 public:
 	// Helper functions for reading node sets, surfaces, etc.
 	FENodeSet* ParseNodeSet(XMLTag& tag, const char* szatt = "set");
@@ -176,4 +191,7 @@ public:
 
 public:
 	vector<DataRecord*>		m_data;
+
+private:
+	static bool	m_useMeshCache;
 };
@@ -0,0 +1,334 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#include "stdafx.h"
+#include "FEBioMeshCache.h"
+
+//-----------------------------------------------------------------------------
+// header of the cache file
+struct MESH_CACHE_HEADER
+{
+	char		magic[8];	// magic identifier
+	int			version;	// cache version
+	int			maxNodes;	// FEElement::MAX_NODES (determines size of element records)
+	int			elemSize;	// size of element records
+	int			faceSize;	// size of facet records
+	uint64_t	hash;		// hash of Mesh section content
+};
+
+static const char mesh_cache_magic[8] = { 'F', 'E', 'B', 'M', 'E', 'S', 'H', 0 };
+
+//-----------------------------------------------------------------------------
+FEBioMeshCache::FEBioMeshCache(const char* szinputfile)
+{
+	m_fileName = std::string(szinputfile) + ".mcache";
+	m_fp = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+// 64-bit FNV-1a hash
+uint64_t FEBioMeshCache::Hash(const char* sz, size_t n)
+{
+	uint64_t h = 14695981039346656037ULL;
+	for (size_t i = 0; i < n; ++i)
+	{
+		h ^= (unsigned char)sz[i];
+		h *= 1099511628211ULL;
+	}
+	return h;
+}
+
+//-----------------------------------------------------------------------------
+void FEBioMeshCache::write(const void* pd, size_t size, size_t count)
+{
+	if (fwrite(pd, size, count, m_fp) != count) throw std::runtime_error("error writing mesh cache");
+}
+
+//-----------------------------------------------------------------------------
+void FEBioMeshCache::write(const std::string& s)
+{
+	write((int)s.size());
+	if (s.empty() == false) write(s.c_str(), 1, s.size());
+}
+
+//-----------------------------------------------------------------------------
+void FEBioMeshCache::read(void* pd, size_t size, size_t count)
+{
+	if (fread(pd, size, count, m_fp) != count) throw std::runtime_error("error reading mesh cache");
+}
+
+//-----------------------------------------------------------------------------
+void FEBioMeshCache::read(std::string& s)
+{
+	int n = read_int();
+	if (n < 0) throw std::runtime_error("invalid mesh cache");
+	s.resize(n);
+	if (n > 0) read(&s[0], 1, n);
+}
+
+//-----------------------------------------------------------------------------
+bool FEBioMeshCache::Write(FEBModel::Part& part, const std::vector<std::string>& elemType, uint64_t hash)
+{
+	if ((int)elemType.size() != part.Domains()) return false;
+
+	// We write to a temporary file first and then move it into place, so that
+	// a concurrent run never sees a partially written cache.
+	std::string tmpName = m_fileName + ".tmp";
+	m_fp = fopen(tmpName.c_str(), "wb");
+	if (m_fp == nullptr) return false;
+
+	bool bok = true;
+	try
+	{
+		MESH_CACHE_HEADER hdr;
+		memset(&hdr, 0, sizeof(hdr));
+		memcpy(hdr.magic, mesh_cache_magic, 8);
+		hdr.version  = CACHE_VERSION;
+		hdr.maxNodes = FEElement::MAX_NODES;
+		hdr.elemSize = sizeof(FEBModel::ELEMENT);
+		hdr.faceSize = sizeof(FEBModel::FACET);
+		hdr.hash     = hash;
+		write(&hdr, sizeof(hdr), 1);
+
+		// nodes
+		int NN = part.Nodes();
+		write(NN);
+		if (NN > 0) write(&part.GetNode(0), sizeof(FEBModel::NODE), NN);
+
+		// domains
+		write(part.Domains());
+		for (int i = 0; i < part.Domains(); ++i)
+		{
+			const FEBModel::Domain& dom = part.GetDomain(i);
+			write(dom.Name());
+			write(dom.MaterialName());
+			write(elemType[i]);
+			write(&dom.m_defaultShellThickness, sizeof(double), 1);
+			write(dom.ElementList());
+		}
+
+		// node sets
+		write(part.NodeSets());
+		for (int i = 0; i < part.NodeSets(); ++i)
+		{
+			FEBModel::NodeSet* nset = part.GetNodeSet(i);
+			write(nset->Name());
+			write(nset->NodeList());
+		}
+
+		// element sets
+		write(part.ElementSets());
+		for (int i = 0; i < part.ElementSets(); ++i)
+		{
+			FEBModel::ElementSet* eset = part.GetElementSet(i);
+			write(eset->Name());
+			write(eset->ElementList());
+		}
+
+		// surfaces
+		write(part.Surfaces());
+		for (int i = 0; i < part.Surfaces(); ++i)
+		{
+			FEBModel::Surface* surf = part.GetSurface(i);
+			write(surf->Name());
+			write(surf->FacetList());
+		}
+
+		// surface pairs
+		write(part.SurfacePairs());
+		for (int i = 0; i < part.SurfacePairs(); ++i)
+		{
+			FEBModel::SurfacePair* sp = part.GetSurfacePair(i);
+			write(sp->m_name);
+			write(sp->m_primary);
+			write(sp->m_secondary);
+		}
+
+		// discrete sets
+		write(part.DiscreteSets());
+		for (int i = 0; i < part.DiscreteSets(); ++i)
+		{
+			FEBModel::DiscreteSet* dset = part.GetDiscreteSet(i);
+			write(dset->Name());
+			write(dset->ElementList());
+		}
+	}
+	catch (...)
+	{
+		bok = false;
+	}
+
+	if (fclose(m_fp) != 0) bok = false;
+	m_fp = nullptr;
+
+	// don't leave an invalid cache file behind
+	if (bok == false)
+	{
+		remove(tmpName.c_str());
+		return false;
+	}
+
+	// move the cache file into place
+#ifdef WIN32
+	// rename fails on Windows if the destination exists
+	remove(m_fileName.c_str());
+#endif
+	if (rename(tmpName.c_str(), m_fileName.c_str()) != 0)
+	{
+		remove(tmpName.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool FEBioMeshCache::Read(FEBModel::Part& part, std::vector<std::string>& elemType, uint64_t hash)
+{
+	m_fp = fopen(m_fileName.c_str(), "rb");
+	if (m_fp == nullptr) return false;
+
+	bool bok = true;
+	try
+	{
+		// make sure the cache is valid
+		MESH_CACHE_HEADER hdr;
+		read(&hdr, sizeof(hdr), 1);
+		if ((memcmp(hdr.magic, mesh_cache_magic, 8) != 0) ||
+			(hdr.version  != CACHE_VERSION) ||
+			(hdr.maxNodes != FEElement::MAX_NODES) ||
+			(hdr.elemSize != sizeof(FEBModel::ELEMENT)) ||
+			(hdr.faceSize != sizeof(FEBModel::FACET)) ||
+			(hdr.hash != hash)) throw std::runtime_error("invalid mesh cache");
+
+		// nodes
+		std::vector<FEBModel::NODE> nodes;
+		read(nodes);
+		part.AddNodes(nodes);
+
+		// domains
+		int ND = read_int();
+		if (ND < 0) throw std::runtime_error("invalid mesh cache");
+		elemType.resize(ND);
+		for (int i = 0; i < ND; ++i)
+		{
+			std::string name, matName;
+			read(name);
+			read(matName);
+			read(elemType[i]);
+
+			// the element spec is set by the caller
+			FEBModel::Domain* dom = new FEBModel::Domain;
+			part.AddDomain(dom);
+
+			dom->SetName(name);
+			dom->SetMaterialName(matName);
+			read(&dom->m_defaultShellThickness, sizeof(double), 1);
+
+			std::vector<FEBModel::ELEMENT> elems;
+			read(elems);
+			dom->SetElementList(elems);
+		}
+
+		// node sets
+		int NS = read_int();
+		for (int i = 0; i < NS; ++i)
+		{
+			std::string name;
+			read(name);
+			std::vector<int> nodeList;
+			read(nodeList);
+
+			FEBModel::NodeSet* nset = new FEBModel::NodeSet(name);
+			nset->SetNodeList(nodeList);
+			part.AddNodeSet(nset);
+		}
+
+		// element sets
+		int NE = read_int();
+		for (int i = 0; i < NE; ++i)
+		{
+			std::string name;
+			read(name);
+			std::vector<int> elemList;
+			read(elemList);
+
+			FEBModel::ElementSet* eset = new FEBModel::ElementSet(name);
+			eset->SetElementList(elemList);
+			part.AddElementSet(eset);
+		}
+
+		// surfaces
+		int NF = read_int();
+		for (int i = 0; i < NF; ++i)
+		{
+			std::string name;
+			read(name);
+			std::vector<FEBModel::FACET> faces;
+			read(faces);
+
+			FEBModel::Surface* surf = new FEBModel::Surface(name);
+			surf->SetFacetList(faces);
+			part.AddSurface(surf);
+		}
+
+		// surface pairs
+		int NP = read_int();
+		for (int i = 0; i < NP; ++i)
+		{
+			FEBModel::SurfacePair* sp = new FEBModel::SurfacePair;
+			part.AddSurfacePair(sp);
+			read(sp->m_name);
+			read(sp->m_primary);
+			read(sp->m_secondary);
+		}
+
+		// discrete sets
+		int NDS = read_int();
+		for (int i = 0; i < NDS; ++i)
+		{
+			std::string name;
+			read(name);
+			std::vector<FEBModel::DiscreteSet::ELEM> elems;
+			read(elems);
+
+			FEBModel::DiscreteSet* dset = new FEBModel::DiscreteSet;
+			dset->SetName(name);
+			for (size_t j = 0; j < elems.size(); ++j) dset->AddElement(elems[j].node[0], elems[j].node[1]);
+			part.AddDiscreteSet(dset);
+		}
+	}
+	catch (...)
+	{
+		bok = false;
+	}
+
+	fclose(m_fp);
+	m_fp = nullptr;
+
+	return bok;
+}
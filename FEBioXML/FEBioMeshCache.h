@@ -0,0 +1,88 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#pragma once
+#include "FEBModel.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdexcept>
+
+//-----------------------------------------------------------------------------
+// The mesh cache is a binary file that is stored next to the input file and 
+// holds the part that was generated from the Mesh section (nodes, element 
+// connectivity, node sets, element sets, surfaces, etc.). It is keyed by a hash 
+// of the raw content of the Mesh section, so that on subsequent runs with the 
+// same mesh, the (expensive) parsing of the Mesh section can be skipped.
+// The domains store the element type string instead of the element spec, since
+// the latter depends on the state of the model builder.
+class FEBioMeshCache
+{
+	enum { CACHE_VERSION = 2 };
+
+public:
+	FEBioMeshCache(const char* szinputfile);
+
+	// the name of the cache file
+	const std::string& FileName() const { return m_fileName; }
+
+	// try to read the part from the cache. Returns false if the cache doesn't 
+	// exist, or if it's content is out of date.
+	// The element type strings of the domains are returned in elemType.
+	bool Read(FEBModel::Part& part, std::vector<std::string>& elemType, uint64_t hash);
+
+	// write the part to the cache
+	bool Write(FEBModel::Part& part, const std::vector<std::string>& elemType, uint64_t hash);
+
+public:
+	// calculate the hash of a buffer
+	static uint64_t Hash(const char* sz, size_t n);
+
+private:
+	void write(const void* pd, size_t size, size_t count);
+	void write(int n) { write(&n, sizeof(int), 1); }
+	void write(const std::string& s);
+	template <class T> void write(const std::vector<T>& v)
+	{
+		write((int)v.size());
+		if (v.empty() == false) write(&v[0], sizeof(T), v.size());
+	}
+
+	void read(void* pd, size_t size, size_t count);
+	int  read_int() { int n = 0; read(&n, sizeof(int), 1); return n; }
+	void read(std::string& s);
+	template <class T> void read(std::vector<T>& v)
+	{
+		int n = read_int();
+		if (n < 0) throw std::runtime_error("invalid mesh cache");
+		v.resize(n);
+		if (n > 0) read(&v[0], sizeof(T), n);
+	}
+
+private:
+	std::string		m_fileName;
+	FILE*			m_fp;
+};
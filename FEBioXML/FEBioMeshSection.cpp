@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #include "stdafx.h"
 #include "FEBioMeshSection.h"
+#include "FEBioMeshCache.h"
 #include <FECore/FESolidDomain.h>
 #include <FECore/FEShellDomain.h>
 #include <FECore/FETrussDomain.h>
@@ -36,6 +37,7 @@ SOFTWARE.*/
 #include <FEBioMech/FEElasticMaterial.h>
 #include <FECore/FECoreKernel.h>
 #include <FECore/FENodeNodeList.h>
+#include <FECore/log.h>
 #include <sstream>
 
 //-----------------------------------------------------------------------------
@@ -52,7 +54,46 @@ void FEBioMeshSection::Parse(XMLTag& tag)
 	//       all lists will be given the name: partname.listname
 	FEBModel& feb = builder->GetFEBModel();
 	assert(feb.Parts() == 0);
+
+	// see if we can read the mesh from the cache
+	bool bcache = FEBioImport::UseMeshCache();
+	uint64_t hash = 0;
+	if (bcache)
+	{
+		XMLReader& xml = *tag.m_preader;
+		FEBioMeshCache cache(xml.GetFileName());
+
+		vector<char> buf;
+		if (xml.ReadContent(tag, buf) && (buf.empty() == false))
+		{
+			hash = FEBioMeshCache::Hash(&buf[0], buf.size());
+
+			FEBModel::Part* part = new FEBModel::Part("");
+			if (cache.Read(*part, m_elemType, hash))
+			{
+				// The element spec is not cached, since it depends on the state of the 
+				// model builder (e.g. integration rules set in the Control section), and 
+				// ElementSpec may in turn modify that state (e.g. for ut4 or q4eas).
+				for (int i = 0; i < part->Domains(); ++i)
+				{
+					FE_Element_Spec espec = builder->ElementSpec(m_elemType[i].c_str());
+					if (FEElementLibrary::IsValid(espec) == false) { delete part; throw FEBioImport::InvalidElementType(); }
+					part->GetDomain(i).SetElementSpec(espec);
+				}
+				feb.AddPart(part);
+
+				// skip to the end of the Mesh section
+				xml.SkipContent(tag, &buf[0], buf.size());
+				++tag;
+				return;
+			}
+			delete part;
+		}
+		else bcache = false;
+	}
+
 	FEBModel::Part* part = feb.AddPart("");
+	m_elemType.clear();
 
 	// read all sections
 	++tag;
@@ -70,6 +111,16 @@ void FEBioMeshSection::Parse(XMLTag& tag)
 		++tag;
 	}
 	while (!tag.isend());
+
+	// update the cache
+	if (bcache)
+	{
+		FEBioMeshCache cache(tag.m_preader->GetFileName());
+		if (cache.Write(*part, m_elemType, hash) == false)
+		{
+			feLogWarningEx(GetFEModel(), "Failed writing mesh cache %s", cache.FileName().c_str());
+		}
+	}
 }
 
 //-----------------------------------------------------------------------------
@@ -90,27 +141,41 @@ void FEBioMeshSection::ParseNodeSection(XMLTag& tag, FEBModel::Part* part)
 	}
 
 	// allocate node
+	vector<FEBModel::NODE> node;
+	vector<int> nodeList;
 
-	vector<FEBModel::NODE> node; node.reserve(10000);
-	vector<int> nodeList; nodeList.reserve(10000);
+	// try the fast path first
+	if (ReadNodeBlock(tag, node))
+	{
+		nodeList.resize(node.size());
+		for (size_t i = 0; i < node.size(); ++i) nodeList[i] = node[i].id;
 
-	// read nodal coordinates
-	++tag;
-	do {
-		// nodal coordinates
-		FEBModel::NODE nd;
-		value(tag, nd.r);
+		// read the end tag
+		++tag;
+	}
+	else
+	{
+		node.reserve(10000);
+		nodeList.reserve(10000);
 
-		// get the nodal ID
-		tag.AttributeValue("id", nd.id);
+		// read nodal coordinates
+		++tag;
+		do {
+			// nodal coordinates
+			FEBModel::NODE nd;
+			value(tag, nd.r);
 
-		// add it to the pile
-		node.push_back(nd);
-		nodeList.push_back(nd.id);
+			// get the nodal ID
+			tag.AttributeValue("id", nd.id);
 
-		// go on to the next node
-		++tag;
-	} while (!tag.isend());
+			// add it to the pile
+			node.push_back(nd);
+			nodeList.push_back(nd.id);
+
+			// go on to the next node
+			++tag;
+		} while (!tag.isend());
+	}
 
 	// add nodes to the part
 	part->AddNodes(node);
@@ -153,6 +218,7 @@ void FEBioMeshSection::ParseElementSection(XMLTag& tag, FEBModel::Part* part)
 
 	// add domain it to the mesh
 	part->AddDomain(dom);
+	m_elemType.push_back(sztype);
 
 	// for named domains, we'll also create an element set
 	FEBModel::ElementSet* pg = 0;
@@ -162,27 +228,43 @@ void FEBioMeshSection::ParseElementSection(XMLTag& tag, FEBModel::Part* part)
 		part->AddElementSet(pg);
 	}
 
-	dom->Reserve(10000);
-	vector<int> elemList; elemList.reserve(10000);
+	vector<int> elemList;
+
+	// try the fast path first
+	vector<FEBModel::ELEMENT> elem;
+	if (ReadElementBlock(tag, elem))
+	{
+		elemList.resize(elem.size());
+		for (size_t i = 0; i < elem.size(); ++i) elemList[i] = elem[i].id;
+		dom->SetElementList(elem);
 
-	// read element data
-	++tag;
-	do
+		// read the end tag
+		++tag;
+	}
+	else
 	{
-		FEBModel::ELEMENT el;
+		dom->Reserve(10000);
+		elemList.reserve(10000);
 
-		// get the element ID
-		tag.AttributeValue("id", el.id);
+		// read element data
+		++tag;
+		do
+		{
+			FEBModel::ELEMENT el;
 
-		// read the element data
-		tag.value(el.node, FEElement::MAX_NODES);
+			// get the element ID
+			tag.AttributeValue("id", el.id);
 
-		dom->AddElement(el);
-		elemList.push_back(el.id);
+			// read the element data
+			tag.value(el.node, FEElement::MAX_NODES);
 
-		// go to next tag
-		++tag;
-	} while (!tag.isend());
+			dom->AddElement(el);
+			elemList.push_back(el.id);
+
+			// go to next tag
+			++tag;
+		} while (!tag.isend());
+	}
 
 	// set the element list
 	if (pg) pg->SetElementList(elemList);
@@ -48,6 +48,9 @@ protected:
 	void ParseEdgeSection       (XMLTag& tag, FEBModel::Part* part);
 	void ParseSurfacePairSection(XMLTag& tag, FEBModel::Part* part);
 	void ParseDiscreteSetSection(XMLTag& tag, FEBModel::Part* part);
+
+private:
+	vector<string>	m_elemType;	// element type string of each domain (needed by the mesh cache)
 };
 
 //-----------------------------------------------------------------------------
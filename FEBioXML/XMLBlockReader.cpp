@@ -0,0 +1,283 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#include "stdafx.h"
+#include "XMLBlockReader.h"
+#include <math.h>
+
+//-----------------------------------------------------------------------------
+// helper functions for scanning the buffer
+inline bool is_space(char c) { return ((c == ' ') || (c == '\t') || (c == '\n') || (c == '\r')); }
+inline bool is_digit(char c) { return ((c >= '0') && (c <= '9')); }
+inline const char* skip_space(const char* sz) { while (is_space(*sz)) sz++; return sz; }
+
+//-----------------------------------------------------------------------------
+// Parse an integer. Returns the pointer to the first character after the number,
+// or zero if no valid integer was found.
+static const char* scan_int(const char* sz, int& n)
+{
+	bool neg = false;
+	if      (*sz == '-') { neg = true; sz++; }
+	else if (*sz == '+') sz++;
+	if (!is_digit(*sz)) return 0;
+
+	long long v = 0;
+	int ndig = 0;
+	while (is_digit(*sz)) { v = 10 * v + (*sz++ - '0'); ndig++; }
+	if (ndig > 10) return 0;
+	if (neg) v = -v;
+	if ((v > 2147483647LL) || (v < -2147483647LL)) return 0;
+	n = (int)v;
+	return sz;
+}
+
+//-----------------------------------------------------------------------------
+// Parse a floating point number. For numbers that can be represented exactly by 
+// the mantissa and a small power of ten, the result is computed directly (which is
+// correctly rounded). Otherwise, we fall back to strtod. Either way, the result is
+// identical to what atof would return.
+static const char* scan_double(const char* sz, double& d)
+{
+	static const double p10[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+	bool neg = false;
+	if      (*sz == '-') { neg = true; sz++; }
+	else if (*sz == '+') sz++;
+	const char* sz0 = sz;
+
+	unsigned long long m = 0;
+	int ndig = 0, nexp = 0;
+	bool bdig = false;
+	while (is_digit(*sz))
+	{
+		if ((m == 0) && (*sz == '0')) { sz++; bdig = true; continue; }
+		if (ndig < 19) { m = 10 * m + (*sz - '0'); ndig++; } else nexp++;
+		sz++; bdig = true;
+	}
+	if (*sz == '.')
+	{
+		sz++;
+		while (is_digit(*sz))
+		{
+			if ((m == 0) && (*sz == '0')) { nexp--; sz++; bdig = true; continue; }
+			if (ndig < 19) { m = 10 * m + (*sz - '0'); ndig++; nexp--; }
+			sz++; bdig = true;
+		}
+	}
+	if (bdig == false) return 0;
+
+	if ((*sz == 'e') || (*sz == 'E'))
+	{
+		int e = 0;
+		const char* sze = scan_int(sz + 1, e);
+		if (sze == 0) return 0;
+		nexp += e;
+		sz = sze;
+	}
+
+	if (m == 0) d = 0.0;
+	else if ((ndig <= 15) && (nexp >= -22) && (nexp <= 22))
+	{
+		d = (double)m;
+		if (nexp < 0) d /= p10[-nexp]; else d *= p10[nexp];
+	}
+	else d = strtod(sz0, 0);
+
+	if (neg) d = -d;
+	return sz;
+}
+
+//-----------------------------------------------------------------------------
+XMLBlockReader::XMLBlockReader()
+{
+}
+
+//-----------------------------------------------------------------------------
+bool XMLBlockReader::Read(XMLTag& tag, const char* szname)
+{
+	m_rec.clear();
+	m_name = szname;
+	if (tag.m_preader->ReadContent(tag, m_buf) == false) return false;
+
+	// we store offsets as ints
+	if (m_buf.size() >= 2147483647) return false;
+
+	// zero-terminate the buffer, so we don't have to check for overruns while parsing
+	const int N = (int) m_buf.size();
+	m_buf.push_back(0);
+
+	// find the start of all records
+	m_rec.reserve(N / 64);
+	const char* sz = &m_buf[0];
+	int i = 0;
+	while (i < N)
+	{
+		const char* ch = (const char*)memchr(sz + i, '<', N - i);
+		if (ch == 0) break;
+		i = (int)(ch - sz);
+
+		if (ch[1] == '/')
+		{
+			// end tag
+			ch = (const char*)memchr(ch, '>', N - i);
+			if (ch == 0) return false;
+		}
+		else if (strncmp(ch, "<!--", 4) == 0)
+		{
+			// comment
+			ch = strstr(ch + 4, "-->");
+			if (ch == 0) return false;
+			ch += 2;
+		}
+		else if ((ch[1] == '!') || (ch[1] == '?')) return false;
+		else
+		{
+			// start of a record
+			m_rec.push_back(i);
+			ch = (const char*)memchr(ch, '>', N - i);
+			if (ch == 0) return false;
+		}
+
+		i = (int)(ch - sz) + 1;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Parse a record's start tag. Returns a pointer to the first character of the 
+// record's value. 
+const char* XMLBlockReader::ParseStartTag(const char* sz, int& id) const
+{
+	// check the tag name
+	sz++;
+	const int l = (int) m_name.size();
+	if ((strncmp(sz, m_name.c_str(), l) != 0) || ((sz[l] != '>') && !is_space(sz[l]))) return 0;
+	sz += l;
+
+	// read the attributes
+	bool bid = false;
+	while (true)
+	{
+		sz = skip_space(sz);
+		if (*sz == '>') break;
+
+		// attribute name
+		const char* sza = sz;
+		while (*sz && (*sz != '=') && !is_space(*sz) && (*sz != '>') && (*sz != '/')) sz++;
+		int la = (int)(sz - sza);
+		if (la == 0) return 0;
+
+		sz = skip_space(sz);
+		if (*sz != '=') return 0;
+		sz = skip_space(sz + 1);
+
+		// attribute value
+		char quot = *sz;
+		if ((quot != '"') && (quot != '\'')) return 0;
+		sz++;
+		if ((la == 2) && (strncmp(sza, "id", 2) == 0))
+		{
+			sz = scan_int(skip_space(sz), id);
+			if (sz == 0) return 0;
+			sz = skip_space(sz);
+			if (*sz != quot) return 0;
+			bid = true;
+		}
+		else
+		{
+			while (*sz && (*sz != quot)) sz++;
+			if (*sz == 0) return 0;
+		}
+		sz++;
+	}
+
+	return (bid ? sz + 1 : 0);
+}
+
+//-----------------------------------------------------------------------------
+// Parse a record's end tag. 
+const char* XMLBlockReader::ParseEndTag(const char* sz) const
+{
+	if ((sz[0] != '<') || (sz[1] != '/')) return 0;
+	sz += 2;
+	const int l = (int)m_name.size();
+	if (strncmp(sz, m_name.c_str(), l) != 0) return 0;
+	sz = skip_space(sz + l);
+	return (*sz == '>' ? sz + 1 : 0);
+}
+
+//-----------------------------------------------------------------------------
+bool XMLBlockReader::GetRecord(int i, int& id, double* v, int nmax, int& nread) const
+{
+	nread = 0;
+	const char* sz = ParseStartTag(&m_buf[m_rec[i]], id);
+	if (sz == 0) return false;
+
+	sz = skip_space(sz);
+	while (*sz != '<')
+	{
+		if (nread >= nmax) return false;
+		sz = scan_double(sz, v[nread++]);
+		if (sz == 0) return false;
+		sz = skip_space(sz);
+		if (*sz == ',') sz = skip_space(sz + 1);
+		else if (*sz != '<') return false;
+	}
+
+	return (ParseEndTag(sz) != 0);
+}
+
+//-----------------------------------------------------------------------------
+bool XMLBlockReader::GetRecord(int i, int& id, int* v, int nmax, int& nread) const
+{
+	nread = 0;
+	const char* sz = ParseStartTag(&m_buf[m_rec[i]], id);
+	if (sz == 0) return false;
+
+	sz = skip_space(sz);
+	while (*sz != '<')
+	{
+		if (nread >= nmax) return false;
+		sz = scan_int(sz, v[nread++]);
+		if (sz == 0) return false;
+		sz = skip_space(sz);
+		if (*sz == ',') sz = skip_space(sz + 1);
+		else if (*sz != '<') return false;
+	}
+
+	return (ParseEndTag(sz) != 0);
+}
+
+//-----------------------------------------------------------------------------
+void XMLBlockReader::Finish(XMLTag& tag)
+{
+	// the buffer was zero-terminated, so don't count the last character
+	tag.m_preader->SkipContent(tag, &m_buf[0], m_buf.size() - 1);
+}
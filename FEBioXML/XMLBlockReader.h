@@ -0,0 +1,76 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#pragma once
+#include "XMLReader.h"
+#include <vector>
+
+//-----------------------------------------------------------------------------
+//! This class implements a fast reader for large blocks of simple records, i.e. 
+//! child elements of the form
+//!
+//!   <name id="n">v0,v1,...,vn</name>
+//!
+//! such as the nodes and elements of the Mesh section. The content of the parent
+//! tag is read in one pass, after which the individual records are indexed so that
+//! they can be parsed independently (and in parallel). Numbers are parsed without
+//! going through the (locale-dependent) C-runtime conversion functions.
+//! If the block contains anything else than these simple records (e.g. entity
+//! references or empty tags), the reader will fail and the caller should fall back
+//! to the regular XMLTag-based parsing.
+class FEBIOXML_API XMLBlockReader
+{
+public:
+	XMLBlockReader();
+
+	//! Read the content of the (parent) tag and index all the records.
+	//! All records must have the tag name szname. 
+	//! The tag is not modified. 
+	bool Read(XMLTag& tag, const char* szname);
+
+	//! number of records
+	int Records() const { return (int)m_rec.size(); }
+
+	//! Parse a record. This returns the id attribute and the record's values. The
+	//! number of values that were read is returned in nread. If a record has more 
+	//! than nmax values, false is returned. These functions are thread-safe.
+	bool GetRecord(int i, int& id, double* v, int nmax, int& nread) const;
+	bool GetRecord(int i, int& id, int*    v, int nmax, int& nread) const;
+
+	//! Advance the tag to the end of the block, so that the next call to NextTag
+	//! will read the parent's end tag. 
+	void Finish(XMLTag& tag);
+
+private:
+	const char* ParseStartTag(const char* sz, int& id) const;
+	const char* ParseEndTag(const char* sz) const;
+
+private:
+	std::vector<char>	m_buf;		//!< raw content of parent tag
+	std::vector<int>	m_rec;		//!< offset of each record into m_buf
+	std::string			m_name;		//!< the record tag name
+};
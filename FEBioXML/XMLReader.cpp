@@ -430,6 +430,7 @@ void XMLReader::Close()
 	}
 
 	m_fp = 0;
+	m_szfile.clear();
 	m_nline = 0;
 	m_bufIndex = 0;
 	m_bufSize = 0;
@@ -446,6 +447,7 @@ bool XMLReader::Open(const char* szfile)
 	// open the file
 	m_fp = fopen(szfile, "rb");
 	if (m_fp == 0) return false;
+	m_szfile = szfile;
 
 	// read the first line
 	char szline[256] = {0};
@@ -950,3 +952,74 @@ void XMLReader::SkipTag(XMLTag& tag)
 
 	++tag;
 }
+
+//-----------------------------------------------------------------------------
+//! Read the raw content of a tag into a buffer. This reads all the text between
+//! the tag's current file position and its end tag in large chunks, bypassing
+//! the character-by-character processing of NextTag. This is used for reading
+//! large blocks of data (e.g. the Nodes and Elements sections) more efficiently.
+//! The tag must not be a leaf. The end tag itself is not included in the buffer,
+//! so advancing the tag's file position by the buffer size will position the tag
+//! at its end tag.
+bool XMLReader::ReadContent(XMLTag& tag, std::vector<char>& buf)
+{
+	assert(tag.m_preader == this);
+	buf.clear();
+	if (tag.isleaf() || tag.isend()) return false;
+
+	// the end tag we're looking for
+	string endTag = string("</") + tag.m_sztag;
+	const size_t l = endTag.size();
+
+	// go to the start of the content
+	fseek(m_fp, tag.m_fpos, SEEK_SET);
+	m_currentPos = tag.m_fpos;
+	m_bufSize = m_bufIndex = 0;
+	m_eof = false;
+
+	const size_t CHUNK_SIZE = 4 * 1024 * 1024;
+	size_t nsize = 0, nsearch = 0;
+	while (true)
+	{
+		// read the next chunk
+		buf.resize(nsize + CHUNK_SIZE);
+		size_t nread = fread(&buf[nsize], 1, CHUNK_SIZE, m_fp);
+		m_currentPos += nread;
+		nsize += nread;
+
+		// look for the end tag
+		const char* sz = &buf[0];
+		while (nsearch + l < nsize)
+		{
+			const char* ch = (const char*) memchr(sz + nsearch, '<', nsize - nsearch);
+			if (ch == 0) { nsearch = nsize; break; }
+
+			nsearch = ch - sz;
+			if (nsearch + l >= nsize) break;
+
+			if ((strncmp(ch, endTag.c_str(), l) == 0) && ((ch[l] == '>') || isspace(ch[l])))
+			{
+				buf.resize(nsearch);
+				return true;
+			}
+			nsearch++;
+		}
+
+		// if we reached the end of the file, the end tag is missing
+		if (nread != CHUNK_SIZE)
+		{
+			buf.clear();
+			return false;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+void XMLReader::SkipContent(XMLTag& tag, const char* sz, size_t n)
+{
+	int nlines = 0;
+	for (size_t i = 0; i < n; ++i) if (sz[i] == '\n') nlines++;
+
+	tag.m_fpos += n;
+	tag.m_ncurrent_line += nlines;
+}
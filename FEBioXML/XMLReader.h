@@ -244,6 +244,17 @@ public:
 	//! Skip a tag
 	void SkipTag(XMLTag& tag);
 
+	//! Read the raw content of a tag (i.e. all text up to its end tag) into a buffer.
+	//! The tag itself is not modified.
+	bool ReadContent(XMLTag& tag, std::vector<char>& buf);
+
+	//! Advance the tag over the content (of size n) that was read with ReadContent, 
+	//! so that the next call to NextTag reads the tag's end tag.
+	void SkipContent(XMLTag& tag, const char* sz, size_t n);
+
+	//! return the name of the file that was opened
+	const char* GetFileName() const { return m_szfile.c_str(); }
+
 protected: // helper functions
 
 	//! Get the next character in the file
@@ -269,6 +280,7 @@ protected: // helper functions
 
 protected:
 	FILE*	m_fp;			//!< the file pointer
+	string	m_szfile;		//!< the file name
 	int		m_nline;		//!< current line (used only as temp storage)
     int64_t	m_currentPos;	//!< current file position
 
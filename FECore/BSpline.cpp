@@ -122,8 +122,65 @@ double BSpline::eval(double x, int korder, std::vector<double>xknot,
 // evaluate B-spline at x using de Boor algorithm (de Boor 1986)
 double BSpline::eval(double x)
 {
-    std::vector<double> coeff = m_coeff;
-    return eval(x,m_korder, m_xknot, m_ncoef, coeff);
+    int span = -1;
+    return eval(x, span);
+}
+
+//--------------------------------------------------------------------------------
+// locate the knot interval that encloses x
+int BSpline::find_span(double x, int guess) const
+{
+    // try the guess and the interval that follows it first, since the spline
+    // is usually evaluated at nearby points
+    if ((guess >= m_korder-1) && (guess < m_ncoef))
+    {
+        for (int j=guess; (j<m_ncoef) && (j<=guess+1); ++j)
+        {
+            if ((m_xknot[j] <= x) && ((j == m_ncoef-1) || (x < m_xknot[j+1]))) return j;
+        }
+    }
+
+    // perform binary search
+    int j = m_korder-1, jh = m_ncoef;
+    while (jh - j > 1) {
+        int jm = (j+jh)/2;
+        if ((m_xknot[j] <= x) && (x < m_xknot[jm]))
+            jh = jm;
+        else
+            j = jm;
+    }
+    return j;
+}
+
+//--------------------------------------------------------------------------------
+// evaluate B-spline at x using de Boor algorithm (de Boor 1986)
+// Only the korder coefficients that support the knot interval are copied.
+double BSpline::eval(double x, int& span) const
+{
+    if (m_korder < 1) return 0.0;
+
+    int j = span = find_span(x, span);
+
+    // d[k] stores coefficient j-korder+1+k
+    const int MAX_ORDER = 16;
+    double buf[MAX_ORDER];
+    std::vector<double> tmp;
+    double* d = buf;
+    if (m_korder > MAX_ORDER) { tmp.resize(m_korder); d = &tmp[0]; }
+    int j0 = j - m_korder + 1;
+    for (int k=0; k<m_korder; ++k) d[k] = m_coeff[j0 + k];
+
+    double w;
+    for (int r=0; r<m_korder-1; ++r) {
+        for (int i=j; i>j-m_korder+r+1; --i) {
+            if (m_xknot[i] != m_xknot[i+m_korder-r-1])
+                w = (x - m_xknot[i])/(m_xknot[i+m_korder-r-1] - m_xknot[i]);
+            else
+                w = 0;
+            d[i-j0] = (1-w)*d[i-j0-1] + w*d[i-j0];
+        }
+    }
+    return d[j-j0];
 }
 
 //--------------------------------------------------------------------------------
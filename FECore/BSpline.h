@@ -46,6 +46,11 @@ public:
     double eval(double x, int korder, std::vector<double>xknot,
                 int ncoef, std::vector<double>coeff);
     double eval(double x);
+    // evaluate at x, using span as a guess for the knot interval that contains x
+    // (or -1 if unknown). On return span is the interval that was used.
+    double eval(double x, int& span) const;
+    // find the knot interval that contains x. The guess is tested first.
+    int find_span(double x, int guess = -1) const;
     double eval_nderiv(double x, int n);
     double eval_deriv(double x) { return eval_nderiv(x, 1); }
     double eval_deriv2(double x) { return eval_nderiv(x, 2); }
@@ -28,10 +28,37 @@ SOFTWARE.*/
 
 #include "stdafx.h"
 #include "DumpFile.h"
+#include "sys.h"
+#include <string.h>
+
+#ifdef HAVE_ZLIB
+#include "zlib.h"
+#endif
+
+// identifiers for chunked archives
+static const char DMP_MAGIC[8] = { 'F', 'E', 'B', 'I', 'O', 'D', 'M', 'P' };
+static const char IDX_MAGIC[8] = { 'F', 'E', 'B', 'I', 'O', 'I', 'D', 'X' };
+static const unsigned int DMP_VERSION = 1;
+
+// default chunk size (uncompressed)
+static const size_t DMP_CHUNK_SIZE = 4194304;	// = 4M
 
 DumpFile::DumpFile(FEModel& fem) : DumpStream(fem)
 {
 	m_fp = 0;
+	m_bchunked = false;
+#ifdef HAVE_ZLIB
+	m_bcompress = true;
+#else
+	m_bcompress = false;
+#endif
+	m_chunkSize = DMP_CHUNK_SIZE;
+	m_nchunks = 0;
+	m_ncurrent = 0;
+	m_pos = 0;
+	m_beof = false;
+	m_bwriteError = false;
+	m_offset = 0;
 }
 
 DumpFile::~DumpFile()
@@ -39,11 +66,54 @@ DumpFile::~DumpFile()
 	Close();
 }
 
+void DumpFile::SetChunkSize(size_t chunkSize)
+{
+	assert(m_fp == 0);
+	if (chunkSize > 0) m_chunkSize = chunkSize;
+}
+
+// allocate the chunks that are processed in parallel
+void DumpFile::InitBatch()
+{
+	int nthreads = omp_get_max_threads();
+	if (nthreads < 1) nthreads = 1;
+	m_batch.resize(nthreads);
+	m_nchunks = 0;
+	m_ncurrent = 0;
+	m_pos = 0;
+	m_beof = false;
+	m_index.clear();
+}
+
 bool DumpFile::Open(const char* szfile)
 {
 	m_fp = fopen(szfile, "rb");
 	if (m_fp == 0) return false;
 
+	// see if this is a chunked archive
+	char magic[8] = { 0 };
+	unsigned int version = 0, flags = 0;
+	size_t nread = fread(magic, 1, 8, m_fp);
+	if ((nread == 8) && (memcmp(magic, DMP_MAGIC, 8) == 0))
+	{
+		fread(&version, sizeof(version), 1, m_fp);
+		fread(&flags, sizeof(flags), 1, m_fp);
+		if (version != DMP_VERSION) { Close(); return false; }
+#ifndef HAVE_ZLIB
+		// we can't read compressed archives without zlib
+		if (flags & 1) { Close(); return false; }
+#endif
+		m_bchunked = true;
+		m_bcompress = ((flags & 1) != 0);
+		InitBatch();
+	}
+	else
+	{
+		// assume this is a raw archive
+		m_bchunked = false;
+		rewind(m_fp);
+	}
+
 	DumpStream::Open(false, false);
 
 	return true;
@@ -54,6 +124,24 @@ bool DumpFile::Create(const char* szfile)
 	m_fp = fopen(szfile, "wb");
 	if (m_fp == 0) return false;
 
+	m_bwriteError = false;
+
+	// write the header
+	unsigned int version = DMP_VERSION;
+	unsigned int flags = (m_bcompress ? 1 : 0);
+	if ((fwrite_all(DMP_MAGIC, 1, 8) == false) ||
+		(fwrite_all(&version, sizeof(version), 1) == false) ||
+		(fwrite_all(&flags, sizeof(flags), 1) == false))
+	{
+		Close();
+		return false;
+	}
+	m_offset = 8 + sizeof(version) + sizeof(flags);
+
+	m_bchunked = true;
+	InitBatch();
+	m_batch[0].raw.resize(m_chunkSize);
+
 	DumpStream::Open(true, false);
 
 	return true;
@@ -64,34 +152,263 @@ bool DumpFile::Append(const char* szfile)
 	m_fp = fopen(szfile, "a+b");
 	if (m_fp == 0) return false;
 
+	// we can only append raw data
+	m_bchunked = false;
+	m_bwriteError = false;
+
 	DumpStream::Open(true, false);
 
 	return true;
 }
 
-void DumpFile::Close()
+bool DumpFile::Close()
 {
-	if (m_fp) fclose(m_fp); 
+	bool bsaving = (m_fp && IsSaving());
+	if (m_fp && m_bchunked && IsSaving())
+	{
+		// write remaining data
+		WriteChunks(true);
+
+		// write the end-of-stream marker
+		unsigned int eos[2] = { 0, 0 };
+		fwrite_all(eos, sizeof(unsigned int), 2);
+		long long indexOffset = m_offset + 2*sizeof(unsigned int);
+
+		// write the chunk index
+		unsigned int nchunks = (unsigned int) m_index.size();
+		fwrite_all(&nchunks, sizeof(nchunks), 1);
+		for (size_t i = 0; i < m_index.size(); ++i)
+		{
+			ChunkInfo& ci = m_index[i];
+			fwrite_all(&ci.offset, sizeof(ci.offset), 1);
+			fwrite_all(&ci.rawSize, sizeof(ci.rawSize), 1);
+			fwrite_all(&ci.bufSize, sizeof(ci.bufSize), 1);
+		}
+		fwrite_all(&indexOffset, sizeof(indexOffset), 1);
+		fwrite_all(IDX_MAGIC, 1, 8);
+	}
+
+	// fclose flushes the stream, which can fail as well
+	if (m_fp && (fclose(m_fp) != 0) && bsaving) m_bwriteError = true;
 	m_fp = 0;
+	m_bchunked = false;
+	m_batch.clear();
+	m_index.clear();
+
+	return (m_bwriteError == false);
+}
+
+// write to the file and record a failure
+bool DumpFile::fwrite_all(const void* pd, size_t size, size_t count)
+{
+	if (m_bwriteError) return false;
+	if (fwrite(pd, size, count, m_fp) != count) m_bwriteError = true;
+	return (m_bwriteError == false);
+}
+
+void DumpFile::Flush()
+{
+	if (m_bchunked && IsSaving()) WriteChunks(true);
+	fflush(m_fp);
 }
 
 //! write buffer to archive
 size_t DumpFile::write(const void* pd, size_t size, size_t count)
 {
 	assert(IsSaving());
-	int elemsWritten = fwrite(pd, size, count, m_fp);
-	return size * elemsWritten;
+	if (m_bchunked == false)
+	{
+		size_t elemsWritten = fwrite(pd, size, count, m_fp);
+		if (elemsWritten != count) m_bwriteError = true;
+		return size * elemsWritten;
+	}
+
+	// data that cannot be written is not reported as written
+	if (m_bwriteError) return 0;
+
+	// copy the data into the current chunk
+	const unsigned char* pc = (const unsigned char*) pd;
+	size_t nsize = size*count;
+	while (nsize > 0)
+	{
+		Chunk& chunk = m_batch[m_nchunks];
+		size_t nblock = m_chunkSize - m_pos;
+		if (nblock > nsize) nblock = nsize;
+		memcpy(&chunk.raw[m_pos], pc, nblock);
+		m_pos += nblock;
+		pc += nblock;
+		nsize -= nblock;
+
+		// start a new chunk when this one is full
+		if (m_pos == m_chunkSize)
+		{
+			chunk.rawSize = (unsigned int) m_pos;
+			m_nchunks++;
+			m_pos = 0;
+
+			// compress and write the batch when all chunks are filled
+			if (WriteChunks(false) == false) return 0;
+			if (m_batch[m_nchunks].raw.size() < m_chunkSize) m_batch[m_nchunks].raw.resize(m_chunkSize);
+		}
+	}
+
+	return size*count;
+}
+
+// Compress the filled chunks in parallel and write them to file.
+// If bflush is true, the current partially filled chunk is written as well.
+// Returns false if the data could not be written.
+bool DumpFile::WriteChunks(bool bflush)
+{
+	if (bflush && (m_pos > 0))
+	{
+		m_batch[m_nchunks].rawSize = (unsigned int) m_pos;
+		m_nchunks++;
+		m_pos = 0;
+	}
+
+	// wait until all chunks in the batch are filled
+	if ((bflush == false) && (m_nchunks < (int)m_batch.size())) return true;
+	if (m_nchunks == 0) return (m_bwriteError == false);
+
+	// compress chunks
+	int nchunks = m_nchunks;
+#pragma omp parallel for
+	for (int i = 0; i < nchunks; ++i)
+	{
+		Chunk& chunk = m_batch[i];
+		chunk.bufSize = chunk.rawSize;
+#ifdef HAVE_ZLIB
+		if (m_bcompress)
+		{
+			uLongf n = compressBound(chunk.rawSize);
+			if (chunk.buf.size() < n) chunk.buf.resize(n);
+			if ((compress2(&chunk.buf[0], &n, &chunk.raw[0], chunk.rawSize, Z_BEST_SPEED) == Z_OK) && (n < chunk.rawSize))
+				chunk.bufSize = (unsigned int) n;
+		}
+#endif
+	}
+
+	// write chunks in order
+	for (int i = 0; i < nchunks; ++i)
+	{
+		Chunk& chunk = m_batch[i];
+		ChunkInfo ci = { m_offset, chunk.rawSize, chunk.bufSize };
+		m_index.push_back(ci);
+
+		// uncompressed chunks are stored as is
+		const unsigned char* pd = (chunk.bufSize < chunk.rawSize ? &chunk.buf[0] : &chunk.raw[0]);
+		fwrite_all(&chunk.rawSize, sizeof(unsigned int), 1);
+		fwrite_all(&chunk.bufSize, sizeof(unsigned int), 1);
+		fwrite_all(pd, 1, chunk.bufSize);
+		m_offset += 2*sizeof(unsigned int) + chunk.bufSize;
+	}
+	m_nchunks = 0;
+
+	return (m_bwriteError == false);
+}
+
+// Read the next batch of chunks and decompress them in parallel.
+// Returns false if no more data is available.
+bool DumpFile::ReadChunks()
+{
+	m_nchunks = 0;
+	m_ncurrent = 0;
+	m_pos = 0;
+	if (m_beof) return false;
+
+	// read the stored data sequentially
+	for (int i = 0; i < (int)m_batch.size(); ++i)
+	{
+		Chunk& chunk = m_batch[i];
+		unsigned int sizes[2];
+		if (fread(sizes, sizeof(unsigned int), 2, m_fp) != 2) { m_beof = true; break; }
+		if (sizes[0] == 0) { m_beof = true; break; }
+		chunk.rawSize = sizes[0];
+		chunk.bufSize = sizes[1];
+		std::vector<unsigned char>& trg = (chunk.bufSize < chunk.rawSize ? chunk.buf : chunk.raw);
+		if (trg.size() < chunk.bufSize) trg.resize(chunk.bufSize);
+		if (fread(&trg[0], 1, chunk.bufSize, m_fp) != chunk.bufSize) throw DumpStream::ReadError();
+		m_nchunks++;
+	}
+	if (m_nchunks == 0) return false;
+
+	// check for the end-of-stream marker so that EndOfStream is accurate
+	if (m_beof == false)
+	{
+		unsigned int sizes[2];
+		if (fread(sizes, sizeof(unsigned int), 2, m_fp) != 2) m_beof = true;
+		else if (sizes[0] == 0) m_beof = true;
+		else fseek(m_fp, -(long)(2*sizeof(unsigned int)), SEEK_CUR);
+	}
+
+	// decompress
+	bool bok = true;
+	int nchunks = m_nchunks;
+#pragma omp parallel for shared(bok)
+	for (int i = 0; i < nchunks; ++i)
+	{
+		Chunk& chunk = m_batch[i];
+		if (chunk.bufSize < chunk.rawSize)
+		{
+#ifdef HAVE_ZLIB
+			if (chunk.raw.size() < chunk.rawSize) chunk.raw.resize(chunk.rawSize);
+			uLongf n = chunk.rawSize;
+			if ((uncompress(&chunk.raw[0], &n, &chunk.buf[0], chunk.bufSize) != Z_OK) || (n != chunk.rawSize)) bok = false;
+#else
+			bok = false;
+#endif
+		}
+	}
+	if (bok == false) throw DumpStream::ReadError();
+
+	return true;
 }
 
 //! read buffer from archive
 size_t DumpFile::read(void* pd, size_t size, size_t count)
 {
 	assert(IsLoading());
-	int elemsRead = fread(pd, size, count, m_fp);
-	return size * elemsRead;
+	if (m_bchunked == false)
+	{
+		int elemsRead = fread(pd, size, count, m_fp);
+		return size * elemsRead;
+	}
+
+	unsigned char* pc = (unsigned char*) pd;
+	size_t nsize = size*count;
+	size_t nread = 0;
+	while (nsize > 0)
+	{
+		// get the next chunk if we've read all data of the current one
+		if ((m_ncurrent >= m_nchunks) || (m_pos >= m_batch[m_ncurrent].rawSize))
+		{
+			if (m_ncurrent < m_nchunks) { m_ncurrent++; m_pos = 0; }
+			if ((m_ncurrent >= m_nchunks) && (ReadChunks() == false)) break;
+		}
+
+		Chunk& chunk = m_batch[m_ncurrent];
+		size_t nblock = chunk.rawSize - m_pos;
+		if (nblock > nsize) nblock = nsize;
+		memcpy(pc, &chunk.raw[m_pos], nblock);
+		m_pos += nblock;
+		pc += nblock;
+		nsize -= nblock;
+		nread += nblock;
+	}
+
+	// only report complete items, like fread
+	return size*(nread / size);
 }
 
 bool DumpFile::EndOfStream() const
 {
+	if (m_bchunked)
+	{
+		if (m_beof == false) return false;
+		if (m_ncurrent >= m_nchunks) return true;
+		if ((m_ncurrent == m_nchunks - 1) && (m_pos >= m_batch[m_ncurrent].rawSize)) return true;
+		return false;
+	}
 	return (feof(m_fp) != 0);
 }
@@ -29,6 +29,7 @@ SOFTWARE.*/
 #pragma once
 
 #include <stdio.h>
+#include <vector>
 #include "DumpStream.h"
 
 //-----------------------------------------------------------------------------
@@ -37,10 +38,31 @@ SOFTWARE.*/
 //! This class is used to read data from or write
 //! data to a binary file. The class defines several operators to 
 //! simplify in- and output.
+//! Archives created with Create are written as a sequence of chunks. Each chunk
+//! is compressed (when zlib is available) on a worker thread before it is written,
+//! and a chunk index is stored at the end of the file. Archives without the chunk
+//! header (i.e. older dump files or files opened with Append) are read and written as is.
 //! \sa FEM::Serialize()
 
 class FECORE_API DumpFile : public DumpStream
 {
+	// a chunk of serialized data
+	struct Chunk
+	{
+		std::vector<unsigned char>	raw;	// uncompressed data
+		std::vector<unsigned char>	buf;	// data as stored in file
+		unsigned int	rawSize;			// nr of uncompressed bytes
+		unsigned int	bufSize;			// nr of stored bytes (equals rawSize if the chunk is not compressed)
+	};
+
+	// chunk index entry
+	struct ChunkInfo
+	{
+		long long		offset;		// file position of chunk header
+		unsigned int	rawSize;
+		unsigned int	bufSize;
+	};
+
 public:
 	// overloaded from DumpStream
 	size_t write(const void* pd, size_t size, size_t count) override;
@@ -61,15 +83,45 @@ public:
 	//! Open archive for appending
 	bool Append(const char* szfile);
 
-	//! Close archive
-	void Close();
+	//! Close archive. Returns false if any data could not be written.
+	bool Close();
 
 	//! See if the archive is valid
 	bool IsValid() { return (m_fp != 0); }
 
 	//! Flush the archive
-	void Flush() { fflush(m_fp); }
+	void Flush();
+
+	//! See if a write to the file failed
+	bool WriteError() const { return m_bwriteError; }
+
+	//! Set the chunk size (in bytes) used when creating archives
+	void SetChunkSize(size_t chunkSize);
+
+	//! Turn compression on or off (only used when zlib is available)
+	void SetCompression(bool b) { m_bcompress = b; }
+
+private:
+	bool WriteChunks(bool bflush);
+	bool fwrite_all(const void* pd, size_t size, size_t count);
+	bool ReadChunks();
+	void InitBatch();
 
 protected:
 	FILE*		m_fp;		//!< The actual file pointer
+
+private:
+	bool	m_bchunked;		//!< archive is chunked
+	bool	m_bcompress;	//!< compress chunks
+	size_t	m_chunkSize;	//!< max nr of uncompressed bytes per chunk
+
+	std::vector<Chunk>		m_batch;	//!< chunks that are compressed/decompressed in parallel
+	int		m_nchunks;		//!< nr of chunks in batch
+	int		m_ncurrent;		//!< current chunk in batch (reading)
+	size_t	m_pos;			//!< read/write position in current chunk
+	bool	m_beof;			//!< end of chunked stream reached
+	bool	m_bwriteError;	//!< a write to the file failed
+	long long	m_offset;	//!< nr of bytes written to file
+
+	std::vector<ChunkInfo>	m_index;	//!< chunk index
 };
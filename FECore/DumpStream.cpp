@@ -60,6 +60,7 @@ bool DumpStream::IsShallow() const { return m_bshallow; }
 DumpStream::~DumpStream()
 {
 	m_ptr.clear();
+	m_ptrHash.clear();
 	m_bytes_serialized = 0;
 }
 
@@ -87,8 +88,8 @@ void DumpStream::Open(bool bsave, bool bshallow)
 
 	// add the "null" pointer
 	m_ptr.clear();
-	Pointer p = { 0, 0 };
-	m_ptr.push_back(p);
+	m_ptrHash.clear();
+	AddPointer(nullptr);
 }
 
 //-----------------------------------------------------------------------------
@@ -215,12 +216,28 @@ DumpStream& DumpStream::operator >> (double a[3][3])
 	return (*this);
 }
 
+//-----------------------------------------------------------------------------
+// hash function for the pointer table
+static inline size_t hash_pointer(void* p)
+{
+	unsigned long long h = (unsigned long long) (size_t) p;
+	h ^= (h >> 33);
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= (h >> 33);
+	return (size_t) h;
+}
+
 //-----------------------------------------------------------------------------
 int DumpStream::FindPointer(void* p)
 {
-	for (int i = 0; i < (int)m_ptr.size(); ++i)
+	if (m_ptrHash.empty()) return -1;
+	size_t mask = m_ptrHash.size() - 1;
+	size_t i = hash_pointer(p) & mask;
+	while (m_ptrHash[i] != -1)
 	{
-		if (m_ptr[i].pd == p) return i;
+		int n = m_ptrHash[i];
+		if (m_ptr[n].pd == p) return n;
+		i = (i + 1) & mask;
 	}
 	return -1;
 }
@@ -228,23 +245,59 @@ int DumpStream::FindPointer(void* p)
 //-----------------------------------------------------------------------------
 int DumpStream::FindPointer(int id)
 {
-	for (int i = 0; i < (int)m_ptr.size(); ++i)
-	{
-		if (m_ptr[i].id == id) return i;
-	}
-	return -1;
+	// ids are assigned in order so they double as table indices
+	if ((id < 0) || (id >= (int)m_ptr.size())) return -1;
+	assert(m_ptr[id].id == id);
+	return id;
 }
 
 //-----------------------------------------------------------------------------
 void DumpStream::AddPointer(void* p)
 {
 	if (m_ptr_lock) return;
-	if (p == nullptr) { assert(false); return;	}
+	if ((p == nullptr) && (m_ptr.empty() == false)) { assert(false); return;	}
 	assert(FindPointer(p) == -1);
+
+	// grow the hash table so that it stays at most half full
+	if (2*(m_ptr.size() + 1) > m_ptrHash.size())
+	{
+		RehashPointers(m_ptrHash.empty() ? 1024 : 2*m_ptrHash.size());
+	}
+
 	Pointer ptr;
 	ptr.pd = p;
 	ptr.id = (int)m_ptr.size();
 	m_ptr.push_back(ptr);
+
+	// The same address can be stored twice (e.g. an object and its first member).
+	// Lookups must return the first entry, so only new addresses are hashed.
+	size_t mask = m_ptrHash.size() - 1;
+	size_t i = hash_pointer(p) & mask;
+	while (m_ptrHash[i] != -1)
+	{
+		if (m_ptr[m_ptrHash[i]].pd == p) return;
+		i = (i + 1) & mask;
+	}
+	m_ptrHash[i] = ptr.id;
+}
+
+//-----------------------------------------------------------------------------
+// rebuild the pointer hash table with nsize slots (must be a power of two)
+void DumpStream::RehashPointers(size_t nsize)
+{
+	m_ptrHash.assign(nsize, -1);
+	size_t mask = nsize - 1;
+	for (int n = 0; n < (int)m_ptr.size(); ++n)
+	{
+		size_t i = hash_pointer(m_ptr[n].pd) & mask;
+		bool bfound = false;
+		while (m_ptrHash[i] != -1)
+		{
+			if (m_ptr[m_ptrHash[i]].pd == m_ptr[n].pd) { bfound = true; break; }
+			i = (i + 1) & mask;
+		}
+		if (bfound == false) m_ptrHash[i] = n;
+	}
 }
 
 //-----------------------------------------------------------------------------
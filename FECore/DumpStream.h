@@ -216,6 +216,7 @@ private:
 	int FindPointer(void* p);
 	int FindPointer(int id);
 	void AddPointer(void* p);
+	void RehashPointers(size_t nsize);
 
 	DumpStream& write_matrix(matrix& o);
 	DumpStream& read_matrix(matrix& o);
@@ -246,7 +247,8 @@ private:
 	size_t	m_bytes_serialized;	//!< number or bytes serialized
 
 	bool					m_ptr_lock;
-	std::vector<Pointer>	m_ptr;
+	std::vector<Pointer>	m_ptr;		//!< pointer table (indexed by id)
+	std::vector<int>		m_ptrHash;	//!< open-addressing hash table that maps pointers to entries in m_ptr
 };
 
 
@@ -75,6 +75,7 @@ FEAnalysis::FEAnalysis(FEModel* fem) : FECoreBase(fem)
 	m_final_time = 0.0;
 	m_dt0 = 0;
 	m_dt = 0;
+	m_dtseed = 0;
 
 	// initialize counters
 	m_ntotref    = 0;		// total nr of stiffness reformations
@@ -204,6 +205,9 @@ void FEAnalysis::Reset()
 
 	m_dt = m_dt0;
 
+	// start from the step size that converged in the previous solve
+	if (m_timeController && (m_dtseed > 0.0) && GetFEModel()->SeedTimeSteps()) m_dt = m_dtseed;
+
 	if (m_timeController) m_timeController->Reset();
 
 	// Deactivate the step
@@ -322,7 +326,9 @@ void FEAnalysis::Deactivate()
 	for (size_t i=0; i<(int) m_MC.size(); ++i) m_MC[i]->Deactivate();
 
 	// clean up solver data (i.e. destroy linear solver)
-	GetFESolver()->Clean();
+	// unless the model will reuse it in the next solve
+	if (GetFEModel()->ReuseSolverData()) GetFESolver()->Suspend();
+	else GetFESolver()->Clean();
 
 	// deactivate the time step
 	m_bactive = false;
@@ -445,6 +451,9 @@ bool FEAnalysis::Solve()
 			// update nr of completed timesteps
 			m_ntimesteps++;
 
+			// remember the first step size that converged
+			if (m_ntimesteps == 1) m_dtseed = tp.timeIncrement;
+
 			// call callback function
 			if (fem.DoCallback(CB_MAJOR_ITERS) == false)
 			{
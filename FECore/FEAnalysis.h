@@ -155,6 +155,7 @@ public:
 		double	m_final_time;	//!< end time for this time step
 		double	m_dt;			//!< current time step 
 		double	m_dt0;			//!< initial time step size
+		double	m_dtseed;		//!< first converged time step size of the last solve
 		double	m_tstart;		//!< start time
 		double	m_tend;			//!< end time
 
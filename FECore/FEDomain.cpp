@@ -33,7 +33,7 @@ SOFTWARE.*/
 //-----------------------------------------------------------------------------
 FEDomain::FEDomain(int nclass, FEModel* fem) : FEMeshPartition(nclass, fem)
 {
-
+	m_LMtag = -1;
 }
 
 //-----------------------------------------------------------------------------
@@ -57,12 +57,23 @@ void FEDomain::CreateMaterialPointData()
 {
 	FEMaterial* pmat = GetMaterial();
 	FEMesh* mesh = GetMesh();
-	if (pmat) ForEachElement([=](FEElement& el) {
+	if (pmat == nullptr) return;
+
+	// allocate the material points from the domain's pool
+	size_t npoints = 0;
+	ForEachElement([&](FEElement& el) { npoints += el.GaussPoints(); });
+	m_mpPool.Reserve(npoints);
+	FEMaterialPointPool::Scope scope(m_mpPool);
+
+	ForEachElement([=](FEElement& el) {
 
 		vec3d r[FEElement::MAX_NODES];
 		int ne = el.Nodes();
 		for (int i = 0; i < ne; ++i) r[i] = mesh->Node(el.m_node[i]).m_r0;
 
+		// release the old data first, so that its memory can be reused
+		el.ClearData();
+
 		for (int k = 0; k < el.GaussPoints(); ++k)
 		{
 			FEMaterialPoint* mp = pmat->CreateMaterialPointData();
@@ -118,6 +129,8 @@ void FEDomain::Serialize(DumpStream& ar)
 			int NEL = 0;
 			ar >> NEL;
 			Create(NEL, espec);
+
+			FEMaterialPointPool::Scope scope(m_mpPool);
 			for (int i = 0; i < NEL; ++i)
 			{
 				FEElement& el = ElementRef(i);
@@ -166,6 +179,44 @@ void FEDomain::UnpackLM(FEElement& el, const FEDofList& dof, vector<int>& lm)
 	}
 }
 
+//-----------------------------------------------------------------------------
+void FEDomain::UpdateLMCache()
+{
+	FEMesh* mesh = GetMesh();
+	const int NE = Elements();
+	if ((m_LMtag == mesh->EquationTag()) && ((int)m_LMoffset.size() == NE + 1)) return;
+
+	// count the size of each element's LM vector
+	m_LMoffset.assign(NE + 1, 0);
+	#pragma omp parallel
+	{
+		vector<int> lm;
+		#pragma omp for
+		for (int i = 0; i < NE; ++i)
+		{
+			UnpackLM(ElementRef(i), lm);
+			m_LMoffset[i + 1] = (int)lm.size();
+		}
+	}
+	for (int i = 0; i < NE; ++i) m_LMoffset[i + 1] += m_LMoffset[i];
+
+	// store the LM vectors
+	m_LMcache.resize(m_LMoffset[NE]);
+	#pragma omp parallel
+	{
+		vector<int> lm;
+		#pragma omp for
+		for (int i = 0; i < NE; ++i)
+		{
+			UnpackLM(ElementRef(i), lm);
+			assert(lm.size() == m_LMoffset[i + 1] - m_LMoffset[i]);
+			if (lm.empty() == false) std::copy(lm.begin(), lm.end(), m_LMcache.begin() + m_LMoffset[i]);
+		}
+	}
+
+	m_LMtag = mesh->EquationTag();
+}
+
 //-----------------------------------------------------------------------------
 void FEDomain::BuildMatrixProfile(FEGlobalMatrix& M)
 {
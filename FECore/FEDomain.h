@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #pragma once
 #include "FEMeshPartition.h"
+#include "FEMaterialPointPool.h"
 
 // forward declaration of material class
 class FEMaterial;
@@ -71,6 +72,18 @@ public:
 	//! Unpack the LM data for an element of this domain
 	virtual void UnpackLM(FEElement& el, vector<int>& lm);
 
+	//! Make sure the cache of element LM vectors is up to date. The cache is rebuilt
+	//! (using UnpackLM) when the equation numbers have changed since it was last built. 
+	//! Call this before a (parallel) element loop that uses CachedLM.
+	void UpdateLMCache();
+
+	//! copy the cached LM vector of element iel (UpdateLMCache must be called first)
+	void CachedLM(int iel, vector<int>& lm) const
+	{
+		const int* p = m_LMcache.data() + m_LMoffset[iel];
+		lm.assign(p, p + (m_LMoffset[iel + 1] - m_LMoffset[iel]));
+	}
+
 	//! build the matrix profile
 	virtual void BuildMatrixProfile(FEGlobalMatrix& M);
 
@@ -83,4 +96,16 @@ protected:
 
 	// helper function for unpacking element dofs
 	void UnpackLM(FEElement& el, const FEDofList& dof, vector<int>& lm);
+
+private:
+	// NOTE: The cache is only invalidated through FEMesh::EquationsChanged, so it should 
+	// only be used by domains whose dofs are not toggled while the model is solved
+	// (as is done, for instance, for the fluid pressure on free-draining contact surfaces).
+	vector<int>	m_LMcache;	//!< equation numbers of all elements
+	vector<int>	m_LMoffset;	//!< offset of each element's equation numbers in m_LMcache
+	int			m_LMtag;	//!< mesh equation tag when the cache was built
+
+	// NOTE: The elements are owned by the derived classes, so they are destroyed 
+	// before the pool that holds their material point data.
+	FEMaterialPointPool	m_mpPool;	//!< storage for the material point data
 };
@@ -33,6 +33,7 @@ SOFTWARE.*/
 #include "FEDomain.h"
 #include "FEElementList.h"
 #include <set>
+#include <algorithm>
 using namespace std;
 
 FEEdgeList::FEEdgeList() : m_mesh(nullptr)
@@ -60,23 +61,6 @@ FEMesh* FEEdgeList::GetMesh()
 	return m_mesh;
 }
 
-struct edge_less
-{
-	bool operator ()(const pair<int, int>& lhs, const pair<int, int>& rhs) const
-	{
-		int na0 = lhs.first;
-		int na1 = lhs.second;
-		if (na0 > na1) { int tmp = na0; na0 = na1; na1 = tmp; }
-
-		int nb0 = rhs.first;
-		int nb1 = rhs.second;
-		if (nb0 > nb1) { int tmp = nb0; nb0 = nb1; nb1 = tmp; }
-
-		if (na0 != nb0) return na0 < nb0;
-		else return na1 < nb1;
-	}
-};
-
 struct EDGE_less
 {
 	bool operator ()(const FEEdgeList::EDGE& lhs, const FEEdgeList::EDGE& rhs) const
@@ -101,57 +85,58 @@ bool FEEdgeList::Create(FEMesh* pmesh)
 	m_mesh = pmesh;
 	FEMesh& mesh = *pmesh;
 
-	// create the node-node list
+	// create a flat list of all the elements
 	FEElementList elemList(mesh);
-
-	set<pair<int, int>, edge_less> edgeSet;
+	int NE = mesh.Elements();
+	vector<FEElement*> elem(NE);
+	int n = 0;
+	for (FEElementList::iterator it = elemList.begin(); it != elemList.end(); ++it, ++n) elem[n] = &(*it);
 
 	const int ETET[6][2] = { { 0, 1 },{ 1, 2 },{ 2, 0 },{ 0, 3 },{ 1, 3 },{ 2, 3 } };
 	const int EHEX[12][2] = { { 0, 1 },{ 1, 2 },{ 2, 3 },{ 3, 0 },{ 4, 5 },{ 5, 6 },{ 6, 7 },{ 7, 4 },{ 0, 4 },{ 1, 5 },{ 2, 6 },{ 3, 7 } };
 
-	for (FEElementList::iterator it = elemList.begin(); it != elemList.end(); ++it)
+	// figure out where the edges of each element go
+	vector<int> pe(NE + 1, 0);
+	for (int i = 0; i < NE; ++i)
 	{
-		FEElement& el = *it;
-
-		if ((el.Shape() == ET_TET4) || (el.Shape() == ET_TET5))
-		{
-			for (int i = 0; i < 6; ++i)
-			{
-				pair<int, int> edge;
-				edge.first = el.m_node[ETET[i][0]];
-				edge.second = el.m_node[ETET[i][1]];
+		FEElement& el = *elem[i];
+		int ne = 0;
+		if ((el.Shape() == ET_TET4) || (el.Shape() == ET_TET5)) ne = 6;
+		else if (el.Shape() == ET_HEX8) ne = 12;
+		else return false;
+		pe[i + 1] = pe[i] + ne;
+	}
 
-				edgeSet.insert(edge);
-			}
-		}
-		else if (el.Shape() == ET_HEX8)
+	// collect all element edges (with sorted node numbers)
+	vector<pair<int, int> > edgeBuf(pe[NE]);
+	#pragma omp parallel for
+	for (int i = 0; i < NE; ++i)
+	{
+		FEElement& el = *elem[i];
+		const int (*E)[2] = (pe[i + 1] - pe[i] == 6 ? ETET : EHEX);
+		int ne = pe[i + 1] - pe[i];
+		for (int j = 0; j < ne; ++j)
 		{
-			for (int i = 0; i < 12; ++i)
-			{
-				pair<int, int> edge;
-				edge.first = el.m_node[EHEX[i][0]];
-				edge.second = el.m_node[EHEX[i][1]];
-
-				edgeSet.insert(edge);
-			}
+			int n0 = el.m_node[E[j][0]];
+			int n1 = el.m_node[E[j][1]];
+			if (n0 > n1) { int tmp = n0; n0 = n1; n1 = tmp; }
+			edgeBuf[pe[i] + j] = pair<int, int>(n0, n1);
 		}
-		else return false;
 	}
 
-	// copy set into a vector
-	size_t edges = edgeSet.size();
+	// sort and remove duplicates
+	sort(edgeBuf.begin(), edgeBuf.end());
+	edgeBuf.erase(unique(edgeBuf.begin(), edgeBuf.end()), edgeBuf.end());
+
+	// copy into the edge list
+	size_t edges = edgeBuf.size();
 	m_edgeList.resize(edges);
-	set< pair<int, int>, edge_less>::iterator edgeIter = edgeSet.begin();
-	for (size_t i = 0; i < edges; ++i, ++edgeIter)
+	for (size_t i = 0; i < edges; ++i)
 	{
-		const pair<int, int>& edge = *edgeIter;
 		EDGE& Edge = m_edgeList[i];
 		Edge.ntype = 2;
-		int n0 = edge.first;
-		int n1 = edge.second;
-		if (n0 > n1) { int tmp = n0; n0 = n1; n1 = tmp; }
-		Edge.node[0] = n0;
-		Edge.node[1] = n1;
+		Edge.node[0] = edgeBuf[i].first;
+		Edge.node[1] = edgeBuf[i].second;
 	}
 
 	return true;
@@ -261,12 +246,12 @@ FEElementEdgeList::FEElementEdgeList()
 
 int FEElementEdgeList::Edges(int elem) const
 {
-	return (int)m_EEL[elem].size();
+	return m_EEL.Size(elem);
 }
 
-const std::vector<int>& FEElementEdgeList::EdgeList(int elem) const
+FEIndexList FEElementEdgeList::EdgeList(int elem) const
 {
-	return m_EEL[elem];
+	return m_EEL.List(elem);
 }
 
 // NOTE: This only works for TET4 and HEX8 elements!
@@ -288,56 +273,44 @@ bool FEElementEdgeList::Create(FEElementList& elemList, FEEdgeList& edgeList)
 		NI[et.node[0]].second++;
 	}
 
+	// create a flat list of all the elements
 	int NE = mesh.Elements();
-	m_EEL.resize(NE);
-	int i = 0;
-	for (FEElementList::iterator it = elemList.begin(); it != elemList.end(); ++it, ++i)
-	{
-		const FEElement& el = *it;
-		vector<int>& EELi = m_EEL[i];
-		if ((el.Shape() == ET_TET4) || (el.Shape() == ET_TET5))
-		{
-			EELi.resize(6);
-			for (int j = 0; j<6; ++j)
-			{
-				int n0 = el.m_node[ETET[j][0]];
-				int n1 = el.m_node[ETET[j][1]];
+	vector<FEElement*> elem(NE);
+	int n = 0;
+	for (FEElementList::iterator it = elemList.begin(); it != elemList.end(); ++it, ++n) elem[n] = &(*it);
 
-				if (n1 < n0) { int nt = n1; n1 = n0; n0 = nt; }
+	// allocate the element edge table
+	vector<int> ne(NE, 0);
+	for (int i = 0; i < NE; ++i)
+	{
+		const FEElement& el = *elem[i];
+		if ((el.Shape() == ET_TET4) || (el.Shape() == ET_TET5)) ne[i] = 6;
+		else if (el.Shape() == FE_Element_Shape::ET_HEX8) ne[i] = 12;
+	}
+	m_EEL.Create(ne);
 
-				int l0 = NI[n0].first;
-				int ln = NI[n0].second;
-				for (int l = 0; l<ln; ++l)
-				{
-					assert(edgeList[l0 + l].node[0] == n0);
-					if (edgeList[l0 + l].node[1] == n1)
-					{
-						EELi[j] = l0 + l;
-						break;
-					}
-				}
-			}
-		}
-		else if (el.Shape() == FE_Element_Shape::ET_HEX8)
+	#pragma omp parallel for
+	for (int i = 0; i < NE; ++i)
+	{
+		const FEElement& el = *elem[i];
+		int* EELi = m_EEL.Data(i);
+		const int (*E)[2] = (ne[i] == 6 ? ETET : EHEX);
+		for (int j = 0; j < ne[i]; ++j)
 		{
-			EELi.resize(12);
-			for (int j = 0; j<12; ++j)
-			{
-				int n0 = el.m_node[EHEX[j][0]];
-				int n1 = el.m_node[EHEX[j][1]];
+			int n0 = el.m_node[E[j][0]];
+			int n1 = el.m_node[E[j][1]];
 
-				if (n1 < n0) { int nt = n1; n1 = n0; n0 = nt; }
+			if (n1 < n0) { int nt = n1; n1 = n0; n0 = nt; }
 
-				int l0 = NI[n0].first;
-				int ln = NI[n0].second;
-				for (int l = 0; l<ln; ++l)
+			int l0 = NI[n0].first;
+			int ln = NI[n0].second;
+			for (int l = 0; l<ln; ++l)
+			{
+				assert(edgeList.Edge(l0 + l).node[0] == n0);
+				if (edgeList.Edge(l0 + l).node[1] == n1)
 				{
-					assert(edgeList[l0 + l].node[0] == n0);
-					if (edgeList[l0 + l].node[1] == n1)
-					{
-						EELi[j] = l0 + l;
-						break;
-					}
+					EELi[j] = l0 + l;
+					break;
 				}
 			}
 		}
@@ -29,6 +29,7 @@ SOFTWARE.*/
 #pragma once
 #include <vector>
 #include "fecore_api.h"
+#include "FEIndexTable.h"
 
 class FEMesh;
 class FEElementList;
@@ -72,8 +73,8 @@ public:
 	bool Create(FEElementList& elemList, FEEdgeList& edgeList);
 
 	int Edges(int elem) const;
-	const std::vector<int>& EdgeList(int elem) const;
+	FEIndexList EdgeList(int elem) const;
 
 private:
-	std::vector<std::vector<int> >	m_EEL;
+	FEIndexTable	m_EEL;
 };
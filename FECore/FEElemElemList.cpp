@@ -54,7 +54,6 @@ void FEElemElemList::Init()
 
 	// count nr of neighbors
 	int NN = 0, n = 0, nf;
-	m_ref[0] = 0;
 	for (int i=0; i<m.Domains(); ++i)
 	{
 		FEDomain& dom = m.Domain(i);
@@ -62,7 +61,7 @@ void FEElemElemList::Init()
 		{
 			FEElement& el = dom.ElementRef(j);
 			nf = el.Faces();
-			if (n != 0) m_ref[n] = m_ref[n-1] + nf;
+			m_ref[n] = NN;
 			NN += nf;
 		}
 	}
@@ -87,80 +86,89 @@ bool FEElemElemList::Create(FEMesh* pmesh)
 	FENodeElemList NEL;
 	NEL.Create(m);
 
-	// loop over all solid elements first
-	int en0[FEElement::MAX_NODES], en1[FEElement::MAX_NODES], n0, n1, M = 0;
-	int nf0, nf1;
-	for (int nd=0; nd<m.Domains(); ++nd)
+	// create a flat list of all the elements so we can loop over them in parallel
+	int NE = m.Elements();
+	std::vector<FEElement*> elemList(NE);
+	int n = 0;
+	for (int nd = 0; nd < m.Domains(); ++nd)
 	{
 		FEDomain& dom = m.Domain(nd);
-		for (int i=0; i<dom.Elements(); ++i)
+		for (int i = 0; i < dom.Elements(); ++i) elemList[n++] = &dom.ElementRef(i);
+	}
+
+	// loop over all solid elements first
+	#pragma omp parallel for
+	for (int i = 0; i < NE; ++i)
+	{
+		FEElement& el = *elemList[i];
+
+		int en0[FEElement::MAX_NODES], en1[FEElement::MAX_NODES], n0, n1;
+		int nf0, nf1;
+
+		// get the number of neighbors
+		nf0 = el.Faces();
+
+		// loop over all neighbors
+		int M = m_ref[i];
+		for (int j=0; j<nf0; ++j, ++M)
 		{
-			FEElement& el = dom.ElementRef(i);
-			
-			// get the number of neighbors
-			nf0 = el.Faces();
+			// get the face nodes
+			n0 = el.GetFace(j, en0);
+
+			// find the neighbor element
+			m_pel[M] = 0;
+			m_peli[M] = -1;
 
-			// loop over all neighbors
-			for (int j=0; j<nf0; ++j, ++M)
+			// loop over all possible candidates
+			int nval = NEL.Valence(en0[0]);
+			FEElement** pne = NEL.ElementList(en0[0]);
+			int* pnei = NEL.ElementIndexList(en0[0]);
+			for (int k=0; k<nval; ++k)
 			{
-				// get the face nodes
-				n0 = el.GetFace(j, en0);
-
-				// find the neighbor element
-				m_pel[M] = 0;
-				m_peli[M] = -1;
-
-				// loop over all possible candidates
-				int nval = NEL.Valence(en0[0]);
-				FEElement** pne = NEL.ElementList(en0[0]);
-				int* pnei = NEL.ElementIndexList(en0[0]);
-				for (int k=0; k<nval; ++k)
+				// make sure we don't compare the current element
+				if (pne[k] != &el)
 				{
-					// make sure we don't compare the current element
-					if (pne[k] != &el)
+					// get the number of faces
+					nf1 = pne[k]->Faces();
+
+					// see if any of these faces match en0
+					for (int l=0; l<nf1; ++l)
 					{
-						// get the number of faces
-						nf1 = pne[k]->Faces();
+						n1 = pne[k]->GetFace(l, en1);
 
-						// see if any of these faces match en0
-						for (int l=0; l<nf1; ++l)
+						// make sure the faces have the same nr of nodes
+						if (n1 == n0)
 						{
-							n1 = pne[k]->GetFace(l, en1);
-
-							// make sure the faces have the same nr of nodes
-							if (n1 == n0)
+							// check triangles
+							if ((n0 == 3) || (n0 == 6) || (n0 ==7))
 							{
-								// check triangles
-								if ((n0 == 3) || (n0 == 6) || (n0 ==7))
+								if (((en0[0] == en1[0]) || (en0[0] == en1[1]) || (en0[0] == en1[2])) &&
+									((en0[1] == en1[0]) || (en0[1] == en1[1]) || (en0[1] == en1[2])) &&
+									((en0[2] == en1[0]) || (en0[2] == en1[1]) || (en0[2] == en1[2])))
 								{
-									if (((en0[0] == en1[0]) || (en0[0] == en1[1]) || (en0[0] == en1[2])) &&
-										((en0[1] == en1[0]) || (en0[1] == en1[1]) || (en0[1] == en1[2])) &&
-										((en0[2] == en1[0]) || (en0[2] == en1[1]) || (en0[2] == en1[2])))
-									{
-										// found it!
-										m_pel[M] = pne[k];
-										m_peli[M] = pnei[k];
-										break;
-									}
+									// found it!
+									m_pel[M] = pne[k];
+									m_peli[M] = pnei[k];
+									break;
 								}
-								// check quads
-								else if ((n0 == 4) || (n0 == 8) || (n0 == 9))
+							}
+							// check quads
+							else if ((n0 == 4) || (n0 == 8) || (n0 == 9))
+							{
+								if (((en0[0] == en1[0]) || (en0[0] == en1[1]) || (en0[0] == en1[2]) || (en0[0] == en1[3])) &&
+									((en0[1] == en1[0]) || (en0[1] == en1[1]) || (en0[1] == en1[2]) || (en0[1] == en1[3])) &&
+									((en0[2] == en1[0]) || (en0[2] == en1[1]) || (en0[2] == en1[2]) || (en0[2] == en1[3])) &&
+									((en0[3] == en1[0]) || (en0[3] == en1[1]) || (en0[3] == en1[2]) || (en0[3] == en1[3])))
 								{
-									if (((en0[0] == en1[0]) || (en0[0] == en1[1]) || (en0[0] == en1[2]) || (en0[0] == en1[3])) &&
-										((en0[1] == en1[0]) || (en0[1] == en1[1]) || (en0[1] == en1[2]) || (en0[1] == en1[3])) &&
-										((en0[2] == en1[0]) || (en0[2] == en1[1]) || (en0[2] == en1[2]) || (en0[2] == en1[3])) &&
-										((en0[3] == en1[0]) || (en0[3] == en1[1]) || (en0[3] == en1[2]) || (en0[3] == en1[3])))
-									{
-										// found it!
-										m_pel[M] = pne[k];
-										m_peli[M] = pnei[k];
-										break;
-									}
+									// found it!
+									m_pel[M] = pne[k];
+									m_peli[M] = pnei[k];
+									break;
 								}
 							}
-
-							if (m_pel[M] != 0) break;
 						}
+
+						if (m_pel[M] != 0) break;
 					}
 				}
 			}
@@ -201,16 +209,19 @@ bool FEElemElemList::Create(const FESurface* psurf)
 	NEL.Create(*psurf);
 
 	// loop over all facets
-	int en0[3], en1[3], M = 0;
-	int nf0, nf1;
+	#pragma omp parallel for
 	for (int i=0; i<NE; ++i)
 	{
 		const FESurfaceElement& el = psurf->Element(i);
-			
+
+		int en0[3], en1[3];
+		int nf0, nf1;
+
 		// get the number of neighbors
 		nf0 = el.facet_edges();
 
 		// loop over all neighbors
+		int M = m_ref[i];
 		for (int j=0; j<nf0; ++j, ++M)
 		{
 			// get the edge nodes
@@ -184,6 +184,16 @@ void FESolidElementTraits::init()
 			m_Gt[n][i] = Ht[i];
 		}
 	}
+
+	// store the derivatives by node
+	m_Gn.resize(3 * m_neln*m_nint);
+	for (int i = 0; i<m_neln; ++i)
+		for (int n = 0; n<m_nint; ++n)
+		{
+			m_Gn[(3*i    )*m_nint + n] = m_Gr[n][i];
+			m_Gn[(3*i + 1)*m_nint + n] = m_Gs[n][i];
+			m_Gn[(3*i + 2)*m_nint + n] = m_Gt[n][i];
+		}
 	
 	// calculate local second derivatives of shape functions at gauss points
 	double Hrr[NELN], Hss[NELN], Htt[NELN], Hrs[NELN], Hst[NELN], Hrt[NELN];
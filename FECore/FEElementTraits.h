@@ -136,6 +136,13 @@ public:
 
 	// local derivatives of shape functions at gauss points
 	matrix m_Gr, m_Gs, m_Gt;
+
+	// Same as m_Gr, m_Gs, m_Gt, but stored in one table where the integration 
+	// point is the fastest running index, i.e. m_Gn[(3*i + k)*nint + n] is the
+	// derivative of shape function i w.r.t. r (k=0), s (k=1), or t (k=2) at 
+	// integration point n. This allows loops over all integration points to vectorize.
+	vector<double> m_Gn;
+
 	std::vector<matrix>	m_Gr_p;
 	std::vector<matrix>	m_Gs_p;
 	std::vector<matrix>	m_Gt_p;
@@ -0,0 +1,97 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FEElementWorkspace.h"
+#include "FEElement.h"
+#include <map>
+#include <memory>
+
+//-----------------------------------------------------------------------------
+// nr of workspace (re)allocations
+static int ws_allocations = 0;
+
+//-----------------------------------------------------------------------------
+FEElementWorkspace& FEElementWorkspace::Get(int elemType, int ndof)
+{
+	// Each thread has its own pool of workspaces. Since the pool is thread_local
+	// there is no need to synchronize the threads. 
+	static thread_local std::map<std::pair<int, int>, std::unique_ptr<FEElementWorkspace> > pool;
+
+	std::unique_ptr<FEElementWorkspace>& ws = pool[std::make_pair(elemType, ndof)];
+	if (ws == nullptr)
+	{
+		ws.reset(new FEElementWorkspace(ndof));
+		#pragma omp atomic
+		ws_allocations++;
+	}
+	return *ws;
+}
+
+//-----------------------------------------------------------------------------
+FEElementWorkspace& FEElementWorkspace::Get(const FEElement& el, int ndof)
+{
+	return Get(el.Type(), ndof);
+}
+
+//-----------------------------------------------------------------------------
+int FEElementWorkspace::Allocations()
+{
+	return ws_allocations;
+}
+
+//-----------------------------------------------------------------------------
+FEElementWorkspace::FEElementWorkspace(int ndof) : m_ndof(ndof)
+{
+	m_data.resize(ndof*ndof);
+	m_rows.resize(ndof);
+	m_fe.resize(ndof);
+	m_lm.reserve(ndof);
+}
+
+//-----------------------------------------------------------------------------
+FEElementMatrix& FEElementWorkspace::Matrix(const FEElement& el)
+{
+	// the matrix may have been resized by the caller, in which case it no longer uses our storage
+	if ((m_ke.rows() != m_ndof) || (m_ke.columns() != m_ndof) || (m_ke.rows() && (m_ke[0] != &m_data[0])))
+	{
+		m_ke.attach(m_data.data(), m_rows.data(), m_ndof, m_ndof);
+	}
+	m_ke.zero();
+
+	// copy the nodes (this does not allocate when the capacity is sufficient)
+	m_ke.SetNodes(el.m_node);
+	return m_ke;
+}
+
+//-----------------------------------------------------------------------------
+std::vector<double>& FEElementWorkspace::Vector()
+{
+	m_fe.assign(m_ndof, 0.0);
+	return m_fe;
+}
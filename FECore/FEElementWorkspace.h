@@ -0,0 +1,80 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include "FEGlobalMatrix.h"
+#include <vector>
+
+class FEElement;
+
+//-----------------------------------------------------------------------------
+//! Storage for the element matrix, element vector, and LM vector that are needed
+//! in the element loops of the assembly routines. Each thread has its own set of
+//! workspaces, one for each combination of element type and number of element dofs,
+//! so that the element loops can borrow them instead of allocating new storage for
+//! every element.
+class FECORE_API FEElementWorkspace
+{
+public:
+	//! Get the workspace of the calling thread for an element type and nr of element dofs
+	static FEElementWorkspace& Get(int elemType, int ndof);
+
+	//! Get the workspace of the calling thread for an element
+	static FEElementWorkspace& Get(const FEElement& el, int ndof);
+
+	//! Total number of workspaces that were allocated (by all threads). 
+	//! This should not increase once the assembly loops reach a steady state.
+	static int Allocations();
+
+public:
+	//! returns the element matrix of size ndof x ndof for the element el. The matrix values
+	//! are stored in the workspace and are zeroed. The LM vectors are not set.
+	FEElementMatrix& Matrix(const FEElement& el);
+
+	//! returns a zeroed element vector of size ndof
+	std::vector<double>& Vector();
+
+	//! returns the LM vector
+	std::vector<int>& LM() { return m_lm; }
+
+	//! number of element dofs
+	int Dofs() const { return m_ndof; }
+
+private:
+	FEElementWorkspace(int ndof);
+	FEElementWorkspace(const FEElementWorkspace&) {}
+	void operator = (const FEElementWorkspace&) {}
+
+private:
+	int					m_ndof;		//!< nr of element dofs
+	std::vector<double>		m_data;		//!< storage for the matrix values
+	std::vector<double*>	m_rows;		//!< storage for the matrix row pointers
+	FEElementMatrix			m_ke;		//!< element matrix (using m_data and m_rows)
+	std::vector<double>		m_fe;		//!< element vector
+	std::vector<int>		m_lm;		//!< LM vector
+};
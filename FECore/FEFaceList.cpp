@@ -115,12 +115,12 @@ FEMesh* FEFaceList::GetMesh()
 
 int FEElementFaceList::Faces(int elem) const
 {
-	return (int)m_EFL[elem].size();
+	return m_EFL.Size(elem);
 }
 
-const std::vector<int>& FEElementFaceList::FaceList(int elem) const
+FEIndexList FEElementFaceList::FaceList(int elem) const
 {
-	return m_EFL[elem];
+	return m_EFL.List(elem);
 }
 
 // Extract the surface only
@@ -146,32 +146,42 @@ bool FEFaceList::Create(FEMesh& mesh, FEElemElemList& EEL)
 	// get the number of elements in this mesh
 	int NE = mesh.Elements();
 
-	// count the number of facets we have to create
-	int NF = 0;
+	// create a flat list of all the elements
+	std::vector<FEElement*> elem(NE);
 	FEElementList EL(mesh);
 	FEElementList::iterator it = EL.begin();
-	for (int i = 0; i<NE; ++i, ++it)
+	for (int i = 0; i < NE; ++i, ++it) elem[i] = &(*it);
+
+	// count the number of facets we have to create for each element
+	std::vector<int> pf(NE + 1, 0);
+	#pragma omp parallel for
+	for (int i = 0; i<NE; ++i)
 	{
-		FEElement& el = *it;
+		FEElement& el = *elem[i];
 		int nf = el.Faces();
+		int NF = 0;
 		for (int j = 0; j<nf; ++j)
 		{
 			FEElement* pen = EEL.Neighbor(i, j);
 			if (pen == 0) ++NF;
 			if ((pen != 0) && (el.GetID() < pen->GetID())) ++NF;
 		}
+		pf[i + 1] = NF;
 	}
 
+	// the offset of the first facet of each element
+	for (int i = 0; i < NE; ++i) pf[i + 1] += pf[i];
+
 	// create the facet list
-	m_faceList.resize(NF);
+	m_faceList.resize(pf[NE]);
 
 	// build the facets
-	int face[FEElement::MAX_NODES];
-	NF = 0;
-	it = EL.begin();
-	for (int i = 0; i<NE; ++i, ++it)
+	#pragma omp parallel for
+	for (int i = 0; i<NE; ++i)
 	{
-		FEElement& el = *it;
+		FEElement& el = *elem[i];
+		int face[FEElement::MAX_NODES];
+		int NF = pf[i];
 		int nf = el.Faces();
 		for (int j = 0; j<nf; ++j)
 		{
@@ -216,7 +226,9 @@ void FEFaceList::BuildNeighbors()
 	FENodeFaceList NFL;
 	NFL.Create(*this);
 
-	for (int i = 0; i < Faces(); ++i)
+	int NF = Faces();
+	#pragma omp parallel for
+	for (int i = 0; i < NF; ++i)
 	{
 		FACE& f = m_faceList[i];
 		f.nbr[0] = f.nbr[1] = f.nbr[2] = f.nbr[3] = -1;
@@ -230,7 +242,7 @@ void FEFaceList::BuildNeighbors()
 				int n1 = f.node[(j + 1) % fn];
 
 				int nval = NFL.Faces(n0);
-				std::vector<int> fl = NFL.FaceList(n0);
+				FEIndexList fl = NFL.FaceList(n0);
 				for (int k = 0; k < nval; ++k)
 				{
 					if (fl[k] != i)
@@ -257,28 +269,38 @@ FENodeFaceList::FENodeFaceList()
 
 int FENodeFaceList::Faces(int node) const
 {
-	return (int)m_NFL[node].size();
+	return m_NFL.Size(node);
 }
 
-const std::vector<int>& FENodeFaceList::FaceList(int node) const
+FEIndexList FENodeFaceList::FaceList(int node) const
 {
-	return m_NFL[node];
+	return m_NFL.List(node);
 }
 
 bool FENodeFaceList::Create(FEFaceList& FL)
 {
 	FEMesh& mesh = *FL.GetMesh();
 
+	// count the faces of each node
 	int NN = mesh.Nodes();
-	m_NFL.resize(NN);
-
 	int NF = FL.Faces();
+	vector<int> nval(NN, 0);
+	for (int i = 0; i < NF; ++i)
+	{
+		const FEFaceList::FACE& face = FL[i];
+		for (int j = 0; j < face.ntype; ++j) nval[face.node[j]]++;
+	}
+	m_NFL.Create(nval);
+
+	// fill the table (in face order)
+	for (int i = 0; i < NN; ++i) nval[i] = 0;
 	for (int i = 0; i < NF; ++i)
 	{
 		const FEFaceList::FACE& face = FL[i];
 		for (int j = 0; j < face.ntype; ++j)
 		{
-			m_NFL[face.node[j]].push_back(i);
+			int n = face.node[j];
+			m_NFL.Data(n)[nval[n]++] = i;
 		}
 	}
 
@@ -313,65 +335,57 @@ bool FEElementFaceList::Create(FEElementList& elemList, FEFaceList& faceList)
 		{ 4, 5, 6, 7 }};
 
 	// build a node face table for FT to facilitate searching
-	int NN = mesh.Nodes();
-	vector<vector<int> > NFT; NFT.resize(NN);
-	for (int i = 0; i<faceList.Faces(); ++i)
+	FENodeFaceList NFL;
+	NFL.Create(faceList);
+
+	// create a flat list of all the elements
+	int NE = mesh.Elements();
+	vector<FEElement*> elem(NE);
+	int n = 0;
+	for (FEElementList::iterator it = elemList.begin(); it != elemList.end(); ++it, ++n) elem[n] = &(*it);
+
+	// allocate the element face table
+	bool bok = true;
+	vector<int> nf(NE, 0);
+	for (int i = 0; i < NE; ++i)
 	{
-		const FEFaceList::FACE& f = faceList.Face(i);
-		NFT[f.node[0]].push_back(i);
-		NFT[f.node[1]].push_back(i);
-		NFT[f.node[2]].push_back(i);
-		if (f.ntype == 4) NFT[f.node[3]].push_back(i);
+		const FEElement& el = *elem[i];
+		if ((el.Shape() == ET_TET4) || (el.Shape() == ET_TET5)) nf[i] = 4;
+		else if (el.Shape() == FE_Element_Shape::ET_HEX8) nf[i] = 6;
+		else bok = false;
 	}
+	m_EFL.Create(nf);
 
-	int NE = mesh.Elements();
-	m_EFL.resize(NE);
-	int i = 0;
-	for (FEElementList::iterator it = elemList.begin(); it != elemList.end(); ++it, ++i)
+	#pragma omp parallel for
+	for (int i = 0; i < NE; ++i)
 	{
-		const FEElement& el = *it;
-		vector<int>& EFLi = m_EFL[i];
-		if ((el.Shape() == ET_TET4) || (el.Shape() == ET_TET5))
+		const FEElement& el = *elem[i];
+		int* EFLi = m_EFL.Data(i);
+		for (int j = 0; j < nf[i]; ++j)
 		{
-			EFLi.resize(4);
-			for (int j = 0; j < 4; ++j)
+			int fj[4];
+			if (nf[i] == 4)
 			{
-				int fj[3] = { el.m_node[FTET[j][0]], el.m_node[FTET[j][1]], el.m_node[FTET[j][2]] };
-				EFLi[j] = -1;
-				vector<int>& nfi = NFT[fj[0]];
-				for (int k = 0; k<(int)nfi.size(); ++k)
-				{
-					const FEFaceList::FACE& fk = faceList.Face(nfi[k]);
-					if (fk.IsEqual(fj))
-					{
-						EFLi[j] = nfi[k];
-						break;
-					}
-				}
+				fj[0] = el.m_node[FTET[j][0]]; fj[1] = el.m_node[FTET[j][1]]; fj[2] = el.m_node[FTET[j][2]]; fj[3] = -1;
 			}
-		}
-		else if (el.Shape() == FE_Element_Shape::ET_HEX8)
-		{
-			EFLi.resize(6);
-			for (int j = 0; j < 6; ++j)
+			else
 			{
-				int fj[4] = { el.m_node[FHEX[j][0]], el.m_node[FHEX[j][1]], el.m_node[FHEX[j][2]], el.m_node[FHEX[j][3]] };
-				EFLi[j] = -1;
-				vector<int>& nfi = NFT[fj[0]];
-				for (int k = 0; k<(int)nfi.size(); ++k)
+				fj[0] = el.m_node[FHEX[j][0]]; fj[1] = el.m_node[FHEX[j][1]]; fj[2] = el.m_node[FHEX[j][2]]; fj[3] = el.m_node[FHEX[j][3]];
+			}
+
+			FEIndexList nfl = NFL.FaceList(fj[0]);
+			for (int k = 0; k < nfl.size(); ++k)
+			{
+				const FEFaceList::FACE& fk = faceList.Face(nfl[k]);
+				if (fk.IsEqual(fj))
 				{
-					const FEFaceList::FACE& fk = faceList.Face(nfi[k]);
-					if (fk.IsEqual(fj))
-					{
-						EFLi[j] = nfi[k];
-						break;
-					}
+					EFLi[j] = nfl[k];
+					break;
 				}
 			}
 		}
-		else return false;
 	}
-	return true;
+	return bok;
 }
 
 //=============================================================================
@@ -385,14 +399,19 @@ bool FEFaceEdgeList::Create(FEFaceList& faceList, FEEdgeList& edgeList)
 	FENodeEdgeList NEL;
 	NEL.Create(edgeList);
 
+	// each face has as many edges as nodes
 	int faces = faceList.Faces();
-	m_FEL.resize(faces);
+	vector<int> ne(faces);
+	for (int i = 0; i < faces; ++i) ne[i] = faceList.Face(i).ntype;
+	m_FEL.Create(ne);
+
+	bool bok = true;
+	#pragma omp parallel for shared(bok)
 	for (int i = 0; i < faces; ++i)
 	{
-		vector<int>& edges = m_FEL[i];
-		edges.clear();
+		int* edges = m_FEL.Data(i);
 
-		FEFaceList::FACE face = faceList.Face(i);
+		const FEFaceList::FACE& face = faceList.Face(i);
 
 		// find the corresponding edges
 		int n = face.ntype;
@@ -402,7 +421,7 @@ bool FEFaceEdgeList::Create(FEFaceList& faceList, FEEdgeList& edgeList)
 			int b = face.node[(j + 1) % n];
 
 			int edge = -1;
-			const std::vector<int>& a_edges = NEL.EdgeList(a);
+			FEIndexList a_edges = NEL.EdgeList(a);
 			for (int k = 0; k < a_edges.size(); ++k)
 			{
 				const FEEdgeList::EDGE& ek = edgeList[a_edges[k]];
@@ -415,22 +434,22 @@ bool FEFaceEdgeList::Create(FEFaceList& faceList, FEEdgeList& edgeList)
 			}
 
 			assert(edge >= 0);
-			if (edge == -1) return false;
-			edges.push_back(edge);
+			if (edge == -1) bok = false;
+			edges[j] = edge;
 		}
 	}
 
-	return true;
+	return bok;
 }
 
 int FEFaceEdgeList::Edges(int nface)
 {
-	return (int)m_FEL[nface].size();
+	return m_FEL.Size(nface);
 }
 
-const std::vector<int>& FEFaceEdgeList::EdgeList(int nface) const
+FEIndexList FEFaceEdgeList::EdgeList(int nface) const
 {
-	return m_FEL[nface];
+	return m_FEL.List(nface);
 }
 
 //=============================================================================
@@ -441,17 +460,28 @@ FENodeEdgeList::FENodeEdgeList()
 
 bool FENodeEdgeList::Create(FEEdgeList& edgeList)
 {
-	m_NEL.clear();
 	FEMesh* mesh = edgeList.GetMesh();
 	int N = mesh->Nodes();
-	m_NEL.resize(N);
 
+	// count the edges of each node
 	int NE = edgeList.Edges();
+	vector<int> nval(N, 0);
+	for (int i = 0; i < NE; ++i)
+	{
+		const FEEdgeList::EDGE& edge = edgeList[i];
+		nval[edge.node[0]]++;
+		nval[edge.node[1]]++;
+	}
+	m_NEL.Create(nval);
+
+	// fill the table (in edge order)
+	for (int i = 0; i < N; ++i) nval[i] = 0;
 	for (int i = 0; i < NE; ++i)
 	{
 		const FEEdgeList::EDGE& edge = edgeList[i];
-		m_NEL[edge.node[0]].push_back(i);
-		m_NEL[edge.node[1]].push_back(i);
+		int n0 = edge.node[0], n1 = edge.node[1];
+		m_NEL.Data(n0)[nval[n0]++] = i;
+		m_NEL.Data(n1)[nval[n1]++] = i;
 	}
 
 	return true;
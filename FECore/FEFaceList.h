@@ -29,6 +29,7 @@ SOFTWARE.*/
 #pragma once
 #include <vector>
 #include "fecore_api.h"
+#include "FEIndexTable.h"
 
 class FEMesh;
 class FEElementList;
@@ -82,10 +83,10 @@ public:
 	bool Create(FEFaceList& FL);
 
 	int Faces(int node) const;
-	const std::vector<int>& FaceList(int node) const;
+	FEIndexList FaceList(int node) const;
 
 private:
-	std::vector<std::vector<int> >	m_NFL;
+	FEIndexTable	m_NFL;
 };
 
 class FECORE_API FEElementFaceList
@@ -96,10 +97,10 @@ public:
 	bool Create(FEElementList& elemList, FEFaceList& faceList);
 
 	int Faces(int elem) const;
-	const std::vector<int>& FaceList(int elem) const;
+	FEIndexList FaceList(int elem) const;
 
 private:
-	std::vector<std::vector<int> >	m_EFL;
+	FEIndexTable	m_EFL;
 };
 
 class FECORE_API FEFaceEdgeList
@@ -110,10 +111,10 @@ public:
 	bool Create(FEFaceList& faceList, FEEdgeList& edgeList);
 
 	int Edges(int nface);
-	const std::vector<int>& EdgeList(int nface) const;
+	FEIndexList EdgeList(int nface) const;
 
 private:
-	std::vector<std::vector<int> > m_FEL;
+	FEIndexTable	m_FEL;
 };
 
 class FECORE_API FENodeEdgeList
@@ -123,8 +124,8 @@ public:
 
 	bool Create(FEEdgeList& edgeList);
 
-	const std::vector<int>& EdgeList(int node) const { return m_NEL[node]; }
+	FEIndexList EdgeList(int node) const { return m_NEL.List(node); }
 
 private:
-	std::vector<std::vector<int> > m_NEL;
+	FEIndexTable	m_NEL;
 };
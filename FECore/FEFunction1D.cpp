@@ -40,6 +40,11 @@ FEFunction1D::FEFunction1D(FEModel* fem) : FECoreBase(fem)
 {
 }
 
+void FEFunction1D::value(const double* x, double* f, int n) const
+{
+	for (int i = 0; i < n; ++i) f[i] = value(x[i]);
+}
+
 double FEFunction1D::derive(double x) const
 {
 	const double eps = 1e-6;
@@ -59,6 +59,10 @@ public:
 	// must be defined by derived classes
 	virtual double value(double x) const = 0;
 
+	// evaluate the function at n points
+	// The default implementation calls value(x) for each point.
+	virtual void value(const double* x, double* f, int n) const;
+
 	// value of first derivative of function at x
 	// can be overridden by derived classes.
 	// default implementation is a forward-difference
@@ -30,10 +30,39 @@ SOFTWARE.*/
 #include "FEGlobalVector.h"
 #include "vec3d.h"
 #include "FEModel.h"
+#include "sys.h"
+
+//-----------------------------------------------------------------------------
+void FEGlobalVectorBuffers::Prepare(int nt, size_t NR, size_t NF)
+{
+	m_R.resize(nt);
+	m_Fr.resize(nt);
+
+	// Let each thread allocate its own buffers so they end up close to that thread.
+	// The buffers are only reallocated when their size changes. Otherwise they are
+	// just zeroed, in case a previous assembly was interrupted before Reduce was called.
+	#pragma omp parallel
+	{
+		int t = omp_get_thread_num();
+		if (t < nt)
+		{
+			m_R[t].assign(NR, 0.0);
+			m_Fr[t].assign(NF, 0.0);
+		}
+	}
+
+	// in case we got fewer threads than requested
+	for (int t = 0; t < nt; ++t)
+	{
+		if (m_R[t].size() != NR) m_R[t].assign(NR, 0.0);
+		if (m_Fr[t].size() != NF) m_Fr[t].assign(NF, 0.0);
+	}
+}
 
 //-----------------------------------------------------------------------------
 FEGlobalVector::FEGlobalVector(FEModel& fem, vector<double>& R, vector<double>& Fr) : m_fem(fem), m_R(R), m_Fr(Fr)
 {
+	m_buf = nullptr;
 }
 
 //-----------------------------------------------------------------------------
@@ -42,13 +71,74 @@ FEGlobalVector::~FEGlobalVector()
 
 }
 
+//-----------------------------------------------------------------------------
+void FEGlobalVector::UseThreadBuffers(FEGlobalVectorBuffers* buf)
+{
+	m_buf = nullptr;
+
+	// with one thread there is nothing to gain
+	int nt = omp_get_max_threads();
+	if ((buf == nullptr) || (nt == 1)) return;
+
+	buf->Prepare(nt, m_R.size(), m_Fr.size());
+	m_buf = buf;
+}
+
+//-----------------------------------------------------------------------------
+vector<double>& FEGlobalVector::ThreadResidual()
+{
+	return (m_buf == nullptr ? m_R : m_buf->m_R[omp_get_thread_num()]);
+}
+
+//-----------------------------------------------------------------------------
+void FEGlobalVector::Reduce()
+{
+	if (m_buf == nullptr) return;
+	const int nt = m_buf->Threads();
+	vector< vector<double> >& RT = m_buf->m_R;
+	vector< vector<double> >& FrT = m_buf->m_Fr;
+
+	// add the thread buffers and clear them so they can be used again
+	const int NR = (int)m_R.size();
+	#pragma omp parallel for
+	for (int i = 0; i < NR; ++i)
+	{
+		double r = 0.0;
+		for (int t = 0; t < nt; ++t) { r += RT[t][i]; RT[t][i] = 0.0; }
+		m_R[i] += r;
+	}
+
+	const int NF = (int)m_Fr.size();
+	for (int i = 0; i < NF; ++i)
+	{
+		double f = 0.0;
+		for (int t = 0; t < nt; ++t) { f += FrT[t][i]; FrT[t][i] = 0.0; }
+		m_Fr[i] += f;
+	}
+}
+
 //-----------------------------------------------------------------------------
 void FEGlobalVector::Assemble(vector<int>& en, vector<int>& elm, vector<double>& fe, bool bdom)
 {
+	// assemble into the thread's buffers, if we have them
+	int ndof = (int)fe.size();
+	if (m_buf)
+	{
+		int t = omp_get_thread_num();
+		vector<double>& R = m_buf->m_R[t];
+		vector<double>& Fr = m_buf->m_Fr[t];
+		for (int i = 0; i < ndof; ++i)
+		{
+			int I = elm[i];
+			if (I >= 0) R[I] += fe[i];
+			else if (-I - 2 >= 0) Fr[-I - 2] -= fe[i];
+		}
+		return;
+	}
+
 	vector<double>& R = m_R;
 
 	// assemble the element residual into the global residual
-	int ndof = (int)fe.size();
 	for (int i=0; i<ndof; ++i)
 	{
 		int I = elm[i];
@@ -68,8 +158,18 @@ void FEGlobalVector::Assemble(vector<int>& en, vector<int>& elm, vector<double>&
 //! \todo This function does not add to m_Fr. Is this a problem?
 void FEGlobalVector::Assemble(vector<int>& lm, vector<double>& fe)
 {
-	vector<double>& R = m_R;
 	const int n = (int) lm.size();
+	if (m_buf)
+	{
+		vector<double>& R = m_buf->m_R[omp_get_thread_num()];
+		for (int i = 0; i < n; ++i)
+		{
+			if (lm[i] >= 0) R[lm[i]] += fe[i];
+		}
+		return;
+	}
+
+	vector<double>& R = m_R;
 	for (int i=0; i<n; ++i)
 	{
 		int nid = lm[i];
@@ -90,7 +190,10 @@ void FEGlobalVector::Assemble(int nodeId, int dof, double f)
 
 	// assemble into global vector
 	if (n >= 0) {
+		if (m_buf) m_buf->m_R[omp_get_thread_num()][n] += f;
+		else {
 #pragma omp atomic
-		m_R[n] += f;
+			m_R[n] += f;
+		}
 	}
 }
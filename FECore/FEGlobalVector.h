@@ -33,6 +33,24 @@ using namespace std;
 
 class FEModel;
 
+//-----------------------------------------------------------------------------
+//! Per-thread buffers for assembling a global vector. These are owned by the
+//! caller (e.g. a solver) so that they only need to be allocated once and not
+//! each time a global vector is assembled.
+class FECORE_API FEGlobalVectorBuffers
+{
+public:
+	//! make sure there is a zeroed buffer for each thread
+	void Prepare(int nt, size_t NR, size_t NF);
+
+	//! number of threads
+	int Threads() const { return (int)m_R.size(); }
+
+public:
+	vector< vector<double> >	m_R;	//!< per-thread residual buffers
+	vector< vector<double> >	m_Fr;	//!< per-thread reaction force buffers
+};
+
 //-----------------------------------------------------------------------------
 //! This class represents a global system array. It provides functions to assemble
 //! local (element) vectors into this array
@@ -65,8 +83,24 @@ public:
 
 	operator vector<double>& () { return m_R; }
 
+public:
+	//! Use per-thread buffers instead of atomic updates when assembling. 
+	//! The buffers are only added to the global vector when Reduce is called, so 
+	//! Reduce must be called before the global vector is used. Pass nullptr to 
+	//! use atomic updates.
+	virtual void UseThreadBuffers(FEGlobalVectorBuffers* buf);
+
+	//! add the per-thread buffers to the global vector (and reaction forces)
+	virtual void Reduce();
+
+protected:
+	//! the residual array that the calling thread assembles into
+	vector<double>& ThreadResidual();
+
 protected:
 	FEModel&			m_fem;	//!< model
 	vector<double>&		m_R;	//!< residual
 	vector<double>&		m_Fr;	//!< nodal reaction forces \todo I want to remove this
+
+	FEGlobalVectorBuffers*	m_buf;	//!< per-thread buffers (null when atomics are used)
 };
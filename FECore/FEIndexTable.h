@@ -0,0 +1,96 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#pragma once
+#include <vector>
+
+//-----------------------------------------------------------------------------
+//! Read-only view of one list of an FEIndexTable. This can be used like a
+//! const vector<int>, and it can be copied into a vector<int>.
+class FEIndexList
+{
+public:
+	FEIndexList(const int* p, int n) : m_p(p), m_n(n) {}
+
+	int size() const { return m_n; }
+	bool empty() const { return (m_n == 0); }
+
+	int operator [] (int i) const { return m_p[i]; }
+
+	const int* begin() const { return m_p; }
+	const int* end() const { return m_p + m_n; }
+
+	operator std::vector<int> () const { return std::vector<int>(m_p, m_p + m_n); }
+
+private:
+	const int*	m_p;
+	int			m_n;
+};
+
+//-----------------------------------------------------------------------------
+//! A table of index lists (e.g. the faces of each element) that is stored in
+//! compressed (CSR) format: the indices of list i are stored in one flat array
+//! from position m_off[i] up to (but not including) m_off[i+1].
+//! The table is created from the list sizes. The lists are then filled via
+//! the Data function, which can be done in parallel since each list has its own slots.
+class FEIndexTable
+{
+public:
+	FEIndexTable() {}
+
+	//! Allocate the table for lists of the given sizes. All indices are set to -1.
+	void Create(const std::vector<int>& sizes)
+	{
+		const int N = (int)sizes.size();
+		m_off.assign(N + 1, 0);
+		for (int i = 0; i < N; ++i) m_off[i + 1] = m_off[i] + sizes[i];
+		m_ind.assign(m_off[N], -1);
+	}
+
+	//! clear the table
+	void Clear()
+	{
+		m_off.clear();
+		m_ind.clear();
+	}
+
+	//! number of lists
+	int Lists() const { return (m_off.empty() ? 0 : (int)m_off.size() - 1); }
+
+	//! size of list i
+	int Size(int i) const { return m_off[i + 1] - m_off[i]; }
+
+	//! get list i
+	FEIndexList List(int i) const { return FEIndexList(m_ind.data() + m_off[i], Size(i)); }
+
+	//! write access to the indices of list i
+	int* Data(int i) { return m_ind.data() + m_off[i]; }
+
+private:
+	std::vector<int>	m_off;	//!< offsets of the lists
+	std::vector<int>	m_ind;	//!< indices of all lists
+};
@@ -38,19 +38,24 @@ FELineSearch::FELineSearch(FENewtonSolver* pns) : m_pns(pns)
 	m_LSmin = 0.01;
 	m_LStol = 0.9;
 	m_LSiter = 5;
+	m_method = LS_DEFAULT;
 }
 
 // serialization
 void FELineSearch::Serialize(DumpStream& ar)
 {
 	if (ar.IsShallow()) return;
-	ar & m_LSmin & m_LStol & m_LSiter;
+	ar & m_LSmin & m_LStol & m_LSiter & m_method;
 }
 
 //! Performs a linesearch on a NR iteration
 //! The description of this method can be found in:
 //!    "Nonlinear Continuum Mechanics for Finite Element Analysis", 	Bonet & Wood.
 //
+//! On return, the geometry is updated to the returned line search step and the 
+//! residual at that step is stored in the solver's R1 vector, so the solver can use it
+//! in the next iteration without evaluating it again.
+//
 //! \todo Find a different way to update the deformation based on the ls.
 //! For instance, define a di so that ui = s*di. Also, define the 
 //! position of the nodes at the previous iteration.
@@ -58,6 +63,9 @@ double FELineSearch::DoLineSearch(double s)
 {
 	assert(m_pns);
 
+	// the secant method is implemented separately
+	if (m_method == LS_SECANT) return DoSecantSearch(s);
+
 	double smin = s;
 
 	double a, A, B, D;
@@ -79,6 +87,9 @@ double FELineSearch::DoLineSearch(double s)
 
 	FENewtonStrategy* ns = m_pns->m_qnstrategy;
 
+	// the last step at which the residual was evaluated
+	double slast = -1.0;
+
 	// ul = ls*ui
 	vector<double> ul(ui.size());
 	do
@@ -89,6 +100,7 @@ double FELineSearch::DoLineSearch(double s)
 
 		// calculate residual at this point
 		ns->Residual(R1, false);
+		slast = s;
 
 		// make sure we are still in a valid range
 		if (s < m_LSmin)
@@ -105,6 +117,7 @@ double FELineSearch::DoLineSearch(double s)
 
 			// recalculate residual at this point
 			ns->Residual(R1, false);
+			slast = s;
 
 			// return and hope for the best
 			break;
@@ -154,9 +167,119 @@ double FELineSearch::DoLineSearch(double s)
 		// max nr of iterations reached.
 		// we choose the line step that reached the smallest energy
 		s = smin;
+
+		// no need to update when the last evaluation was done at this step
+		if (s != slast)
+		{
+			vcopys(ul, ui, s);
+			m_pns->Update(ul);
+			ns->Residual(R1, false);
+		}
+	}
+	return s;
+}
+
+//! Line search that finds the root of the energy r(s) = ui*R(s) with the secant method. 
+//! The first trial step and the step zero (for which the energy is already known) serve
+//! as the initial points. Once the root is bracketed, the search continues with the 
+//! Illinois variant of regula falsi, so the bracket keeps shrinking from both sides. 
+//! This typically needs fewer residual evaluations than the default method, which only 
+//! uses the last trial step to calculate the next one.
+double FELineSearch::DoSecantSearch(double s)
+{
+	// vectors
+	vector<double>& ui = m_pns->m_ui;
+	vector<double>& R0 = m_pns->m_R0;
+	vector<double>& R1 = m_pns->m_R1;
+
+	FENewtonStrategy* ns = m_pns->m_qnstrategy;
+
+	// ul = ls*ui
+	vector<double> ul(ui.size());
+
+	// initial energy (at s = 0)
+	double r0 = ui*R0;
+
+	// the two points that define the secant
+	double sa = 0.0, ra = r0;
+	double sb = s, rb = 0.0;
+
+	double smin = s, rmin = fabs(r0);
+	double slast = -1.0;
+	int n = 0;
+	while (true)
+	{
+		// make sure we are still in a valid range. If not, we do the same 
+		// as DoLineSearch, but without evaluating the residual at s first.
+		if (s < m_LSmin)
+		{
+			s = 0.5;
+			vcopys(ul, ui, s);
+			m_pns->Update(ul);
+			ns->Residual(R1, false);
+			return s;
+		}
+
+		// Update geometry and calculate the residual at this point
 		vcopys(ul, ui, s);
 		m_pns->Update(ul);
 		ns->Residual(R1, false);
+		slast = s;
+
+		// calculate energy
+		double r1 = ui*R1;
+		if ((n == 0) || (fabs(r1) < rmin))
+		{
+			smin = s;
+			rmin = fabs(r1);
+		}
+
+		// check convergence
+		if ((fabs(r1) < 1.e-17) || (fabs(r1 / r0) <= m_LStol)) return s;
+		if (n >= m_LSiter) break;
+		++n;
+
+		// update the secant points
+		if (n == 1) { sb = s; rb = r1; }
+		else if (r1*rb < 0.0)
+		{
+			// the root lies between the last two points
+			sa = sb; ra = rb;
+			sb = s; rb = r1;
+		}
+		else if (r1*ra < 0.0)
+		{
+			// the root is still bracketed by a, which we keep, but reduce its weight
+			// so that the bracket does not stall on one side
+			ra *= 0.5;
+			sb = s; rb = r1;
+		}
+		else
+		{
+			// not bracketed yet: use the last two points
+			sa = sb; ra = rb;
+			sb = s; rb = r1;
+		}
+
+		// calculate the next step
+		double dr = rb - ra;
+		if (dr == 0.0) s = 0.5*(sa + sb);
+		else s = sb - rb*(sb - sa) / dr;
+
+		// when extrapolating, don't go too far out
+		if ((ra*rb > 0.0) && (s > 2.0*(sa > sb ? sa : sb))) s = 2.0*(sa > sb ? sa : sb);
+		if (s < 0.0) s = 0.0;
 	}
+
+	// max nr of iterations reached.
+	// we choose the line step that reached the smallest energy
+	s = smin;
+	if (s != slast)
+	{
+		vcopys(ul, ui, s);
+		m_pns->Update(ul);
+		ns->Residual(R1, false);
+	}
+
 	return s;
 }
@@ -34,6 +34,13 @@ class DumpStream;
 
 class FELineSearch
 {
+public:
+	// line search methods
+	enum LS_METHOD {
+		LS_DEFAULT,		//!< quadratic fit (Bonet & Wood)
+		LS_SECANT		//!< secant method with bracketing
+	};
+
 public:
 	FELineSearch(FENewtonSolver* pns);
 
@@ -47,6 +54,11 @@ public:
 	double	m_LSmin;		//!< minimum line search step
 	double	m_LStol;		//!< line search tolerance
 	int		m_LSiter;		//!< max nr of line search iterations
+	int		m_method;		//!< line search method (see LS_METHOD)
+
+private:
+	// secant line search
+	double DoSecantSearch(double s);
 
 private:
 	FENewtonSolver*	m_pns;
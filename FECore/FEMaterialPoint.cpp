@@ -29,8 +29,19 @@ SOFTWARE.*/
 #include "stdafx.h"
 #include "FEMaterialPoint.h"
 #include "DumpStream.h"
+#include "FEMaterialPointPool.h"
 #include <string.h>
 
+void* FEMaterialPoint::operator new(size_t size)
+{
+	return FEMaterialPointPool::New(size);
+}
+
+void FEMaterialPoint::operator delete(void* p)
+{
+	FEMaterialPointPool::Delete(p);
+}
+
 FEMaterialPoint::FEMaterialPoint(FEMaterialPoint* ppt)
 {
 	m_pPrev = 0;
@@ -50,6 +50,11 @@ public:
 	FEMaterialPoint(FEMaterialPoint* ppt = 0);
 	virtual ~FEMaterialPoint();
 
+	//! Material points are allocated from the active material point pool, if 
+	//! there is one (see FEMaterialPointPool).
+	static void* operator new(size_t size);
+	static void operator delete(void* p);
+
 public:
 	//! The init function is used to intialize data
 	virtual void Init();
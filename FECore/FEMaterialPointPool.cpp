@@ -0,0 +1,190 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FEMaterialPointPool.h"
+#include <new>
+
+//-----------------------------------------------------------------------------
+// Each allocation is preceded by a header that stores the block the memory
+// came from (or null for heap memory). The header size keeps the objects aligned.
+union POOL_HEADER
+{
+	void*			block;
+	long double		align;
+};
+
+//-----------------------------------------------------------------------------
+// The pool that is active on the calling thread
+static thread_local FEMaterialPointPool* active_pool = nullptr;
+
+//-----------------------------------------------------------------------------
+FEMaterialPointPool::Scope::Scope(FEMaterialPointPool& pool)
+{
+	m_prev = active_pool;
+	active_pool = &pool;
+}
+
+//-----------------------------------------------------------------------------
+FEMaterialPointPool::Scope::~Scope()
+{
+	active_pool = m_prev;
+}
+
+//-----------------------------------------------------------------------------
+FEMaterialPointPool::FEMaterialPointPool()
+{
+	m_nreserve = 0;
+	m_nobjs = 0;
+	m_nsize = 0;
+}
+
+//-----------------------------------------------------------------------------
+FEMaterialPointPool::~FEMaterialPointPool()
+{
+	for (size_t i = 0; i < m_blocks.size(); ++i)
+	{
+		delete [] m_blocks[i]->data;
+		delete m_blocks[i];
+	}
+	m_blocks.clear();
+	m_class.clear();
+}
+
+//-----------------------------------------------------------------------------
+void FEMaterialPointPool::Reserve(size_t objects)
+{
+	m_nreserve = objects;
+	for (size_t i = 0; i < m_class.size(); ++i) m_class[i].count = 0;
+}
+
+//-----------------------------------------------------------------------------
+void* FEMaterialPointPool::Allocate(size_t size)
+{
+	// round up the size (incl. header) so that all objects in a block stay aligned
+	const size_t align = sizeof(POOL_HEADER);
+	size_t stride = ((size + sizeof(POOL_HEADER) + align - 1) / align)*align;
+
+	// find the size class
+	int nclass = -1;
+	for (size_t i = 0; i < m_class.size(); ++i)
+	{
+		if (m_class[i].size == stride) { nclass = (int)i; break; }
+	}
+	if (nclass == -1)
+	{
+		SIZE_CLASS c = { stride, 0, nullptr, nullptr };
+		m_class.push_back(c);
+		nclass = (int)m_class.size() - 1;
+	}
+	SIZE_CLASS& c = m_class[nclass];
+
+	// allocate a new block if the current one is full
+	if ((c.block == nullptr) || (c.next == c.block->data + c.block->size))
+	{
+		// The block size doubles the nr of objects of this class, so that rarely 
+		// used classes only get small blocks, but it does not exceed the nr of 
+		// objects that are still expected.
+		size_t n = (c.count > 64 ? c.count : 64);
+		if ((m_nreserve > c.count) && (n > m_nreserve - c.count)) n = m_nreserve - c.count;
+
+		BLOCK* b = new BLOCK;
+		b->pool = this;
+		b->data = new char[n*stride];
+		b->size = n*stride;
+		b->nlive = 0;
+		b->nclass = nclass;
+		m_blocks.push_back(b);
+		m_nsize += b->size;
+
+		// the previous block is released when its last object is deleted
+		BLOCK* prev = c.block;
+		c.block = b;
+		c.next = b->data;
+		if (prev && (prev->nlive == 0)) FreeBlock(prev);
+	}
+
+	POOL_HEADER* h = (POOL_HEADER*)c.next;
+	c.next += stride;
+	c.count++;
+	c.block->nlive++;
+	m_nobjs++;
+
+	h->block = c.block;
+	return (void*)(h + 1);
+}
+
+//-----------------------------------------------------------------------------
+void FEMaterialPointPool::Release(BLOCK* b)
+{
+	m_nobjs--;
+	if (--b->nlive > 0) return;
+
+	// the current block of a size class is reused from the start
+	SIZE_CLASS& c = m_class[b->nclass];
+	if (c.block == b) { c.next = b->data; return; }
+
+	// all other blocks are freed
+	FreeBlock(b);
+}
+
+//-----------------------------------------------------------------------------
+void FEMaterialPointPool::FreeBlock(BLOCK* b)
+{
+	for (size_t i = 0; i < m_blocks.size(); ++i)
+	{
+		if (m_blocks[i] == b) { m_blocks.erase(m_blocks.begin() + i); break; }
+	}
+	m_nsize -= b->size;
+	delete [] b->data;
+	delete b;
+}
+
+//-----------------------------------------------------------------------------
+void* FEMaterialPointPool::New(size_t size)
+{
+	if (active_pool) return active_pool->Allocate(size);
+
+	POOL_HEADER* h = (POOL_HEADER*) ::operator new(size + sizeof(POOL_HEADER));
+	h->block = nullptr;
+	return (void*)(h + 1);
+}
+
+//-----------------------------------------------------------------------------
+void FEMaterialPointPool::Delete(void* p)
+{
+	if (p == nullptr) return;
+	POOL_HEADER* h = ((POOL_HEADER*)p) - 1;
+
+	if (h->block == nullptr) ::operator delete((void*)h);
+	else
+	{
+		BLOCK* b = (BLOCK*)h->block;
+		b->pool->Release(b);
+	}
+}
@@ -0,0 +1,121 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include "fecore_api.h"
+#include <vector>
+#include <stddef.h>
+
+//-----------------------------------------------------------------------------
+//! Memory pool for material point data. 
+//! The material point data of a domain consists of many small objects (one or more
+//! for each integration point) that are allocated when the model is initialized. While
+//! a pool is activated (see FEMaterialPointPool::Scope), all material points that are
+//! created by the calling thread are allocated from the pool instead of the heap. 
+//! Objects of the same size (which usually means, of the same type) are stored 
+//! contiguously in the order in which they were created, which is element and 
+//! integration point order for the domains.
+//! The blocks of a size class grow with the number of objects of that size, up to
+//! the number of objects that is expected (see Reserve). 
+//! Deleting a pooled material point calls its destructor. A block is released as
+//! soon as all of its objects are deleted, so recreating the material point data of
+//! a domain (e.g. after remeshing) does not grow the pool. The pool must outlive
+//! all the material points that were allocated from it. Like the allocation, 
+//! deleting pooled material points is not thread-safe.
+class FECORE_API FEMaterialPointPool
+{
+	struct BLOCK
+	{
+		FEMaterialPointPool*	pool;	//!< the pool this block belongs to
+		char*	data;	//!< the memory of this block
+		size_t	size;	//!< size of the block (in bytes)
+		size_t	nlive;	//!< nr of objects in this block that were not deleted yet
+		int		nclass;	//!< the size class of this block
+	};
+
+	struct SIZE_CLASS
+	{
+		size_t	size;	//!< object size (including header)
+		size_t	count;	//!< nr of objects allocated since the last call to Reserve
+		BLOCK*	block;	//!< the current block
+		char*	next;	//!< next free slot in the current block
+	};
+
+public:
+	//! Activates a pool for the calling thread during the lifetime of this object
+	class FECORE_API Scope
+	{
+	public:
+		Scope(FEMaterialPointPool& pool);
+		~Scope();
+
+	private:
+		FEMaterialPointPool*	m_prev;
+	};
+
+public:
+	FEMaterialPointPool();
+	~FEMaterialPointPool();
+
+	//! Set the number of objects per size class that are expected. This limits
+	//! the size of the memory blocks that are allocated.
+	void Reserve(size_t objects);
+
+	//! number of objects allocated from the pool that were not deleted yet
+	size_t Objects() const { return m_nobjs; }
+
+	//! total memory allocated by the pool (in bytes)
+	size_t Size() const { return m_nsize; }
+
+public:
+	//! Allocate memory for a material point. This uses the active pool if there is one,
+	//! otherwise it allocates from the heap.
+	static void* New(size_t size);
+
+	//! Release memory allocated with New.
+	static void Delete(void* p);
+
+private:
+	void* Allocate(size_t size);
+
+	//! called when an object of the block is deleted
+	void Release(BLOCK* b);
+
+	//! free the memory of a block
+	void FreeBlock(BLOCK* b);
+
+	FEMaterialPointPool(const FEMaterialPointPool&) {}
+	void operator = (const FEMaterialPointPool&) {}
+
+private:
+	std::vector<SIZE_CLASS>	m_class;	//!< size classes
+	std::vector<BLOCK*>		m_blocks;	//!< allocated memory blocks
+	size_t		m_nreserve;		//!< expected nr of objects per size class
+	size_t		m_nobjs;		//!< nr of live objects
+	size_t		m_nsize;		//!< total size of allocated blocks
+};
@@ -67,6 +67,7 @@ FEDataMap* CreateDataMap(int mapType)
 FEMesh::FEMesh(FEModel* fem) : m_fem(fem)
 {
 	m_LUT = 0;
+	m_eqTag = 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -88,6 +89,9 @@ void FEMesh::Serialize(DumpStream& ar)
 	// clear the mesh if we are loading from an archive
 	if ((ar.IsShallow() == false) && (ar.IsLoading())) Clear();
 
+	// the restored nodes may have different equation numbers
+	if (ar.IsLoading()) EquationsChanged();
+
 	// we don't want to store pointers to all the nodes
 	// mostly for efficiency, so we tell the archive not to store the pointers
 	ar.LockPointerTable();
@@ -103,6 +103,13 @@ public:
 	//! Set the number of degrees of freedom on this mesh
 	void SetDOFS(int n);
 
+	//! Mark that the equation numbers of the nodes have changed. 
+	//! This invalidates the domains' cached element equation numbers (see FEDomain::UpdateLMCache).
+	void EquationsChanged() { m_eqTag++; }
+
+	//! Returns a tag that changes every time the equation numbers change
+	int EquationTag() const { return m_eqTag; }
+
 	//! update bounding box
 	void UpdateBox();
 
@@ -281,6 +288,8 @@ private:
 	FEElementLUT*	m_LUT;
 
 	FEModel*	m_fem;
+
+	int		m_eqTag;	//!< changes every time the equation numbers are changed
 private:
 	//! hide the copy constructor
 	FEMesh(FEMesh& m){}
@@ -195,7 +195,7 @@ const FEFaceList::FACE& FEMeshTopo::SurfaceFace(int i) const
 }
 
 // return the element-face list
-const std::vector<int>& FEMeshTopo::ElementFaceList(int nelem)
+FEIndexList FEMeshTopo::ElementFaceList(int nelem)
 {
 	return imp->m_EFL.FaceList(nelem);
 }
@@ -213,13 +213,13 @@ const FEEdgeList::EDGE& FEMeshTopo::Edge(int i)
 }
 
 // return the face-edge list
-const std::vector<int>& FEMeshTopo::FaceEdgeList(int nface)
+FEIndexList FEMeshTopo::FaceEdgeList(int nface)
 {
 	return imp->m_FEL.EdgeList(nface);
 }
 
 // return the element-edge list
-const std::vector<int>& FEMeshTopo::ElementEdgeList(int nelem)
+FEIndexList FEMeshTopo::ElementEdgeList(int nelem)
 {
 	return imp->m_EEL.EdgeList(nelem);
 }
@@ -237,7 +237,7 @@ std::vector<int> FEMeshTopo::FaceIndexList(FESurface& s)
 		FESurfaceElement& el = s.Element(i);
 
 		int nval = NFL.Faces(el.m_node[0]);
-		const std::vector<int>& nfl = NFL.FaceList(el.m_node[0]);
+		FEIndexList nfl = NFL.FaceList(el.m_node[0]);
 		for (int j = 0; j < nval; ++j)
 		{
 			const FEFaceList::FACE& face = imp->m_faceList[nfl[j]];
@@ -266,7 +266,7 @@ std::vector<int> FEMeshTopo::SurfaceFaceIndexList(FESurface& s)
 		FESurfaceElement& el = s.Element(i);
 
 		int nval = NFL.Faces(el.m_node[0]);
-		const std::vector<int>& nfl = NFL.FaceList(el.m_node[0]);
+		FEIndexList nfl = NFL.FaceList(el.m_node[0]);
 		for (int j = 0; j < nval; ++j)
 		{
 			const FEFaceList::FACE& face = imp->m_surface[nfl[j]];
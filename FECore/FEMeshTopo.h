@@ -73,7 +73,7 @@ public:
 	const FEFaceList::FACE& SurfaceFace(int i) const;
 
 	// return the element-face list
-	const std::vector<int>& ElementFaceList(int nelem);
+	FEIndexList ElementFaceList(int nelem);
 
 	// return the number of edges in the mesh
 	int Edges();
@@ -82,10 +82,10 @@ public:
 	const FEEdgeList::EDGE& Edge(int i);
 
 	// return the face-edge list
-	const std::vector<int>& FaceEdgeList(int nface);
+	FEIndexList FaceEdgeList(int nface);
 
 	// return the element-edge list
-	const std::vector<int>& ElementEdgeList(int nelem);
+	FEIndexList ElementEdgeList(int nelem);
 
 	// return the list of face indices of a surface
 	std::vector<int> FaceIndexList(FESurface& s);
@@ -109,6 +109,9 @@ public:
 
 		m_meshUpdate = false;
 
+		m_reuseSolverData = false;
+		m_seedTimeSteps = false;
+
 		// create the linear constraint manager
 		m_LCM = new FELinearConstraintManager(fem);
 
@@ -175,6 +178,8 @@ public:
 	int				m_nStep;	//!< current index of analysis step
 	bool			m_printParams;	//!< print parameters
 	bool			m_meshUpdate;	//!< mesh update flag
+	bool			m_reuseSolverData;	//!< keep solver data between resets
+	bool			m_seedTimeSteps;	//!< seed the time step size from the previous solve
 
 public:
 	// The model
@@ -1633,6 +1638,18 @@ void FEModel::SetPrintParametersFlag(bool b)
 	m_imp->m_printParams = b;
 }
 
+//-----------------------------------------------------------------------------
+void FEModel::SetReuseSolverData(bool b) { m_imp->m_reuseSolverData = b; }
+
+//-----------------------------------------------------------------------------
+bool FEModel::ReuseSolverData() const { return m_imp->m_reuseSolverData; }
+
+//-----------------------------------------------------------------------------
+void FEModel::SetSeedTimeSteps(bool b) { m_imp->m_seedTimeSteps = b; }
+
+//-----------------------------------------------------------------------------
+bool FEModel::SeedTimeSteps() const { return m_imp->m_seedTimeSteps; }
+
 //-----------------------------------------------------------------------------
 bool FEModel::EvaluateLoadParameters()
 {
@@ -371,6 +371,17 @@ public: // --- parameter functions ---
 	//! Set the print parameters flag
 	void SetPrintParametersFlag(bool b);
 
+	//! Keep the solver data (e.g. matrix profile and symbolic factorization) when the
+	//! model is reset, so it can be reused when the model is solved again with the same 
+	//! equations. This is meant for repeated solves, e.g. during parameter optimization.
+	void SetReuseSolverData(bool b);
+	bool ReuseSolverData() const;
+
+	//! Start the auto time stepper from the time step size that converged in the 
+	//! previous solve, instead of the initial time step size.
+	void SetSeedTimeSteps(bool b);
+	bool SeedTimeSteps() const;
+
 public:	// --- Miscellaneous routines ---
 
 	//! call the callback function
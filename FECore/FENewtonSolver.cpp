@@ -46,6 +46,7 @@ BEGIN_FECORE_CLASS(FENewtonSolver, FESolver)
 	ADD_PARAMETER(m_lineSearch->m_LStol , FE_RANGE_GREATER_OR_EQUAL(0.0), "lstol"   );
 	ADD_PARAMETER(m_lineSearch->m_LSmin , FE_RANGE_GREATER_OR_EQUAL(0.0), "lsmin"   );
 	ADD_PARAMETER(m_lineSearch->m_LSiter, FE_RANGE_GREATER_OR_EQUAL(0), "lsiter"  );
+	ADD_PARAMETER(m_lineSearch->m_method, "lsmethod", 0, "DEFAULT\0SECANT\0");
 	ADD_PARAMETER(m_maxref              , FE_RANGE_GREATER_OR_EQUAL(0.0), "max_refs");
 	ADD_PARAMETER(m_bzero_diagonal      , "check_zero_diagonal");
 	ADD_PARAMETER(m_zero_tol            , "zero_diagonal_tol"  );
@@ -83,6 +84,7 @@ FENewtonSolver::FENewtonSolver(FEModel* pfem) : FESolver(pfem)
     m_neq = 0;
     m_plinsolve = 0;
 	m_pK = 0;
+	m_bsuspended = false;
 
 	m_Rtol = 0.001;
 	m_Etol = 0.01;
@@ -257,7 +259,7 @@ std::vector<double> FENewtonSolver::GetLoadVector()
 //! Get the total solution vector (for current Newton iteration)
 void FENewtonSolver::GetSolutionVector(std::vector<double>& U)
 {
-	U = m_Ui + m_ui;
+	vadd(U, m_Ui, m_ui);
 }
 
 //-----------------------------------------------------------------------------
@@ -441,15 +443,28 @@ bool FENewtonSolver::Init()
 	m_Ut.assign(m_neq, 0);
 	m_Fd.assign(m_neq, 0);
 
+	// see if we can reuse the linear system of the previous solve. 
+	// This requires that the equation numbering did not change.
+	bool breuse = (m_bsuspended && m_persistMatrix && m_plinsolve && m_pK && (m_pK->Rows() == m_neq));
+	m_bsuspended = false;
+
 	// allocate storage for the sparse matrix that will hold the stiffness matrix data
 	// we let the linear solver allocate the correct type of matrix format
-	if (AllocateLinearSystem() == false) return false;
+	if ((breuse == false) && (AllocateLinearSystem() == false)) return false;
 
 	// Base class initialization and validation
 	if (FESolver::Init() == false) return false;
 
 	// set the create stiffness matrix flag
-	m_breshape = true;
+	// If we reuse the linear system, the matrix profile and the symbolic factorization
+	// are still valid, unless contact or nonlinear constraints can change the profile.
+	FEModel& fem = *GetFEModel();
+	if (breuse && (fem.SurfacePairConstraints() == 0) && (fem.NonlinearConstraints() == 0))
+	{
+		feLog("Reusing stiffness matrix profile of previous solve.\n");
+		m_breshape = false;
+	}
+	else m_breshape = true;
 
 	return true;
 }
@@ -463,6 +478,17 @@ void FENewtonSolver::Clean()
 	if (m_pK) delete m_pK; m_pK = nullptr;
 	if (m_qnstrategy) delete m_qnstrategy; m_qnstrategy = nullptr;
 	m_Var.clear();
+	m_bsuspended = false;
+}
+
+//-----------------------------------------------------------------------------
+//! Suspend
+//! Same as Clean, but keeps the linear solver, the stiffness matrix and the 
+//! solution strategy so that Init can reuse them when the model is solved again.
+void FENewtonSolver::Suspend()
+{
+	m_Var.clear();
+	m_bsuspended = true;
 }
 
 //-----------------------------------------------------------------------------
@@ -636,7 +662,7 @@ bool FENewtonSolver::Quasin()
 		double ls = QNSolve();
 
 		// update solution vector
-		for (int i = 0; i<m_neq; ++i) m_Ui[i] += ls*m_ui[i];
+		vadds(m_Ui, m_ui, ls);
 
 		feLog(" Nonlinear solution status: time= %lg\n", tp.currentTime);
 		feLog("\tstiffness updates             = %d\n", m_qnstrategy->m_nups);
@@ -726,8 +752,10 @@ bool FENewtonSolver::CheckConvergence(int niter, const vector<double>& ui, doubl
 	}
 
 	// calculate current norms
-	m_residuNorm.norm = m_R1*m_R1;
-	m_energyNorm.norm = fabs(ls*(ui*m_R1));
+	double uu, uR, RR;
+	vdot3(ui, m_R1, uu, uR, RR);
+	m_residuNorm.norm = RR;
+	m_energyNorm.norm = fabs(ls*uR);
 	for (int i = 0; i < vars; ++i)
 	{
 		ConvergenceInfo& c = m_solutionNorm[i];
@@ -107,6 +107,9 @@ public: // overloaded from FESolver
 	//! Clean up
 	void Clean() override;
 
+	//! Keep the linear solver and stiffness matrix for the next solve
+	void Suspend() override;
+
 	//! serialization
 	void Serialize(DumpStream& ar) override;
 
@@ -245,6 +248,7 @@ public:
 	FEGlobalMatrix*		m_pK;			//!< global stiffness matrix
     bool				m_breshape;		//!< Matrix reshape flag
 	bool				m_persistMatrix;//!< Don't delete stiffness matrix until necessary (if true, K is deleted at end of time step)
+	bool				m_bsuspended;	//!< linear solver and stiffness matrix were kept from a previous solve
 
 	// data used by Quasin
 	vector<double> m_R0;	//!< residual at iteration i-1
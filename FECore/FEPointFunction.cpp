@@ -28,6 +28,8 @@ SOFTWARE.*/
 #include "DumpStream.h"
 #include "log.h"
 #include "BSpline.h"
+#include <algorithm>
+#include <atomic>
 
 #ifndef min
 #define min(a,b) ((a)<(b)?(a):(b))
@@ -46,6 +48,12 @@ class FEPointFunction::Imp
 public:
 	BSpline*    m_spline;   //!< B-spline
 
+	// Segment and spline span of the last evaluation. Load curves are mostly
+	// evaluated at increasing times, so these are good guesses for the next lookup.
+	// They are only hints, so relaxed atomics suffice when threads share a curve.
+	std::atomic<int>	m_seg;
+	std::atomic<int>	m_span;
+
 public:
 	bool InitSpline(FEPointFunction* pf)
 	{
@@ -85,6 +93,8 @@ public:
 FEPointFunction::FEPointFunction(FEModel* fem) : FEFunction1D(fem), m_fnc(LINEAR), m_ext(CONSTANT), imp(new Imp)
 {
 	imp->m_spline = nullptr;
+	imp->m_seg = 1;
+	imp->m_span = -1;
     m_bln = false;
 }
 
@@ -194,7 +204,57 @@ inline double qerp(double t, double t0, double f0, double t1, double f1, double
 
 double FEPointFunction::value(double time) const
 {
-    if (m_bln) time = (time > 0) ? log(time) : m_points[0].x();
+	if (m_bln) time = (time > 0) ? log(time) : m_points[0].x();
+	int hint = imp->m_seg.load(std::memory_order_relaxed);
+	double v = PointValue(time, hint);
+	imp->m_seg.store(hint, std::memory_order_relaxed);
+	return v;
+}
+
+//-----------------------------------------------------------------------------
+// Evaluates the curve at n points. The segment found for one point is used as
+// the starting guess for the next, so (nearly) sorted input is evaluated in O(n).
+void FEPointFunction::value(const double* x, double* f, int n) const
+{
+	if (n <= 0) return;
+	if (m_points.empty()) { for (int i = 0; i < n; ++i) f[i] = 0.0; return; }
+
+	int hint = imp->m_seg.load(std::memory_order_relaxed);
+	const double x0 = m_points[0].x();
+	for (int i = 0; i < n; ++i)
+	{
+		double t = x[i];
+		if (m_bln) t = (t > 0) ? log(t) : x0;
+		f[i] = PointValue(t, hint);
+	}
+	imp->m_seg.store(hint, std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------
+// Returns the index n of the first point for which x < m_points[n].x(). 
+// This assumes that m_points[0].x() <= x < m_points[N].x().
+// The hint (and the segment after it) is tried before doing a binary search.
+int FEPointFunction::FindSegment(double x, int& hint) const
+{
+	const int nsize = Points();
+	int n = hint;
+	if ((n > 0) && (n < nsize))
+	{
+		if ((m_points[n - 1].x() <= x) && (x < m_points[n].x())) return n;
+		if ((n + 1 < nsize) && (m_points[n].x() <= x) && (x < m_points[n + 1].x())) { hint = n + 1; return hint; }
+	}
+
+	std::vector<vec2d>::const_iterator it = std::upper_bound(m_points.begin(), m_points.end(), x, [](double t, const vec2d& p) { return t < p.x(); });
+	n = (int)(it - m_points.begin());
+	if (n < 1) n = 1;
+	if (n > nsize - 1) n = nsize - 1;
+	hint = n;
+	return n;
+}
+
+//-----------------------------------------------------------------------------
+double FEPointFunction::PointValue(double time, int& hint) const
+{
 	int nsize = Points();
 	if (nsize == 0) return 0;
 	if (nsize == 1) return m_points[0].y();
@@ -208,18 +268,20 @@ double FEPointFunction::value(double time) const
     double tmin = m_points[0].x();
     if (m_fnc > SMOOTH)
     {
-        if (time > tmax) return imp->m_spline->eval(tmax);
-        else if (time < tmin) return imp->m_spline->eval(tmin);
-        else return imp->m_spline->eval(time);
+		if (time > tmax) time = tmax;
+		else if (time < tmin) time = tmin;
+		int span = imp->m_span.load(std::memory_order_relaxed);
+		double v = imp->m_spline->eval(time, span);
+		imp->m_span.store(span, std::memory_order_relaxed);
+		return v;
     }
     
-	if (time < tmin) return ExtendValue(time);
-	if (time > tmax) return ExtendValue(time);
+	if (time < tmin) return ExtendValue(time, hint);
+	if (time > tmax) return ExtendValue(time, hint);
 
 	if (m_fnc == LINEAR)
 	{
-		int n = 0;
-		while (m_points[n].x() <= time) ++n;
+		int n = FindSegment(time, hint);
 
 		double t0 = m_points[n - 1].x();
 		double t1 = m_points[n    ].x();
@@ -231,8 +293,7 @@ double FEPointFunction::value(double time) const
 	}
 	else if (m_fnc == STEP)
 	{
-		int n = 0;
-		while (m_points[n].x() <= time) ++n;
+		int n = FindSegment(time, hint);
 
 		return m_points[n].y();
 	}
@@ -262,8 +323,7 @@ double FEPointFunction::value(double time) const
 		}
 		else
 		{
-			int n = 0;
-			while (m_points[n].x() <= time) ++n;
+			int n = FindSegment(time, hint);
 
 			if (n == 1)
 			{
@@ -314,7 +374,7 @@ double FEPointFunction::value(double time) const
 //-----------------------------------------------------------------------------
 //! This function determines the value of the load curve outside of its domain
 //!
-double FEPointFunction::ExtendValue(double t) const
+double FEPointFunction::ExtendValue(double t, int& hint) const
 {
 	int nsize = Points();
 	int N = nsize - 1;
@@ -349,26 +409,29 @@ double FEPointFunction::ExtendValue(double t) const
 			break;
 		case SMOOTH:
 		{
-			if (t < m_points[0].x()) return lerp(t, m_points[0].x(), m_points[0].y(), m_points[0].x() + dt, value(m_points[0].x() + dt));
-			else return lerp(t, m_points[N].x() - dt, value(m_points[N].x() - dt), m_points[N].x(), m_points[N].y());
+			if (t < m_points[0].x()) return lerp(t, m_points[0].x(), m_points[0].y(), m_points[0].x() + dt, PointValue(m_points[0].x() + dt, hint));
+			else return lerp(t, m_points[N].x() - dt, PointValue(m_points[N].x() - dt, hint), m_points[N].x(), m_points[N].y());
 		}
 		return 0;
 		}
 		break;
 	case REPEAT:
 		{
-			if (t < m_points[0].x()) while (t < m_points[0].x()) t += Dt;
-			else while (t > m_points[N].x()) t -= Dt;
-			return value(t);
+			// map t to the first period, i.e. t0 <= t < tN when t is below the range,
+			// or t0 < t <= tN when it is above.
+			if (t < m_points[0].x()) t += Dt*ceil((m_points[0].x() - t) / Dt);
+			else t -= Dt*ceil((t - m_points[N].x()) / Dt);
+			return PointValue(t, hint);
 		}
 		break;
 	case REPEAT_OFFSET:
 		{
-			int n = 0;
-			if (t < m_points[0].x()) while (t < m_points[0].x()) { t += Dt; --n; }
-			else while (t > m_points[N].x()) { t -= Dt; ++n; }
+			double n = 0;
+			if (t < m_points[0].x()) { n = -ceil((m_points[0].x() - t) / Dt); }
+			else { n = ceil((t - m_points[N].x()) / Dt); }
+			t -= n*Dt;
 			double off = n*(m_points[N].y() - m_points[0].y());
-			return value(t) + off;
+			return PointValue(t, hint) + off;
 		}
 		break;
 	}
@@ -385,31 +448,44 @@ double FEPointFunction::ExtendValue(double t) const
 int FEPointFunction::FindPoint(double t, double& tval, int startIndex)
 {
     if (m_bln) t = (t > 0) ? log(t) : m_points[0].x();
+	const int nsize = Points();
+	if (nsize == 0) return -1;
+	std::vector<vec2d>::const_iterator it;
+	auto lessX = [](double x, const vec2d& p) { return x < p.x(); };
 	switch (m_ext)
 	{
 	case REPEAT:
 	case REPEAT_OFFSET:
 	{
-		double toff = 0.0;
-		while (1)
+		// The curve is repeated with a period equal to the last time value, 
+		// so find the first period k for which the last point lies beyond t.
+		const double T = m_points[nsize - 1].x();
+		if (t < m_points[0].x()) { tval = m_points[0].x(); return 0; }
+		if (T <= 0.0) return -1;
+		double k = (t < T ? 0.0 : floor((t - T) / T) + 1.0);
+		double toff = k*T;
+
+		// the search is repeated for the next period in case round-off put t
+		// just beyond the last point of this one
+		for (int l = 0; l < 2; ++l, toff += T)
 		{
-			double ti = 0;
-			for (int i = 0; i<Points(); ++i)
+			it = std::upper_bound(m_points.begin(), m_points.end(), t - toff, lessX);
+			for (int i = (int)(it - m_points.begin()); i < nsize; ++i)
 			{
-				ti = m_points[i].x() + toff;
+				double ti = m_points[i].x() + toff;
 				if (ti > t) { tval = ti; return i; }
 			}
-			toff = ti;
 		}
 	}
 	break;
 	default:
 		if (startIndex < 0) startIndex = 0;
-		if (startIndex >= Points()) return -1;
-		for (int i = startIndex; i<Points(); ++i)
+		if (startIndex >= nsize) return -1;
+		it = std::upper_bound(m_points.begin() + startIndex, m_points.end(), t, lessX);
+		if (it != m_points.end())
 		{
-			double ti = m_points[i].x();
-			if (ti > t) { tval = ti; return i; }
+			tval = it->x();
+			return (int)(it - m_points.begin());
 		}
 	}
 	return -1;
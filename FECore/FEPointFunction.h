@@ -111,6 +111,9 @@ public: // implement from base class
 	//! returns the value of the load curve at time
 	double value(double x) const override;
 
+	//! evaluates the load curve at n points
+	void value(const double* x, double* f, int n) const override;
+
 	//! returns the derivative value at time
 	double derive(double x) const override;
 
@@ -121,7 +124,14 @@ public: // implement from base class
 	double integrate(double a, double b) const override;
 
 protected:
-	double ExtendValue(double t) const;
+	double ExtendValue(double t, int& hint) const;
+
+	//! evaluate the curve at x, where x is already mapped to point space (see m_bln).
+	//! hint is the segment that was found in the previous evaluation.
+	double PointValue(double x, int& hint) const;
+
+	//! returns the index n of the first point for which x < m_points[n].x()
+	int FindSegment(double x, int& hint) const;
 
 // private:
 // 	//! returns the area of a trapezoid between a and b
@@ -2343,6 +2343,119 @@ double FESolidDomain::ShapeGradient(FESolidElement& el, int n, vec3d* GradH, con
     return detJt;
 }
 
+//-----------------------------------------------------------------------------
+// Calculates the shape function gradients at all integration points of an element.
+// The jacobians are evaluated simultaneously for all integration points, which 
+// allows the inner loops to vectorize. This function is instantiated below with 
+// compile-time constant sizes for the most common element types. The operations
+// are the same as in invjact and ShapeGradient, so the results are identical.
+// Returns the index of the first integration point with a negative jacobian, or -1.
+template <int NELN, int NINT> static int solid_shape_gradients(const double* Gn, const vec3d* rt, int neln, int nint, vec3d* GradH, double* detJ)
+{
+	const int ne = (NELN > 0 ? NELN : neln);
+	const int ni = (NINT > 0 ? NINT : nint);
+
+	// calculate the jacobians
+	double J[9][FEElement::MAX_INTPOINTS];
+	for (int k = 0; k < 9; ++k)
+		for (int n = 0; n < ni; ++n) J[k][n] = 0.0;
+
+	for (int i = 0; i < ne; ++i)
+	{
+		const double* Gr = Gn + (3*i    )*ni;
+		const double* Gs = Gn + (3*i + 1)*ni;
+		const double* Gt = Gn + (3*i + 2)*ni;
+		const double x = rt[i].x;
+		const double y = rt[i].y;
+		const double z = rt[i].z;
+		for (int n = 0; n < ni; ++n)
+		{
+			J[0][n] += Gr[n]*x; J[1][n] += Gs[n]*x; J[2][n] += Gt[n]*x;
+			J[3][n] += Gr[n]*y; J[4][n] += Gs[n]*y; J[5][n] += Gt[n]*y;
+			J[6][n] += Gr[n]*z; J[7][n] += Gs[n]*z; J[8][n] += Gt[n]*z;
+		}
+	}
+
+	// calculate the inverse jacobians (stored in J)
+	int nerr = -1;
+	for (int n = 0; n < ni; ++n)
+	{
+		const double J00 = J[0][n], J01 = J[1][n], J02 = J[2][n];
+		const double J10 = J[3][n], J11 = J[4][n], J12 = J[5][n];
+		const double J20 = J[6][n], J21 = J[7][n], J22 = J[8][n];
+
+		double det =  J00*(J11*J22 - J12*J21)
+					+ J01*(J12*J20 - J22*J10)
+					+ J02*(J10*J21 - J11*J20);
+		detJ[n] = det;
+		if ((det <= 0) && (nerr == -1)) nerr = n;
+
+		double deti = 1.0 / det;
+		J[0][n] =  deti*(J11*J22 - J12*J21);
+		J[3][n] =  deti*(J12*J20 - J10*J22);
+		J[6][n] =  deti*(J10*J21 - J11*J20);
+
+		J[1][n] =  deti*(J02*J21 - J01*J22);
+		J[4][n] =  deti*(J00*J22 - J02*J20);
+		J[7][n] =  deti*(J01*J20 - J00*J21);
+
+		J[2][n] =  deti*(J01*J12 - J11*J02);
+		J[5][n] =  deti*(J02*J10 - J00*J12);
+		J[8][n] =  deti*(J00*J11 - J01*J10);
+	}
+	if (nerr != -1) return nerr;
+
+	// calculate the shape function gradients
+	// note that we need the transposed of Ji, not Ji itself !
+	for (int i = 0; i < ne; ++i)
+	{
+		const double* Gr = Gn + (3*i    )*ni;
+		const double* Gs = Gn + (3*i + 1)*ni;
+		const double* Gt = Gn + (3*i + 2)*ni;
+		for (int n = 0; n < ni; ++n)
+		{
+			vec3d& G = GradH[n*ne + i];
+			G.x = J[0][n]*Gr[n] + J[3][n]*Gs[n] + J[6][n]*Gt[n];
+			G.y = J[1][n]*Gr[n] + J[4][n]*Gs[n] + J[7][n]*Gt[n];
+			G.z = J[2][n]*Gr[n] + J[5][n]*Gs[n] + J[8][n]*Gt[n];
+		}
+	}
+
+	return -1;
+}
+
+//-----------------------------------------------------------------------------
+// dispatch table for the shape gradient kernels
+typedef int (*SHAPE_GRADIENTS_KERNEL)(const double* Gn, const vec3d* rt, int neln, int nint, vec3d* GradH, double* detJ);
+
+static SHAPE_GRADIENTS_KERNEL shape_gradients_kernel(int etype)
+{
+	switch (etype)
+	{
+	case FE_HEX8G8   : return solid_shape_gradients< 8,  8>;
+	case FE_HEX8G1   : return solid_shape_gradients< 8,  1>;
+	case FE_HEX20G8  : return solid_shape_gradients<20,  8>;
+	case FE_HEX20G27 : return solid_shape_gradients<20, 27>;
+	case FE_HEX27G27 : return solid_shape_gradients<27, 27>;
+	case FE_TET4G1   : return solid_shape_gradients< 4,  1>;
+	case FE_TET4G4   : return solid_shape_gradients< 4,  4>;
+	case FE_TET10G4  : return solid_shape_gradients<10,  4>;
+	case FE_TET10G8  : return solid_shape_gradients<10,  8>;
+	case FE_PENTA6G6 : return solid_shape_gradients< 6,  6>;
+	default:
+		return solid_shape_gradients<0, 0>;
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FESolidDomain::ShapeGradients(FESolidElement& el, const vec3d* rt, vec3d* GradH, double* detJ)
+{
+	assert(el.GaussPoints() <= FEElement::MAX_INTPOINTS);
+	SHAPE_GRADIENTS_KERNEL kernel = shape_gradients_kernel(el.Type());
+	int n = kernel(el.Gn(), rt, el.Nodes(), el.GaussPoints(), GradH, detJ);
+	if (n != -1) throw NegativeJacobian(el.GetID(), n + 1, detJ[n]);
+}
+
 //-----------------------------------------------------------------------------
 double FESolidDomain::ShapeGradient0(FESolidElement& el, int n, vec3d* GradH)
 {
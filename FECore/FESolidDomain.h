@@ -234,6 +234,10 @@ public:
     
     //! calculate spatial gradient of shapefunctions at integration point in reference frame (returns Jacobian determinant)
     double ShapeGradient0(FESolidElement& el, int n, vec3d* GradH);
+
+	//! calculate spatial gradient of shapefunctions at all integration points for the given nodal coordinates. 
+	//! GradH[n*neln + i] is the gradient of shape function i at integration point n and detJ[n] the Jacobian determinant.
+	void ShapeGradients(FESolidElement& el, const vec3d* rt, vec3d* GradH, double* detJ);
     
     //! calculate spatial gradient of shapefunctions at integration point (returns Jacobian determinant)
     double ShapeGradient(FESolidElement& el, double r, double s, double t, vec3d* GradH);
@@ -53,6 +53,7 @@ public:
 	double* Gr(int n) const { return ((FESolidElementTraits*)(m_pT))->m_Gr[n]; }	// shape function derivative to r
 	double* Gs(int n) const { return ((FESolidElementTraits*)(m_pT))->m_Gs[n]; }	// shape function derivative to s
 	double* Gt(int n) const { return ((FESolidElementTraits*)(m_pT))->m_Gt[n]; }	// shape function derivative to t
+	const double* Gn() const { return &((FESolidElementTraits*)(m_pT))->m_Gn[0]; }	// shape function derivatives, stored by node (see FESolidElementTraits::m_Gn)
 
 	double* Grr(int n) const { return ((FESolidElementTraits*)(m_pT))->Grr[n]; }	// shape function 2nd derivative to rr
 	double* Gsr(int n) const { return ((FESolidElementTraits*)(m_pT))->Gsr[n]; }	// shape function 2nd derivative to sr
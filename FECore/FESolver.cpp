@@ -112,6 +112,12 @@ void FESolver::Clean()
 {
 }
 
+//-----------------------------------------------------------------------------
+void FESolver::Suspend()
+{
+	Clean();
+}
+
 //-----------------------------------------------------------------------------
 void FESolver::Reset()
 {
@@ -342,6 +348,9 @@ bool FESolver::InitEquations()
     // clear partitions
 	m_part.clear();
 
+	// the element equation numbers will have to be updated
+	mesh.EquationsChanged();
+
 	// reorder the node numbers
 	int NN = mesh.Nodes();
 	vector<int> P(NN);
@@ -543,6 +552,9 @@ bool FESolver::InitEquations2()
 	// clear partitions
 	m_part.clear();
 
+	// the element equation numbers will have to be updated
+	mesh.EquationsChanged();
+
 	// reorder the node numbers
 	int NN = mesh.Nodes();
 	vector<int> P(NN);
@@ -109,6 +109,11 @@ public:
 	//! This is called by FEAnalaysis::Deactivate
 	virtual void Clean();
 
+	//! This is called by FEAnalysis::Deactivate instead of Clean when the model 
+	//! reuses its solver data (see FEModel::SetReuseSolverData). Solvers can keep 
+	//! data that is expensive to rebuild. The default implementation calls Clean.
+	virtual void Suspend();
+
 	//! rewind the solver (This is called when the time step fails and needs to retry)
 	virtual void Rewind() {}
 
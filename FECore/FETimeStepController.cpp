@@ -156,7 +156,7 @@ bool FETimeStepController::Init()
 //! reset
 void FETimeStepController::Reset()
 {
-	m_dtp = m_step->m_dt0;
+	m_dtp = m_step->m_dt;
 	m_nmust = -1;
 	m_next_must = -1;
 	m_mp_toff = 0.0;
@@ -29,6 +29,7 @@ SOFTWARE.*/
 #include "stdafx.h"
 #include "MatrixProfile.h"
 #include <assert.h>
+#include <algorithm>
 
 SparseMatrixProfile::ColumnProfile::ColumnProfile(const SparseMatrixProfile::ColumnProfile& a)
 {
@@ -152,6 +153,33 @@ void SparseMatrixProfile::ColumnProfile::insertRow(int row)
 	}
 }
 
+//-----------------------------------------------------------------------------
+// This merges a sorted list of unique row indices with the current profile. 
+// Unlike insertRow, this only requires a single pass over the column data.
+void SparseMatrixProfile::ColumnProfile::insertRows(const int* rows, int n)
+{
+	if (n == 0) return;
+
+	vector<RowEntry> data;
+	data.reserve(m_data.size() + n);
+
+	int N = size();
+	int i = 0, j = 0;
+	while ((i < N) || (j < n))
+	{
+		// pick the next interval (the one with the lowest start row)
+		RowEntry re;
+		if ((j >= n) || ((i < N) && (m_data[i].start <= rows[j]))) re = m_data[i++];
+		else { re.start = re.end = rows[j++]; }
+
+		// merge it with the last interval if they overlap or touch
+		if (data.empty() || (re.start > data.back().end + 1)) data.push_back(re);
+		else if (re.end > data.back().end) data.back().end = re.end;
+	}
+
+	m_data.swap(data);
+}
+
 //-----------------------------------------------------------------------------
 //! MatrixProfile constructor. Takes the nr of equations as input argument.
 //! If n is larger than zero a default profile is constructor for a diagonal
@@ -236,75 +264,75 @@ void SparseMatrixProfile::UpdateProfile(vector< vector<int> >& LM, int M)
 	int nc = m_ncol;
 
 	// make sure there is work to do
-	if (nr*nc == 0) return;
+	if ((nr == 0) || (nc == 0)) return;
 
 	// Count the number of elements that contribute to a certain column
 	// The pval array stores this number (which I also call the valence
 	// of the column)
-	vector<int> pval(nc, 0);
+	vector<int> pval(nc + 1, 0);
 
 	// fill the valence array
-	int Ntot = 0;
 	for (int i = 0; i<M; ++i)
 	{
-		int* lm = &(LM[i])[0];
+		const int* lm = &(LM[i])[0];
 		int N = (int)LM[i].size();
-		Ntot += N;
 		for (int j = 0; j<N; ++j)
 		{
-			if (lm[j] >= 0) pval[lm[j]]++;
+			if (lm[j] >= 0) pval[lm[j] + 1]++;
 		}
 	}
 
 	// create a "compact" 2D array that stores for each column the element
 	// numbers that contribute to that column. The compact array consists
 	// of two arrays. The first one (pelc) contains all element numbers, sorted
-	// by column. The second array stores for each column a pointer to the first
-	// element in the pelc array that contributes to that column.
-	vector<int> pelc(Ntot);
-	vector<int*> ppelc(nc);
-
-	// set the column pointers
-	ppelc[0] = &pelc[0];
-	for (int i = 1; i<nc; ++i) ppelc[i] = ppelc[i - 1] + pval[i - 1];
+	// by column. The second array (pval, after the prefix sum below) stores for 
+	// each column the offset of the first element in the pelc array that 
+	// contributes to that column.
+	for (int i = 0; i<nc; ++i) pval[i + 1] += pval[i];
+	vector<int> pelc(pval[nc]);
 
 	// fill the pelc array
+	vector<int> tag(pval.begin(), pval.end() - 1);
 	for (int i = 0; i<M; ++i)
 	{
-		int* lm = &(LM[i])[0];
+		const int* lm = &(LM[i])[0];
 		int N = (int)LM[i].size();
 		for (int j = 0; j<N; ++j)
 		{
-			if (lm[j] >= 0) *(ppelc[lm[j]])++ = i;
+			if (lm[j] >= 0) pelc[tag[lm[j]]++] = i;
 		}
 	}
 
-	// reset pelc pointers
-	ppelc[0] = &pelc[0];
-	for (int i = 1; i<nc; ++i) ppelc[i] = ppelc[i - 1] + pval[i - 1];
-
 	// loop over all columns
-#pragma omp parallel for schedule(dynamic)
-	for (int i = 0; i<nc; ++i)
+#pragma omp parallel
 	{
-		if (pval[i] > 0)
-		{
-			// get the column
-			ColumnProfile& a = m_prof[i];
+		// buffer for collecting the row indices of a column
+		vector<int> rows;
 
-			// loop over all elements in the plec
-			for (int j = 0; j<pval[i]; ++j)
+#pragma omp for schedule(dynamic, 64)
+		for (int i = 0; i<nc; ++i)
+		{
+			if (pval[i + 1] > pval[i])
 			{
-				int iel = (ppelc[i])[j];
-				int* lm = &(LM[iel])[0];
-				int N = (int)LM[iel].size();
-				for (int k = 0; k<N; ++k)
+				// collect the rows of all elements that contribute to this column
+				rows.clear();
+				for (int j = pval[i]; j<pval[i + 1]; ++j)
 				{
-					if (lm[k] >= 0)
-					{ 
-						a.insertRow(lm[k]);
+					int iel = pelc[j];
+					const int* lm = &(LM[iel])[0];
+					int N = (int)LM[iel].size();
+					for (int k = 0; k<N; ++k)
+					{
+						if (lm[k] >= 0) rows.push_back(lm[k]);
 					}
 				}
+
+				// sort and remove duplicates
+				sort(rows.begin(), rows.end());
+				rows.erase(unique(rows.begin(), rows.end()), rows.end());
+
+				// merge with the column profile
+				m_prof[i].insertRows(&rows[0], (int)rows.size());
 			}
 		}
 	}
@@ -85,6 +85,9 @@ public:
 		// add row index to column profile
 		void insertRow(int row);
 
+		// add a sorted list of (unique) row indices to the column profile
+		void insertRows(const int* rows, int n);
+
 	private:
 		vector<RowEntry>	m_data;	// the column profile data
 	};
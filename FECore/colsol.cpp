@@ -49,73 +49,118 @@ SOFTWARE.*/
 // Details of the algorithm can be found in Bathe, "Finite Element Procedures",
 // section 8.2, page 696 and following
 //
+// The factorization and back substitution are processed in blocks of columns
+// (rows) so that they can be multithreaded. The parts of a block that only depend 
+// on the columns before the block are evaluated in parallel, while the coupling 
+// within a block is evaluated serially. Since every matrix (and vector) entry is 
+// calculated with the same sequence of operations as in the serial algorithm, 
+// the results are identical to those of the serial algorithm.
+//
 
-FECORE_API void colsol_factor(int N, double* values, int* pointers)
-{
-	int i, j, r, mi, mj, mm;
-	double krj;
-	int pi, pj;
+// block sizes
+#define COLSOL_BLOCK		64		// nr of columns in a factorization block
+#define COLSOL_TILE			64		// nr of columns in a tile of previous columns
+#define COLSOL_SOLVE_BLOCK	256		// nr of rows in a back substitution block
 
-	// -A- factorize the matrix 
+//-----------------------------------------------------------------------------
+// calculate kij -= sum (r=mm..i-1) l(r,i)*k(r,j)
+static inline void colsol_reduce(double& kij, const double* values, int pi, int pj, int mm, int i)
+{
+	int r;
 
-	// repeat over all columns
-	for (j=1; j<N; ++j)
+	// the r-loop is unrolled to give this algorithm a significant boost in speed. 
+	// Although on good compilers this should not do much,
+	// on compilers that do a poor optimization this trick can
+	// double the speed of this algorithm.
+	for (r=mm; r<i-7; r+=8) 
 	{
-		// find the first non-zero row in column j
-		mj = j+1 - pointers[j+1] + pointers[j];
+		kij -= values[pi - r  ]*values[pj - r  ] +
+		       values[pi - r-1]*values[pj - r-1] +
+		       values[pi - r-2]*values[pj - r-2] +
+		       values[pi - r-3]*values[pj - r-3] +
+		       values[pi - r-4]*values[pj - r-4] +
+		       values[pi - r-5]*values[pj - r-5] +
+		       values[pi - r-6]*values[pj - r-6] +
+		       values[pi - r-7]*values[pj - r-7];
+	}
 
-		pj = pointers[j]+j;
+	for (r=0; r<(i-mm)%8; ++r)
+			kij -= values[pi - (i-1)+r]*values[pj - (i-1)+r];
+}
 
-		// loop over all rows in column j
-		for (i=mj+1; i<j; ++i)
-		{
-			// find the first non-zero row in column i
-			mi = i+1 - pointers[i+1] + pointers[i];
+//-----------------------------------------------------------------------------
+// reduce rows i0..i1-1 of column j
+static inline void colsol_reduce_column(int j, int i0, int i1, double* values, const int* pointers)
+{
+	// find the first non-zero row in column j
+	const int mj = j+1 - pointers[j+1] + pointers[j];
+	const int pj = pointers[j]+j;
+
+	if (i0 < mj+1) i0 = mj+1;
+	for (int i=i0; i<i1; ++i)
+	{
+		// find the first non-zero row in column i
+		const int mi = i+1 - pointers[i+1] + pointers[i];
 
-			// determine max of mi and mj
-			mm = (mi > mj ? mi : mj);
+		// determine max of mi and mj
+		const int mm = (mi > mj ? mi : mj);
 
-			pi = pointers[i]+i;
+		colsol_reduce(values[pj - i], values, pointers[i]+i, pj, mm, i);
+	}
+}
 
-			double& kij = values[pj - i];
+//-----------------------------------------------------------------------------
+FECORE_API void colsol_factor(int N, double* values, int* pointers)
+{
+	// -A- factorize the matrix 
 
-			// the next line is replaced by the piece of code between arrows
-			// where the r loop is unrolled to give this algorithm a 
-			// significant boost in speed. 
-			// Although on good compilers this should not do much,
-			// on compilers that do a poor optimization this trick can
-			// double the speed of this algorithm.
+	// repeat over all blocks of columns
+	for (int J0=1; J0<N; J0 += COLSOL_BLOCK)
+	{
+		const int J1 = (J0 + COLSOL_BLOCK < N ? J0 + COLSOL_BLOCK : N);
 
-//			for (r=mm; r<i; ++r) kij -= values[pi - r]*values[pj - r];
+		// find the first row that needs to be reduced in this block
+		int m0 = J0;
+		for (int j=J0; j<J1; ++j)
+		{
+			int mj = j+1 - pointers[j+1] + pointers[j];
+			if (mj + 1 < m0) m0 = mj + 1;
+		}
 
-//-------------->
-			for (r=mm; r<i-7; r+=8) 
+		// reduce the rows above the block. These only depend on the previous columns, 
+		// so the columns of the block can be processed in parallel. The previous 
+		// columns are processed in tiles, which are shared by all threads.
+		#pragma omp parallel if ((J1 - J0 > 1) && (J0 - m0 > COLSOL_TILE))
+		{
+			for (int I0=m0; I0<J0; I0 += COLSOL_TILE)
 			{
-				kij -= values[pi - r  ]*values[pj - r  ] +
-				       values[pi - r-1]*values[pj - r-1] +
-				       values[pi - r-2]*values[pj - r-2] +
-				       values[pi - r-3]*values[pj - r-3] +
-				       values[pi - r-4]*values[pj - r-4] +
-				       values[pi - r-5]*values[pj - r-5] +
-				       values[pi - r-6]*values[pj - r-6] +
-				       values[pi - r-7]*values[pj - r-7];
+				const int I1 = (I0 + COLSOL_TILE < J0 ? I0 + COLSOL_TILE : J0);
+
+				#pragma omp for schedule(static)
+				for (int j=J0; j<J1; ++j) colsol_reduce_column(j, I0, I1, values, pointers);
 			}
+		}
 
-			for (r=0; r<(i-mm)%8; ++r)
-					kij -= values[pi - (i-1)+r]*values[pj - (i-1)+r];
-//-------------->
+		// finish the columns of the block
+		for (int j=J0; j<J1; ++j)
+		{
+			// reduce the rows inside the block
+			colsol_reduce_column(j, J0, j, values, pointers);
 
-		}
+			// find the first non-zero row in column j
+			const int mj = j+1 - pointers[j+1] + pointers[j];
+			const int pj = pointers[j]+j;
 
-		// determine l[i][j]
-		for (i=mj; i<j; ++i) values[pj - i] /= values[ pointers[i] ];
+			// determine l[i][j]
+			for (int i=mj; i<j; ++i) values[pj - i] /= values[ pointers[i] ];
 
-		// calculate d[j][j] value
-		double& kjj = values[ pointers[j] ];
-		for (r=mj; r<j; ++r) 
-		{
-			krj = values[pj - r];
-			kjj -= krj*krj*values[ pointers[r] ];
+			// calculate d[j][j] value
+			double& kjj = values[ pointers[j] ];
+			for (int r=mj; r<j; ++r) 
+			{
+				double krj = values[pj - r];
+				kjj -= krj*krj*values[ pointers[r] ];
+			}
 		}
 	}
 }
@@ -124,49 +169,69 @@ FECORE_API void colsol_factor(int N, double* values, int* pointers)
 
 FECORE_API void colsol_solve(int N, double* values, int* pointers, double* R)
 {
-	int i, mi, r;
-
 	// -B- back substitution
 
 	// calculate V = L^(-T)*R vector
-	for (i=1; i<N; ++i)
+	for (int I0=1; I0<N; I0 += COLSOL_SOLVE_BLOCK)
 	{
-		mi = i+1 - pointers[i+1] + pointers[i];
-		for (r=mi; r<i; ++r)
-			R[i] -= values[ pointers[i] + i - r]*R[r];
+		const int I1 = (I0 + COLSOL_SOLVE_BLOCK < N ? I0 + COLSOL_SOLVE_BLOCK : N);
+
+		// contributions of the rows before the block
+		#pragma omp parallel for schedule(static) if (N > 4*COLSOL_SOLVE_BLOCK)
+		for (int i=I0; i<I1; ++i)
+		{
+			const int mi = i+1 - pointers[i+1] + pointers[i];
+			for (int r=mi; r<I0; ++r)
+				R[i] -= values[ pointers[i] + i - r]*R[r];
+		}
+
+		// contributions of the rows inside the block
+		for (int i=I0; i<I1; ++i)
+		{
+			const int mi = i+1 - pointers[i+1] + pointers[i];
+			for (int r=(mi > I0 ? mi : I0); r<i; ++r)
+				R[i] -= values[ pointers[i] + i - r]*R[r];
+		}
 	}
 
 	// calculate Vbar = D^(-1)*V
-	for (i=0; i<N; ++i) R[i] /= values[ pointers[i] ];
+	#pragma omp parallel for if (N > 4*COLSOL_SOLVE_BLOCK)
+	for (int i=0; i<N; ++i) R[i] /= values[ pointers[i] ];
 
 	// calculate the solution
-	for (i=N-1; i>0; --i)
+	for (int I1=N; I1>1; I1 -= COLSOL_SOLVE_BLOCK)
 	{
-		mi = i+1 - pointers[i+1] + pointers[i];
+		const int I0 = (I1 - COLSOL_SOLVE_BLOCK > 1 ? I1 - COLSOL_SOLVE_BLOCK : 1);
 
-		const double ri = R[i];
-		const int pi = pointers[i] + i;
+		// update the rows inside the block
+		int m0 = I0;
+		for (int i=I1-1; i>=I0; --i)
+		{
+			const int mi = i+1 - pointers[i+1] + pointers[i];
+			if (mi < m0) m0 = mi;
 
-		// the following line was replaced
-		// by the code segment between the arrows
-//		for (r=mi; r<i; ++r) R[r] -= values[ pointers[i] + i - r]*R[i];
+			const double ri = R[i];
+			const int pi = pointers[i] + i;
+			for (int r=(mi > I0 ? mi : I0); r<i; ++r) R[r] -= values[ pi - r]*ri;
+		}
 
-//--------->
-		for (r=mi; r<i-7; r += 8) 
+		// update the rows above the block. Each thread processes a range of rows, 
+		// which receive the block's contributions in the same order as above.
+		const int nr = I0 - m0;
+		const int nchunks = (nr + COLSOL_SOLVE_BLOCK - 1) / COLSOL_SOLVE_BLOCK;
+		#pragma omp parallel for schedule(static) if (nchunks > 1)
+		for (int n=0; n<nchunks; ++n)
 		{
-			R[r  ] -= values[ pi - r  ]*ri;
-			R[r+1] -= values[ pi - r-1]*ri;
-			R[r+2] -= values[ pi - r-2]*ri;
-			R[r+3] -= values[ pi - r-3]*ri;
-			R[r+4] -= values[ pi - r-4]*ri;
-			R[r+5] -= values[ pi - r-5]*ri;
-			R[r+6] -= values[ pi - r-6]*ri;
-			R[r+7] -= values[ pi - r-7]*ri;
+			const int r0 = m0 + n*COLSOL_SOLVE_BLOCK;
+			const int r1 = (r0 + COLSOL_SOLVE_BLOCK < I0 ? r0 + COLSOL_SOLVE_BLOCK : I0);
+			for (int i=I1-1; i>=I0; --i)
+			{
+				const int mi = i+1 - pointers[i+1] + pointers[i];
+				const double ri = R[i];
+				const int pi = pointers[i] + i;
+				for (int r=(mi > r0 ? mi : r0); r<r1; ++r) R[r] -= values[ pi - r]*ri;
+			}
 		}
-
-		for (r=0; r<(i-mi)%8; ++r)
-			R[(i-1)- r] -= values[ pi - (i-1) + r  ]*ri;
-//--------->
 	}
 }
 
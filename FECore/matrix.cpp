@@ -82,6 +82,7 @@ void matrix::alloc(int nr, int nc)
 	m_nr = nr;
 	m_nc = nc;
 	m_nsize = nr*nc;
+	m_bext = false;
 
 	m_pd = new double [m_nsize];
 	m_pr = new double*[nr];
@@ -99,11 +100,15 @@ matrix::matrix(int nr, int nc)
 //! matrix destructor
 void matrix::clear()
 {
-	if (m_pr) delete [] m_pr;
-	if (m_pd) delete [] m_pd;
+	if (m_bext == false)
+	{
+		if (m_pr) delete [] m_pr;
+		if (m_pd) delete [] m_pd;
+	}
 	m_pd = 0;
 	m_pr = 0;
-	m_nr = m_nc = 0;
+	m_nr = m_nc = m_nsize = 0;
+	m_bext = false;
 }
 
 //-----------------------------------------------------------------------------
@@ -158,6 +163,19 @@ void matrix::resize(int nr, int nc)
 	}
 }
 
+//-----------------------------------------------------------------------------
+void matrix::attach(double* pd, double** pr, int nr, int nc)
+{
+	clear();
+	m_nr = nr;
+	m_nc = nc;
+	m_nsize = nr*nc;
+	m_pd = pd;
+	m_pr = pr;
+	m_bext = true;
+	for (int i = 0; i < nr; i++) m_pr[i] = m_pd + i*nc;
+}
+
 //-----------------------------------------------------------------------------
 matrix matrix::operator * (double a) const
 {
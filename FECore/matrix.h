@@ -39,7 +39,7 @@ class FECORE_API matrix
 {
 public:
 	//! constructor
-	matrix() : m_nr(0), m_nc(0), m_nsize(0), m_pd(nullptr), m_pr(nullptr) {}
+	matrix() : m_nr(0), m_nc(0), m_nsize(0), m_pd(nullptr), m_pr(nullptr), m_bext(false) {}
 
 	//! constructor
 	matrix(int nr, int nc);
@@ -65,6 +65,11 @@ public:
 	//! Matrix reallocation
 	void resize(int nr, int nc);
 
+	//! Use external storage for the values (nr*nc doubles) and the row pointers (nr pointers). 
+	//! The storage is not released by the matrix and must remain valid while the matrix uses it.
+	//! Resizing the matrix to a different size switches back to internal storage.
+	void attach(double* pd, double** pr, int nr, int nc);
+
 	//! destructor
 	~matrix() { clear(); }
 
@@ -198,6 +203,8 @@ protected:
 	int	m_nr;		// nr of rows
 	int	m_nc;		// nr of columns
 	int	m_nsize;	// size of matrix (ie. total nr of elements = nr*nc)
+
+	bool	m_bext;	// storage is external (see attach)
 };
 
 vector<double> FECORE_API operator / (vector<double>& b, matrix& m);
@@ -301,11 +308,15 @@ inline matrix::matrix(matrix&& m)
 {
 	m_nr = m.m_nr;
 	m_nc = m.m_nc;
+	m_nsize = m.m_nsize;
 	m_pd = m.m_pd;
 	m_pr = m.m_pr;
+	m_bext = m.m_bext;
 
 	m.m_pr = nullptr;
 	m.m_pd = nullptr;
+	m.m_nr = m.m_nc = m.m_nsize = 0;
+	m.m_bext = false;
 }
 
 //! move assigment operator
@@ -313,16 +324,19 @@ inline matrix& matrix::operator = (matrix&& m)
 {
 	if (this != &m)
 	{
-		if (m_pd) delete[] m_pd;
-		if (m_pr) delete[] m_pr;
+		clear();
 
 		m_nr = m.m_nr;
 		m_nc = m.m_nc;
+		m_nsize = m.m_nsize;
 		m_pd = m.m_pd;
 		m_pr = m.m_pr;
+		m_bext = m.m_bext;
 
 		m.m_pr = nullptr;
 		m.m_pd = nullptr;
+		m.m_nr = m.m_nc = m.m_nsize = 0;
+		m.m_bext = false;
 	}
 
 	return *this;
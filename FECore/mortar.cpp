@@ -31,6 +31,7 @@ SOFTWARE.*/
 #include "mortar.h"
 #include <math.h>
 #include "FEMesh.h"
+#include <algorithm>
 
 //-----------------------------------------------------------------------------
 // subtract operator for POINT2D
@@ -541,31 +542,264 @@ bool CalculateMortarIntersection(FESurface& ss, FESurface& ms, int k, int l, Pat
 	return (patch.Empty() == false);
 }
 
-void CalculateMortarSurface(FESurface& ss, FESurface& ms, MortarSurface& mortar)
+//-----------------------------------------------------------------------------
+// Axis-aligned bounding box of a surface facet, used by the broad phase
+struct FACET_BOX
 {
-	// loop over all non-mortar facets
-	int NSF = ss.Elements();
-	int NMF = ms.Elements();
-	for (int i=0; i<NSF; ++i)
+	vec3d	r0, r1;
+
+	bool Intersects(const FACET_BOX& b) const
+	{
+		return ((r0.x <= b.r1.x) && (b.r0.x <= r1.x) &&
+				(r0.y <= b.r1.y) && (b.r0.y <= r1.y) &&
+				(r0.z <= b.r1.z) && (b.r0.z <= r1.z));
+	}
+
+	void Add(const FACET_BOX& b)
+	{
+		r0.x = (b.r0.x < r0.x ? b.r0.x : r0.x); r1.x = (b.r1.x > r1.x ? b.r1.x : r1.x);
+		r0.y = (b.r0.y < r0.y ? b.r0.y : r0.y); r1.y = (b.r1.y > r1.y ? b.r1.y : r1.y);
+		r0.z = (b.r0.z < r0.z ? b.r0.z : r0.z); r1.z = (b.r1.z > r1.z ? b.r1.z : r1.z);
+	}
+};
+
+//-----------------------------------------------------------------------------
+// calculate the bounding box of a facet, inflated by its largest dimension and
+// the search radius
+static FACET_BOX FacetBox(FESurface& s, FESurfaceElement& el, double searchRadius, bool inflate)
+{
+	FACET_BOX b;
+	b.r0 = b.r1 = s.Node(el.m_lnode[0]).m_rt;
+	int ne = el.Nodes();
+	for (int i=1; i<ne; ++i)
+	{
+		vec3d& r = s.Node(el.m_lnode[i]).m_rt;
+		if (r.x < b.r0.x) b.r0.x = r.x;
+		if (r.x > b.r1.x) b.r1.x = r.x;
+		if (r.y < b.r0.y) b.r0.y = r.y;
+		if (r.y > b.r1.y) b.r1.y = r.y;
+		if (r.z < b.r0.z) b.r0.z = r.z;
+		if (r.z > b.r1.z) b.r1.z = r.z;
+	}
+
+	if (inflate)
+	{
+		double w = b.r1.x - b.r0.x;
+		double h = b.r1.y - b.r0.y;
+		double d = b.r1.z - b.r0.z;
+		double R = (w > h ? w : h);
+		if (d > R) R = d;
+		R += searchRadius;
+		b.r0 -= vec3d(R, R, R);
+		b.r1 += vec3d(R, R, R);
+	}
+	return b;
+}
+
+//-----------------------------------------------------------------------------
+// Bounding volume hierarchy over the facets of a surface. The tree is built by
+// recursively splitting the facets at the median of the longest box axis.
+class FacetBVH
+{
+	struct NODE
+	{
+		FACET_BOX	box;
+		int			child;	// index of first child, or -1 for a leaf
+		int			first;	// first item (leaves only)
+		int			count;	// number of items (leaves only)
+	};
+
+	enum { MAX_LEAF_SIZE = 4 };
+
+public:
+	void Build(FESurface& s, double searchRadius)
+	{
+		int NF = s.Elements();
+		m_box.resize(NF);
+		m_item.resize(NF);
+		m_cen.resize(NF);
+		for (int i=0; i<NF; ++i)
+		{
+			m_box[i] = FacetBox(s, s.Element(i), searchRadius, true);
+			m_cen[i] = (m_box[i].r0 + m_box[i].r1)*0.5;
+			m_item[i] = i;
+		}
+
+		m_node.clear();
+		m_node.reserve(2*NF);
+		if (NF > 0)
+		{
+			m_node.push_back(NODE());
+			BuildNode(0, 0, NF);
+		}
+	}
+
+	// find all the facets whose boxes intersect b
+	void Find(const FACET_BOX& b, vector<int>& hits) const
+	{
+		hits.clear();
+		if (m_node.empty()) return;
+
+		int stack[64];
+		int ns = 0;
+		stack[ns++] = 0;
+		while (ns > 0)
+		{
+			const NODE& n = m_node[stack[--ns]];
+			if (n.box.Intersects(b) == false) continue;
+			if (n.child < 0)
+			{
+				for (int i=0; i<n.count; ++i)
+				{
+					int k = m_item[n.first + i];
+					if (m_box[k].Intersects(b)) hits.push_back(k);
+				}
+			}
+			else
+			{
+				stack[ns++] = n.child;
+				stack[ns++] = n.child + 1;
+			}
+		}
+
+		// report the facets in order, so the patches are always generated in the same order
+		std::sort(hits.begin(), hits.end());
+	}
+
+private:
+	void BuildNode(int nid, int first, int count)
 	{
-		// get the non-mortar surface element
-		FESurfaceElement& se = ss.Element(i);
+		FACET_BOX box = m_box[m_item[first]];
+		for (int i=1; i<count; ++i) box.Add(m_box[m_item[first + i]]);
+		m_node[nid].box = box;
+		m_node[nid].child = -1;
+		m_node[nid].first = first;
+		m_node[nid].count = count;
+		if (count <= MAX_LEAF_SIZE) return;
+
+		// split at the median along the longest axis
+		vec3d d = box.r1 - box.r0;
+		int axis = ((d.x >= d.y) && (d.x >= d.z) ? 0 : (d.y >= d.z ? 1 : 2));
+		const vector<vec3d>& cen = m_cen;
+		int* pi = &m_item[0];
+		std::nth_element(pi + first, pi + first + count/2, pi + first + count, [&cen, axis](int a, int b) {
+			return (axis == 0 ? cen[a].x < cen[b].x : (axis == 1 ? cen[a].y < cen[b].y : cen[a].z < cen[b].z));
+		});
+
+		// children are stored next to each other
+		int child = (int) m_node.size();
+		m_node.push_back(NODE());
+		m_node.push_back(NODE());
+		m_node[nid].child = child;
+		BuildNode(child    , first          , count/2);
+		BuildNode(child + 1, first + count/2, count - count/2);
+	}
+
+private:
+	vector<NODE>		m_node;
+	vector<int>			m_item;
+	vector<FACET_BOX>	m_box;
+	vector<vec3d>		m_cen;
+};
+
+//-----------------------------------------------------------------------------
+void CalculateMortarSurface(FESurface& ss, FESurface& ms, MortarSurface& mortar, double searchRadius)
+{
+	int NSF = ss.Elements();
+
+	// build the broad phase search structure over the mortar facets
+	FacetBVH bvh;
+	bvh.Build(ms, searchRadius);
 
-		// loop over all the mortar surface elements
-		for (int j=0; j<NMF; ++j)
+	// calculate the patches of all the non-mortar facets in parallel
+	vector< vector<Patch> > patches(NSF);
+#pragma omp parallel
+	{
+		vector<int> cand;
+#pragma omp for schedule(dynamic, 16)
+		for (int i=0; i<NSF; ++i)
 		{
-			// get the next surface element
-			FESurfaceElement& me = ms.Element(j);
+			// get the non-mortar surface element
+			FESurfaceElement& se = ss.Element(i);
+
+			// find the mortar facets that are close to this facet
+			FACET_BOX box = FacetBox(ss, se, searchRadius, false);
+			bvh.Find(box, cand);
 
 			// calculate the patch of triangles, representing the intersection
 			// of the non-mortar facet with the mortar facet
-			Patch patch(i,j);
-			CalculateMortarIntersection(ss, ms, i, j, patch);
-			mortar.AddPatch(patch);
+			for (size_t n=0; n<cand.size(); ++n)
+			{
+				Patch patch(i, cand[n]);
+				if (CalculateMortarIntersection(ss, ms, i, cand[n], patch)) patches[i].push_back(patch);
+			}
 		}
 	}
+
+	// collect the patches
+	for (int i=0; i<NSF; ++i)
+	{
+		vector<Patch>& pi = patches[i];
+		for (size_t j=0; j<pi.size(); ++j) mortar.AddPatch(pi[j]);
+	}
 }
 
+//=============================================================================
+// MortarWeights
+//=============================================================================
+
+//-----------------------------------------------------------------------------
+void MortarWeights::Create(int rows)
+{
+	m_row.resize(rows);
+	for (int i=0; i<rows; ++i) m_row[i].clear();
+}
+
+//-----------------------------------------------------------------------------
+void MortarWeights::Add(int i, int j, double v)
+{
+	ROW& row = m_row[i];
+	for (size_t n=0; n<row.size(); ++n)
+	{
+		if (row[n].col == j) { row[n].val += v; return; }
+	}
+
+	ENTRY e = {j, v};
+	row.push_back(e);
+}
+
+//-----------------------------------------------------------------------------
+double MortarWeights::get(int i, int j) const
+{
+	const ROW& row = m_row[i];
+	for (size_t n=0; n<row.size(); ++n)
+	{
+		if (row[n].col == j) return row[n].val;
+	}
+	return 0.0;
+}
+
+//-----------------------------------------------------------------------------
+int MortarWeights::NonZeroes() const
+{
+	int nnz = 0;
+	for (size_t i=0; i<m_row.size(); ++i) nnz += (int) m_row[i].size();
+	return nnz;
+}
+
+//-----------------------------------------------------------------------------
+double MortarWeights::Sum() const
+{
+	double sum = 0.0;
+	for (size_t i=0; i<m_row.size(); ++i)
+	{
+		const ROW& row = m_row[i];
+		for (size_t n=0; n<row.size(); ++n) sum += row[n].val;
+	}
+	return sum;
+}
+
+//-----------------------------------------------------------------------------
 bool ExportMortar(MortarSurface& mortar, const char* szfile)
 {
 	FILE* fp = fopen(szfile, "wt");
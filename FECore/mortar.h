@@ -127,13 +127,58 @@ private:
 	vector<Patch>	m_patch;	
 };
 
+//-----------------------------------------------------------------------------
+// Sparse storage for the mortar integration weights. Each row only stores the
+// columns of the nodes that share a mortar patch with the row's node, so the
+// memory is proportional to the number of overlapping node pairs instead of NS*NM.
+class FECORE_API MortarWeights
+{
+public:
+	struct ENTRY
+	{
+		int		col;	//!< column (node) index
+		double	val;	//!< weight
+	};
+
+	typedef vector<ENTRY>	ROW;
+
+public:
+	MortarWeights(){}
+
+	//! allocate the rows and clear all entries (row capacity is kept for reuse)
+	void Create(int rows);
+
+	//! add a value to entry (i,j)
+	void Add(int i, int j, double v);
+
+	//! return the value of entry (i,j), or zero when it is not stored
+	double get(int i, int j) const;
+
+	//! number of rows
+	int Rows() const { return (int) m_row.size(); }
+
+	//! return a row
+	const ROW& Row(int i) const { return m_row[i]; }
+
+	//! total number of stored entries
+	int NonZeroes() const;
+
+	//! sum of all the weights
+	double Sum() const;
+
+private:
+	vector<ROW>	m_row;
+};
+
 //-----------------------------------------------------------------------------
 // Calculates the intersection between two segments and adds it to the patch
 FECORE_API bool CalculateMortarIntersection(FESurface& ss, FESurface& ms, int k, int l, Patch& patch);
 
 //-----------------------------------------------------------------------------
-// Calculates the mortar intersection between two surfaces
-FECORE_API void CalculateMortarSurface(FESurface& ss, FESurface& ms, MortarSurface& s);
+// Calculates the mortar intersection between two surfaces. Only facet pairs whose
+// bounding boxes overlap are intersected. Each secondary box is inflated by its own
+// size plus the search radius, so facets separated by a larger gap are ignored.
+FECORE_API void CalculateMortarSurface(FESurface& ss, FESurface& ms, MortarSurface& s, double searchRadius = 0.0);
 
 //-----------------------------------------------------------------------------
 // Stores the mortar surface in STL format
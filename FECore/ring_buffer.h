@@ -0,0 +1,127 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include <vector>
+#include <assert.h>
+
+//-----------------------------------------------------------------------------
+// Template class for storing a sequence of items in a contiguous circular
+// buffer. Items are appended at the back and removed from the front without
+// moving the remaining items. The storage grows when it is full, so the
+// caller is responsible for bounding the number of items.
+template <typename T> class ring_buffer
+{
+public:
+	// constructors
+	ring_buffer() : m_head(0), m_size(0) {}
+
+	// number of items in buffer
+	int size() const { return m_size; }
+	bool empty() const { return (m_size == 0); }
+
+	// number of items that can be stored before the buffer is reallocated
+	int capacity() const { return (int) m_data.size(); }
+
+	// remove all items (keeps the allocated storage)
+	void clear() { m_head = 0; m_size = 0; }
+
+	// allocate storage for at least n items
+	void reserve(int n)
+	{
+		if (n <= capacity()) return;
+		std::vector<T> tmp(n);
+		for (int i=0; i<m_size; ++i) tmp[i] = (*this)[i];
+		m_data.swap(tmp);
+		m_head = 0;
+	}
+
+	// resize the buffer, new items are default constructed
+	void resize(int n)
+	{
+		reserve(n);
+		for (int i=m_size; i<n; ++i) m_data[index(i)] = T();
+		m_size = n;
+	}
+
+	// add an item to the end of the buffer
+	void push_back(const T& v)
+	{
+		if (m_size == capacity()) reserve(m_size == 0 ? 4 : 2*m_size);
+		m_data[index(m_size)] = v;
+		m_size++;
+	}
+
+	// remove the first item
+	void pop_front()
+	{
+		assert(m_size > 0);
+		m_head = (m_head + 1) % capacity();
+		m_size--;
+	}
+
+	// remove the last item
+	void pop_back()
+	{
+		assert(m_size > 0);
+		m_size--;
+	}
+
+	// remove item i, shifting the items after it forward
+	void erase(int i)
+	{
+		assert((i >= 0) && (i < m_size));
+		if (i == 0) { pop_front(); return; }
+		for (int j=i; j<m_size-1; ++j) m_data[index(j)] = m_data[index(j+1)];
+		m_size--;
+	}
+
+	// access operators
+	T& operator [] (int i) { assert((i >= 0) && (i < m_size)); return m_data[index(i)]; }
+	const T& operator [] (int i) const { assert((i >= 0) && (i < m_size)); return m_data[index(i)]; }
+
+	T& front() { return (*this)[0]; }
+	const T& front() const { return (*this)[0]; }
+
+	T& back() { return (*this)[m_size - 1]; }
+	const T& back() const { return (*this)[m_size - 1]; }
+
+private:
+	// position in storage of item i
+	int index(int i) const
+	{
+		int n = m_head + i;
+		int N = capacity();
+		return (n < N ? n : n - N);
+	}
+
+private:
+	std::vector<T>	m_data;		// storage
+	int				m_head;		// position of first item
+	int				m_size;		// number of items
+};
@@ -33,10 +33,17 @@ SOFTWARE.*/
 #include "FEDofList.h"
 #include <algorithm>
 
+// The vector kernels below are memory bound, so they are only worth threading 
+// for larger vectors. 
+#define OMP_MIN_SIZE	10000
+
 double operator*(const vector<double>& a, const vector<double>& b)
 {
+	assert(a.size() == b.size());
+	const int n = (int)a.size();
 	double sum_p = 0, sum_n = 0;
-	for (size_t i = 0; i < a.size(); i++)
+#pragma omp parallel for reduction(+:sum_p,sum_n) if (n > OMP_MIN_SIZE)
+	for (int i = 0; i < n; i++)
 	{
 		double ab = a[i] * b[i];
 		if (ab >= 0.0) sum_p += ab; else sum_n += ab;
@@ -46,84 +53,127 @@ double operator*(const vector<double>& a, const vector<double>& b)
 
 vector<double> operator - (vector<double>& a, vector<double>& b)
 {
-	vector<double> c(a);
-	int n = (int) c.size();
-	for (int i=0; i<n; ++i) c[i] -= b[i];
+	vector<double> c(a.size());
+	vsub(c, a, b);
 	return c;
 }
 
 void operator += (vector<double>& a, const vector<double>& b)
 {
 	assert(a.size() == b.size());
-	for (size_t i = 0; i < a.size(); ++i) a[i] += b[i];
+	const int n = (int)a.size();
+#pragma omp parallel for if (n > OMP_MIN_SIZE)
+	for (int i = 0; i < n; ++i) a[i] += b[i];
 }
 
 void operator -= (vector<double>& a, const vector<double>& b)
 {
 	assert(a.size() == b.size());
-	for (size_t i = 0; i < a.size(); ++i) a[i] -= b[i];
+	const int n = (int)a.size();
+#pragma omp parallel for if (n > OMP_MIN_SIZE)
+	for (int i = 0; i < n; ++i) a[i] -= b[i];
 }
 
 void operator *= (vector<double>& a, double b)
 {
-	for (size_t i=0; i<a.size(); ++i) a[i] *= b;
+	const int n = (int)a.size();
+#pragma omp parallel for if (n > OMP_MIN_SIZE)
+	for (int i = 0; i < n; ++i) a[i] *= b;
 }
 
 void vcopys(vector<double>& a, const vector<double>& b, double s)
 {
 	assert(a.size() == b.size());
-	for (size_t i=0; i<a.size(); ++i) a[i] = b[i]*s;
+	const int n = (int)a.size();
+#pragma omp parallel for if (n > OMP_MIN_SIZE)
+	for (int i = 0; i < n; ++i) a[i] = b[i]*s;
 }
 
 void vadds(vector<double>& a, const vector<double>& b, double s)
 {
 	assert(a.size() == b.size());
-	for (size_t i = 0; i<a.size(); ++i) a[i] += b[i] * s;
+	const int n = (int)a.size();
+#pragma omp parallel for if (n > OMP_MIN_SIZE)
+	for (int i = 0; i < n; ++i) a[i] += b[i] * s;
 }
 
 void vsubs(vector<double>& a, const vector<double>& b, double s)
 {
 	assert(a.size() == b.size());
-	for (size_t i = 0; i<a.size(); ++i) a[i] -= b[i] * s;
+	const int n = (int)a.size();
+#pragma omp parallel for if (n > OMP_MIN_SIZE)
+	for (int i = 0; i < n; ++i) a[i] -= b[i] * s;
 }
 
 void vscale(vector<double>& a, const vector<double>& s)
 {
 	assert(a.size() == s.size());
-	for (size_t i = 0; i<a.size(); ++i) a[i] *= s[i];
+	const int n = (int)a.size();
+#pragma omp parallel for if (n > OMP_MIN_SIZE)
+	for (int i = 0; i < n; ++i) a[i] *= s[i];
 }
 
 void vsub(vector<double>& a, const vector<double>& l, const vector<double>& r)
 {
 	assert((a.size()==l.size())&&(a.size()==r.size()));
-	for (size_t i=0; i<a.size(); ++i) a[i] = l[i] - r[i];
+	const int n = (int)a.size();
+#pragma omp parallel for if (n > OMP_MIN_SIZE)
+	for (int i = 0; i < n; ++i) a[i] = l[i] - r[i];
 }
 
-vector<double> operator + (const vector<double>& a, const vector<double>& b)
+void vadd(vector<double>& a, const vector<double>& l, const vector<double>& r)
+{
+	assert(l.size() == r.size());
+	a.resize(l.size());
+	const int n = (int)a.size();
+#pragma omp parallel for if (n > OMP_MIN_SIZE)
+	for (int i = 0; i < n; ++i) a[i] = l[i] + r[i];
+}
+
+void vdot3(const vector<double>& a, const vector<double>& b, double& aa, double& ab, double& bb)
 {
 	assert(a.size() == b.size());
-	vector<double> s(a);
-	for (size_t i = 0; i < s.size(); ++i) s[i] += b[i];
+	const int n = (int)a.size();
+	double saa = 0.0, sab_p = 0.0, sab_n = 0.0, sbb = 0.0;
+#pragma omp parallel for reduction(+:saa,sab_p,sab_n,sbb) if (n > OMP_MIN_SIZE)
+	for (int i = 0; i < n; ++i)
+	{
+		double ai = a[i], bi = b[i];
+		double abi = ai*bi;
+		saa += ai*ai;
+		if (abi >= 0.0) sab_p += abi; else sab_n += abi;
+		sbb += bi*bi;
+	}
+	aa = saa;
+	ab = sab_p + sab_n;
+	bb = sbb;
+}
+
+vector<double> operator + (const vector<double>& a, const vector<double>& b)
+{
+	vector<double> s;
+	vadd(s, a, b);
 	return s;
 }
 
 vector<double> operator*(const vector<double>& a, double g)
 {
 	vector<double> s(a.size());
-	for (size_t i = 0; i < s.size(); ++i) s[i] = a[i]*g;
+	vcopys(s, a, g);
 	return s;
 }
 
 vector<double> FECORE_API operator - (const vector<double>& a)
 {
 	vector<double> s(a.size());
-	for (size_t i = 0; i < s.size(); ++i) s[i] = -a[i];
+	vcopys(s, a, -1.0);
 	return s;
 }
 
 void gather(vector<double>& v, FEMesh& mesh, int ndof)
 {
 	const int NN = mesh.Nodes();
+#pragma omp parallel for if (NN > OMP_MIN_SIZE)
 	for (int i=0; i<NN; ++i)
 	{
 		FENode& node = mesh.Node(i);
@@ -135,6 +185,7 @@ void gather(vector<double>& v, FEMesh& mesh, const vector<int>& dof)
 {
 	const int NN = mesh.Nodes();
 	const int NDOF = (const int) dof.size();
+#pragma omp parallel for if (NN > OMP_MIN_SIZE)
 	for (int i=0; i<NN; ++i)
 	{
 		FENode& node = mesh.Node(i);
@@ -149,6 +200,7 @@ void gather(vector<double>& v, FEMesh& mesh, const vector<int>& dof)
 void scatter(vector<double>& v, FEMesh& mesh, int ndof)
 {
 	const int NN = mesh.Nodes();
+#pragma omp parallel for if (NN > OMP_MIN_SIZE)
 	for (int i=0; i<NN; ++i)
 	{
 		FENode& node = mesh.Node(i);
@@ -160,10 +212,11 @@ void scatter(vector<double>& v, FEMesh& mesh, int ndof)
 void scatter3(vector<double>& v, FEMesh& mesh, int ndof1, int ndof2, int ndof3)
 {
 	const int NN = mesh.Nodes();
-	for (int i = 0, n; i<NN; ++i)
+#pragma omp parallel for if (NN > OMP_MIN_SIZE)
+	for (int i = 0; i<NN; ++i)
 	{
 		FENode& node = mesh.Node(i);
-		n = node.m_ID[ndof1]; if (n >= 0) node.set(ndof1, v[n]);
+		int n = node.m_ID[ndof1]; if (n >= 0) node.set(ndof1, v[n]);
 		n = node.m_ID[ndof2]; if (n >= 0) node.set(ndof2, v[n]);
 		n = node.m_ID[ndof3]; if (n >= 0) node.set(ndof3, v[n]);
 	}
@@ -172,6 +225,7 @@ void scatter3(vector<double>& v, FEMesh& mesh, int ndof1, int ndof2, int ndof3)
 void scatter(vector<double>& v, FEMesh& mesh, const FEDofList& dofs)
 {
 	const int NN = mesh.Nodes();
+#pragma omp parallel for if (NN > OMP_MIN_SIZE)
 	for (int i = 0; i<NN; ++i)
 	{
 		FENode& node = mesh.Node(i);
@@ -184,21 +238,22 @@ void scatter(vector<double>& v, FEMesh& mesh, const FEDofList& dofs)
 
 double l2_norm(const vector<double>& v)
 {
-	double s = 0.0;
-	for (auto vi : v) s += vi*vi;
-	return sqrt(s);
+	return sqrt(l2_sqrnorm(v));
 }
 
 double l2_sqrnorm(const vector<double>& v)
 {
+	const int n = (int)v.size();
 	double s = 0.0;
-	for (auto vi : v) s += vi*vi;
+#pragma omp parallel for reduction(+:s) if (n > OMP_MIN_SIZE)
+	for (int i = 0; i < n; ++i) s += v[i]*v[i];
 	return s;
 }
 
 double l2_norm(double* x, int n)
 {
 	double s = 0.0;
+#pragma omp parallel for reduction(+:s) if (n > OMP_MIN_SIZE)
 	for (int i = 0; i < n; ++i) s += x[i]*x[i];
 	return sqrt(s);
 }
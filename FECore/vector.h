@@ -60,6 +60,13 @@ void FECORE_API vsubs(vector<double>& a, const vector<double>& b, double s);
 // vector subtraction: a = l - r
 void FECORE_API vsub(vector<double>& a, const vector<double>& l, const vector<double>& r);
 
+// vector addition: a = l + r (a is resized if necessary)
+void FECORE_API vadd(vector<double>& a, const vector<double>& l, const vector<double>& r);
+
+// calculates the dot products a*a, a*b, and b*b in a single pass
+// (a*b sums the positive and negative terms separately, like operator *)
+void FECORE_API vdot3(const vector<double>& a, const vector<double>& b, double& aa, double& ab, double& bb);
+
 // scale each component of a vector
 void FECORE_API vscale(vector<double>& a, const vector<double>& s);
 
@@ -0,0 +1,353 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "BCSRMatrix.h"
+#include <FECore/sys.h>
+#include <algorithm>
+#include <string.h>
+
+//-----------------------------------------------------------------------------
+//! constructor
+BCSRMatrix::BCSRMatrix(bool bsymm) : m_bsymm(bsymm)
+{
+	m_nbr = m_nbc = 0;
+}
+
+//-----------------------------------------------------------------------------
+void BCSRMatrix::Zero()
+{
+	int nb = Blocks();
+	double* pv = (m_val.empty() ? nullptr : &m_val[0]);
+	#pragma omp parallel for
+	for (int i = 0; i < nb; ++i) memset(pv + 9 * i, 0, 9 * sizeof(double));
+}
+
+//-----------------------------------------------------------------------------
+void BCSRMatrix::Clear()
+{
+	m_ptr.clear();
+	m_col.clear();
+	m_dia.clear();
+	m_val.clear();
+	m_xpad.clear();
+	m_nbr = m_nbc = 0;
+
+	SparseMatrix::Clear();
+}
+
+//-----------------------------------------------------------------------------
+//! Create the block structure. A block (I,J) is allocated when any of the 
+//! entries (3I..3I+2, 3J..3J+2) appears in the profile.
+void BCSRMatrix::Create(SparseMatrixProfile& mp)
+{
+	int nr = mp.Rows();
+	int nc = mp.Columns();
+	int nbr = (nr + 2) / 3;
+	int nbc = (nc + 2) / 3;
+
+	// collect the block rows of each block column
+	vector< vector<int> > blockRows(nbc);
+	#pragma omp parallel for schedule(dynamic, 64)
+	for (int J = 0; J < nbc; ++J)
+	{
+		vector<int>& rows = blockRows[J];
+		for (int j = 3 * J; (j < 3 * J + 3) && (j < nc); ++j)
+		{
+			SparseMatrixProfile::ColumnProfile& a = mp.Column(j);
+			int n = a.size();
+			for (int k = 0; k < n; ++k)
+			{
+				int I0 = a[k].start / 3;
+				int I1 = a[k].end / 3;
+				for (int I = I0; I <= I1; ++I)
+				{
+					if (rows.empty() || (rows.back() != I)) rows.push_back(I);
+				}
+			}
+		}
+		std::sort(rows.begin(), rows.end());
+		rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+	}
+
+	// count the blocks in each block row
+	m_ptr.assign(nbr + 1, 0);
+	for (int J = 0; J < nbc; ++J)
+	{
+		const vector<int>& rows = blockRows[J];
+		for (size_t k = 0; k < rows.size(); ++k) m_ptr[rows[k] + 1]++;
+	}
+	for (int I = 0; I < nbr; ++I) m_ptr[I + 1] += m_ptr[I];
+	int nb = m_ptr[nbr];
+
+	// fill the column indices. Since we loop over the block columns in order,
+	// the column indices of each block row end up sorted.
+	m_col.resize(nb);
+	vector<int> tag(m_ptr.begin(), m_ptr.end() - 1);
+	for (int J = 0; J < nbc; ++J)
+	{
+		const vector<int>& rows = blockRows[J];
+		for (size_t k = 0; k < rows.size(); ++k) m_col[tag[rows[k]]++] = J;
+	}
+
+	// find the diagonal blocks
+	m_dia.assign(nbr, -1);
+	for (int I = 0; (I < nbr) && (I < nbc); ++I) m_dia[I] = find_block(I, I);
+
+	// allocate the values
+	m_val.assign((size_t)nb * 9, 0.0);
+
+	m_nrow = nr;
+	m_ncol = nc;
+	m_nbr = nbr;
+	m_nbc = nbc;
+	m_nsize = 9 * nb;
+}
+
+//-----------------------------------------------------------------------------
+int BCSRMatrix::find_block(int I, int J) const
+{
+	const int* c0 = &m_col[0] + m_ptr[I];
+	const int* c1 = &m_col[0] + m_ptr[I + 1];
+	const int* c = std::lower_bound(c0, c1, J);
+	if ((c != c1) && (*c == J)) return (int)(c - &m_col[0]);
+	return -1;
+}
+
+//-----------------------------------------------------------------------------
+double* BCSRMatrix::find(int i, int j)
+{
+	int n = find_block(i / 3, j / 3);
+	if (n < 0) return nullptr;
+	return &m_val[(size_t)n * 9 + 3 * (i % 3) + (j % 3)];
+}
+
+//-----------------------------------------------------------------------------
+//! Assemble an element matrix. For symmetric matrices only the lower triangular
+//! part of ke is used, which is then mirrored into the upper triangular part.
+void BCSRMatrix::Assemble(const matrix& ke, const vector<int>& lm)
+{
+	const int N = ke.rows();
+	double* pv = &m_val[0];
+	for (int i = 0; i < N; ++i)
+	{
+		int I = lm[i];
+		if (I < 0) continue;
+
+		// the equations of a node are usually consecutive in lm, so
+		// we cache the last block we found in this row
+		int I3 = I / 3, Ir = I % 3;
+		int Jb = -1, nb = -1;
+		for (int j = 0; j < N; ++j)
+		{
+			int J = lm[j];
+			if ((J < 0) || (m_bsymm && (J > I))) continue;
+
+			int J3 = J / 3;
+			if (J3 != Jb) { nb = find_block(I3, J3); Jb = J3; }
+			assert(nb >= 0);
+
+			double kij = ke[i][j];
+			#pragma omp atomic
+			pv[(size_t)nb * 9 + 3 * Ir + J % 3] += kij;
+
+			if (m_bsymm && (J != I))
+			{
+				double* pji = find(J, I);
+				#pragma omp atomic
+				*pji += kij;
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+void BCSRMatrix::Assemble(const matrix& ke, const vector<int>& lmi, const vector<int>& lmj)
+{
+	const int N = ke.rows();
+	const int M = ke.columns();
+	for (int i = 0; i < N; ++i)
+	{
+		int I = lmi[i];
+		if (I < 0) continue;
+
+		for (int j = 0; j < M; ++j)
+		{
+			int J = lmj[j];
+			if (J < 0) continue;
+
+			// only add values to lower-diagonal part for symmetric matrices
+			if (m_bsymm && (J > I)) continue;
+
+			add(I, J, ke[i][j]);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//! add a matrix item. For symmetric matrices both (i,j) and (j,i) are updated.
+void BCSRMatrix::add(int i, int j, double v)
+{
+	double* pij = find(i, j);
+	assert(pij);
+	if (pij == nullptr) return;
+
+	#pragma omp atomic
+	*pij += v;
+
+	if (m_bsymm && (i != j))
+	{
+		double* pji = find(j, i);
+		#pragma omp atomic
+		*pji += v;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//! set matrix item. For symmetric matrices both (i,j) and (j,i) are set.
+void BCSRMatrix::set(int i, int j, double v)
+{
+	double* pij = find(i, j);
+	assert(pij);
+	if (pij == nullptr) return;
+
+#pragma omp critical
+	{
+		*pij = v;
+		if (m_bsymm && (i != j)) *find(j, i) = v;
+	}
+}
+
+//-----------------------------------------------------------------------------
+double BCSRMatrix::get(int i, int j)
+{
+	double* pij = find(i, j);
+	return (pij ? *pij : 0.0);
+}
+
+//-----------------------------------------------------------------------------
+bool BCSRMatrix::check(int i, int j)
+{
+	return (find_block(i / 3, j / 3) >= 0);
+}
+
+//-----------------------------------------------------------------------------
+double BCSRMatrix::diag(int i)
+{
+	int n = m_dia[i / 3];
+	return (n >= 0 ? m_val[(size_t)n * 9 + 4 * (i % 3)] : 0.0);
+}
+
+//-----------------------------------------------------------------------------
+bool BCSRMatrix::mult_vector(double* x, double* r)
+{
+	// The last block column may extend past the end of x, so in that case
+	// we work with a zero-padded copy.
+	const double* px = x;
+	if (3 * m_nbc != m_ncol)
+	{
+		m_xpad.assign(3 * m_nbc, 0.0);
+		for (int i = 0; i < m_ncol; ++i) m_xpad[i] = x[i];
+		px = &m_xpad[0];
+	}
+
+	// every block row writes to its own rows, so the rows can be distributed over the threads.
+	int nbr = m_nbr;
+	if ((omp_get_max_threads() == 1) || (nbr < 333))
+	{
+		mult_rows(px, r, 0, nbr);
+		return true;
+	}
+
+	#pragma omp parallel
+	{
+		int nt = omp_get_num_threads();
+		int t = omp_get_thread_num();
+
+		// give each thread a range of block rows with about the same number of blocks
+		long long nb = m_ptr[nbr];
+		int I0 = (int)(std::lower_bound(m_ptr.begin(), m_ptr.end() - 1, (int)((nb*t) / nt)) - m_ptr.begin());
+		int I1 = (int)(std::lower_bound(m_ptr.begin(), m_ptr.end() - 1, (int)((nb*(t + 1)) / nt)) - m_ptr.begin());
+		if (t == nt - 1) I1 = nbr;
+		mult_rows(px, r, I0, I1);
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//! Multiply the block rows [I0, I1) with x and store the result in r.
+void BCSRMatrix::mult_rows(const double* x, double* r, int I0, int I1)
+{
+	const double* pv = (m_val.empty() ? nullptr : &m_val[0]);
+	const int* pc = (m_col.empty() ? nullptr : &m_col[0]);
+	for (int I = I0; I < I1; ++I)
+	{
+		double r0 = 0.0, r1 = 0.0, r2 = 0.0;
+		for (int n = m_ptr[I]; n < m_ptr[I + 1]; ++n)
+		{
+			const double* a = pv + 9 * (size_t)n;
+			const double* xj = x + 3 * pc[n];
+			double x0 = xj[0], x1 = xj[1], x2 = xj[2];
+			r0 += a[0] * x0 + a[1] * x1 + a[2] * x2;
+			r1 += a[3] * x0 + a[4] * x1 + a[5] * x2;
+			r2 += a[6] * x0 + a[7] * x1 + a[8] * x2;
+		}
+
+		// the last block row may extend past the end of r
+		int i = 3 * I;
+		r[i] = r0;
+		if (i + 1 < m_nrow) r[i + 1] = r1;
+		if (i + 2 < m_nrow) r[i + 2] = r2;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//! do row (L) and column (R) scaling
+void BCSRMatrix::scale(const vector<double>& L, const vector<double>& R)
+{
+	#pragma omp parallel for
+	for (int I = 0; I < m_nbr; ++I)
+	{
+		for (int n = m_ptr[I]; n < m_ptr[I + 1]; ++n)
+		{
+			double* a = &m_val[(size_t)n * 9];
+			int J = m_col[n];
+			for (int k = 0; k < 3; ++k)
+			{
+				int i = 3 * I + k;
+				if (i >= m_nrow) break;
+				for (int l = 0; l < 3; ++l)
+				{
+					int j = 3 * J + l;
+					if (j < m_ncol) a[3 * k + l] *= L[i] * R[j];
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,121 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include <FECore/SparseMatrix.h>
+
+//=============================================================================
+//! This class stores a sparse matrix in block compressed row format, where each 
+//! block is a dense 3x3 matrix.
+
+//! The blocks are formed by groups of three consecutive equations. For displacement
+//! problems these are the x,y,z dofs of a node, so the blocks are fully populated
+//! and only one column index needs to be stored for every nine matrix entries.
+//! Both the upper and lower triangular parts are stored, even for symmetric matrices, 
+//! so that the matrix-vector product can be done row-by-row without write conflicts.
+//! For symmetric matrices, the add and set functions update both (i,j) and (j,i), and
+//! only the lower triangular part of the element matrices is assembled (and mirrored),
+//! which is consistent with the CompactSymmMatrix.
+
+class BCSRMatrix : public SparseMatrix
+{
+public:
+	//! constructor
+	BCSRMatrix(bool bsymm = true);
+
+public: // from SparseMatrix
+
+	//! set all matrix elements to zero
+	void Zero() override;
+
+	//! release memory
+	void Clear() override;
+
+	//! Create the matrix structure from the SparseMatrixProfile.
+	void Create(SparseMatrixProfile& mp) override;
+
+	//! Assemble an element matrix into the global matrix
+	void Assemble(const matrix& ke, const vector<int>& lm) override;
+
+	//! assemble a matrix into the sparse matrix
+	void Assemble(const matrix& ke, const vector<int>& lmi, const vector<int>& lmj) override;
+
+	//! add a matrix item
+	void add(int i, int j, double v) override;
+
+	//! set matrix item
+	void set(int i, int j, double v) override;
+
+	//! get a matrix item
+	double get(int i, int j) override;
+
+	//! see if a matrix element is defined
+	bool check(int i, int j) override;
+
+	//! return the diagonal component
+	double diag(int i) override;
+
+	//! multiply with vector
+	bool mult_vector(double* x, double* r) override;
+
+	//! do row (L) and column (R) scaling
+	void scale(const vector<double>& L, const vector<double>& R) override;
+
+	//! is the matrix symmetric or not
+	bool isSymmetric() const { return m_bsymm; }
+
+	//! this is a row based format
+	bool isRowBased() const { return true; }
+
+public:
+	//! number of block rows
+	int BlockRows() const { return m_nbr; }
+
+	//! number of blocks
+	int Blocks() const { return (int)m_col.size(); }
+
+private:
+	//! find the block (I,J), returns -1 if the block does not exist
+	int find_block(int I, int J) const;
+
+	//! return a pointer to the value of entry (i,j), or null if the entry was not allocated
+	double* find(int i, int j);
+
+	//! multiply a range of block rows with a vector
+	void mult_rows(const double* x, double* r, int I0, int I1);
+
+private:
+	bool	m_bsymm;			//!< symmetric flag
+	int		m_nbr, m_nbc;		//!< number of block rows and columns
+
+	vector<int>		m_ptr;		//!< offset of first block of each block row (size m_nbr + 1)
+	vector<int>		m_col;		//!< block column index of each block
+	vector<int>		m_dia;		//!< index of the diagonal block of each block row (or -1)
+	vector<double>	m_val;		//!< block values (9 per block, row major)
+	vector<double>	m_xpad;		//!< padded copy of x in mult_vector when the column count is not a multiple of 3
+};
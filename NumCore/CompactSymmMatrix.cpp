@@ -28,6 +28,8 @@ SOFTWARE.*/
 
 #include "stdafx.h"
 #include "CompactSymmMatrix.h"
+#include <FECore/sys.h>
+#include <algorithm>
 
 //-----------------------------------------------------------------------------
 //! constructor
@@ -43,11 +45,65 @@ bool CompactSymmMatrix::mult_vector(double* x, double* r)
 	int N = Rows();
 	int M = Columns();
 
-	// zero result vector
-	for (int j = 0; j<N; ++j) r[j] = 0.0;
+	// for small matrices or a single thread we do the product serially
+	int nthreads = omp_get_max_threads();
+	if ((nthreads == 1) || (N < 1000))
+	{
+		// zero result vector
+		for (int j = 0; j<N; ++j) r[j] = 0.0;
+
+		mult_columns(x, r, 0, M);
+		return true;
+	}
+
+	// Each thread multiplies a range of columns with about the same number of nonzeroes.
+	// Since the columns scatter into the rows below the diagonal, the threads accumulate
+	// into their own partial result vectors, which are summed afterwards.
+	m_work.resize((size_t)nthreads*N);
+	vector<int> col(nthreads + 1, M);
+	double* w = &m_work[0];
+
+	#pragma omp parallel shared(col)
+	{
+		int nt = omp_get_num_threads();
+		int t = omp_get_thread_num();
+
+		// find the first column of this thread
+		long long nnz = m_ppointers[M] - m_ppointers[0];
+		long long n0 = m_ppointers[0] + (nnz*t) / nt;
+		int j0 = (int)(std::lower_bound(m_ppointers, m_ppointers + M, n0) - m_ppointers);
+		col[t] = j0;
+		#pragma omp barrier
+
+		// multiply the columns of this thread
+		int j1 = (t < nt - 1 ? col[t + 1] : M);
+		double* y = w + (size_t)t*N;
+		for (int i = j0; i < N; ++i) y[i] = 0.0;
+		mult_columns(x, y, j0, j1);
+		#pragma omp barrier
+
+		// add the partial results. Thread k only wrote to rows >= col[k]
+		#pragma omp for
+		for (int i = 0; i < N; ++i)
+		{
+			double ri = 0.0;
+			for (int k = 0; k < nt; ++k)
+			{
+				if (col[k] <= i) ri += w[(size_t)k*N + i];
+			}
+			r[i] = ri;
+		}
+	}
+
+	return true;
+}
 
+//-----------------------------------------------------------------------------
+//! Multiply the columns [j0, j1) with x and add the result to r.
+void CompactSymmMatrix::mult_columns(double* x, double* r, int j0, int j1)
+{
 	// loop over all columns
-	for (int j = 0; j<M; ++j)
+	for (int j = j0; j<j1; ++j)
 	{
 		double* pv = m_pd + m_ppointers[j] - m_offset;
 		int* pi = m_pindices + m_ppointers[j] - m_offset;
@@ -90,8 +146,6 @@ bool CompactSymmMatrix::mult_vector(double* x, double* r)
 
 		r[j] += rj;
 	}
-
-	return true;
 }
 
 //-----------------------------------------------------------------------------
@@ -104,13 +158,15 @@ void CompactSymmMatrix::Create(SparseMatrixProfile& mp)
 
 	// allocate pointers to column offsets
 	int* pointers = new int[nc + 1];
-	for (int i = 0; i <= nc; ++i) pointers[i] = 0;
+	pointers[nc] = 0;
 
-	int nsize = 0;
+	// count the lower-triangular entries in each column
+	#pragma omp parallel for
 	for (int i = 0; i<nc; ++i)
 	{
 		SparseMatrixProfile::ColumnProfile& a = mp.Column(i);
 		int n = (int)a.size();
+		int ncol = 0;
 		for (int j = 0; j<n; j++)
 		{
 			int a0 = a[j].start;
@@ -120,28 +176,31 @@ void CompactSymmMatrix::Create(SparseMatrixProfile& mp)
 			if (a1 >= i)
 			{
 				if (a0 < i) a0 = i;
-				int asize = a1 - a0 + 1;
-				nsize += asize;
-				pointers[i] += asize;
+				ncol += a1 - a0 + 1;
 			}
 		}
+		pointers[i] = ncol;
 	}
 
-	// allocate indices which store row index for each matrix element
-	int* pindices = new int[nsize];
-	int m = 0;
+	// convert counts to offsets
+	int nsize = 0;
 	for (int i = 0; i <= nc; ++i)
 	{
 		int n = pointers[i];
-		pointers[i] = m;
-		m += n;
+		pointers[i] = nsize;
+		nsize += n;
 	}
 
+	// allocate indices which store row index for each matrix element
+	int* pindices = new int[nsize];
+
+	// fill the indices
+	#pragma omp parallel for
 	for (int i = 0; i<nc; ++i)
 	{
 		SparseMatrixProfile::ColumnProfile& a = mp.Column(i);
 		int n = (int)a.size();
-		int nval = 0;
+		int* pi = pindices + pointers[i];
 		for (int j = 0; j<n; j++)
 		{
 			int a0 = a[j].start;
@@ -151,11 +210,7 @@ void CompactSymmMatrix::Create(SparseMatrixProfile& mp)
 			if (a1 >= i)
 			{
 				if (a0 < i) a0 = i;
-				for (int k = a0; k <= a1; ++k)
-				{
-					pindices[pointers[i] + nval] = k;
-					++nval;
-				}
+				for (int k = a0; k <= a1; ++k) *pi++ = k;
 			}
 		}
 	}
@@ -85,4 +85,11 @@ public:
 
 	//! do row (L) and column (R) scaling
 	void scale(const vector<double>& L, const vector<double>& R) override;
+
+private:
+	//! multiply a range of columns with a vector
+	void mult_columns(double* x, double* r, int j0, int j1);
+
+private:
+	vector<double>	m_work;	//!< partial products of the threads in mult_vector
 };
@@ -29,6 +29,9 @@ SOFTWARE.*/
 #include "stdafx.h"
 #include "RCICGSolver.h"
 #include "IncompleteCholesky.h"
+#include "BCSRMatrix.h"
+#include <FECore/Preconditioner.h>
+#include <math.h>
 
 //-----------------------------------------------------------------------------
 // We must undef PARDISO since it is defined as a function in mkl_solver.h
@@ -47,6 +50,7 @@ BEGIN_FECORE_CLASS(RCICGSolver, IterativeLinearSolver)
 	ADD_PARAMETER(m_tol, "tol");
 	ADD_PARAMETER(m_maxiter, "max_iter");
 	ADD_PARAMETER(m_fail_max_iters, "fail_max_iters");
+	ADD_PARAMETER(m_bblock, "block_matrix");
 	ADD_PROPERTY(m_P, "pc_left");
 END_FECORE_CLASS();
 
@@ -57,18 +61,20 @@ RCICGSolver::RCICGSolver(FEModel* fem) : IterativeLinearSolver(fem), m_pA(0), m_
 	m_tol = 1e-5;
 	m_print_level = 0;
 	m_fail_max_iters = true;
+	m_bblock = false;
 }
 
 //-----------------------------------------------------------------------------
 SparseMatrix* RCICGSolver::CreateSparseMatrix(Matrix_Type ntype)
 {
-#ifdef MKL_ISS
 	if (ntype != REAL_SYMMETRIC) return 0;
-	m_pA = new CompactSymmMatrix(1);
+
+	// The 3x3 block matrix is meant for displacement problems, where the equations
+	// of a node are numbered consecutively. It can only be combined with preconditioners
+	// that do not require a specific matrix format (e.g. the diagonal preconditioner).
+	if (m_bblock) m_pA = new BCSRMatrix(true);
+	else m_pA = new CompactSymmMatrix(1);
 	return m_pA;
-#else
-	return 0;
-#endif
 }
 
 //-----------------------------------------------------------------------------
@@ -106,6 +112,16 @@ bool RCICGSolver::PreProcess()
 bool RCICGSolver::Factor()
 {
 	if (m_pA == 0) return false;
+
+	// setup the preconditioner
+	if (m_P)
+	{
+		Preconditioner* P = dynamic_cast<Preconditioner*>(m_P);
+		if (P && (P->GetSparseMatrix() == nullptr)) P->SetSparseMatrix(m_pA);
+		if (m_P->PreProcess() == false) return false;
+		if (m_P->Factor() == false) return false;
+	}
+
 	return true;
 }
 
@@ -208,7 +224,97 @@ bool RCICGSolver::BackSolve(double* x, double* b)
 
 	return (m_fail_max_iters ? bsuccess : true);
 #else
-	return false;
+	// make sure we have a matrix
+	if (m_pA == 0) return false;
+
+	// Without MKL, we use our own implementation of the preconditioned CG method.
+	// This only requires the mult_vector function of the matrix, so it also works
+	// with matrix-free operators.
+	int n = m_pA->Rows();
+	int maxiter = (m_maxiter > 0 ? m_maxiter : (n < 150 ? n : 150));
+
+	vector<double> r(n), z(n), p(n), q(n);
+
+	// initial guess is zero, so r = b
+	double norm0 = 0.0;
+#pragma omp parallel for reduction(+:norm0)
+	for (int i = 0; i < n; ++i)
+	{
+		x[i] = 0.0;
+		r[i] = b[i];
+		norm0 += b[i] * b[i];
+	}
+	norm0 = sqrt(norm0);
+	if (norm0 == 0.0) return true;
+
+	// z = P*r
+	if (m_P) m_P->mult_vector(&r[0], &z[0]); else z = r;
+	p = z;
+
+	double rz = 0.0;
+#pragma omp parallel for reduction(+:rz)
+	for (int i = 0; i < n; ++i) rz += r[i] * z[i];
+
+	bool bsuccess = false;
+	int niter = 0;
+	double normr = norm0;
+	while (niter < maxiter)
+	{
+		// q = A*p
+		if (m_pA->mult_vector(&p[0], &q[0]) == false) break;
+		niter++;
+
+		double pq = 0.0;
+#pragma omp parallel for reduction(+:pq)
+		for (int i = 0; i < n; ++i) pq += p[i] * q[i];
+		if (pq == 0.0) break;
+		double alpha = rz / pq;
+
+		// update solution and residual
+		double rr = 0.0;
+#pragma omp parallel for reduction(+:rr)
+		for (int i = 0; i < n; ++i)
+		{
+			x[i] += alpha*p[i];
+			r[i] -= alpha*q[i];
+			rr += r[i] * r[i];
+		}
+		normr = sqrt(rr);
+
+		if (m_print_level == 1)
+		{
+			fprintf(stderr, "%3d = %lg (%lg)\n", niter, normr, norm0);
+		}
+
+		// check convergence
+		if (normr <= m_tol*norm0)
+		{
+			bsuccess = true;
+			break;
+		}
+
+		// z = P*r
+		if (m_P) m_P->mult_vector(&r[0], &z[0]); else z = r;
+
+		double rz_new = 0.0;
+#pragma omp parallel for reduction(+:rz_new)
+		for (int i = 0; i < n; ++i) rz_new += r[i] * z[i];
+
+		double beta = rz_new / rz;
+		rz = rz_new;
+
+#pragma omp parallel for
+		for (int i = 0; i < n; ++i) p[i] = z[i] + beta*p[i];
+	}
+
+	if (m_print_level > 0)
+	{
+		fprintf(stderr, "%3d = %lg (%lg)\n", niter, normr, norm0);
+	}
+
+	UpdateStats(niter);
+
+	return (m_fail_max_iters ? bsuccess : true);
 #endif // MKL_ISS
 }
 
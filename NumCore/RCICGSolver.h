@@ -28,6 +28,7 @@ SOFTWARE.*/
 #include "CompactSymmMatrix.h"
 
 // This class implements an interface to the RCI CG iterative solver from the MKL math library.
+// When MKL is not available, a native implementation of the preconditioned CG method is used.
 class RCICGSolver : public IterativeLinearSolver
 {
 public:
@@ -59,6 +60,7 @@ protected:
 	double	m_tol;			// residual relative tolerance
 	int		m_print_level;	// output level
 	bool	m_fail_max_iters;
+	bool	m_bblock;			// use 3x3 block sparse matrix
 
 	DECLARE_FECORE_CLASS();
 };
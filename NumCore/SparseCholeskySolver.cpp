@@ -0,0 +1,889 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "SparseCholeskySolver.h"
+#include <FECore/log.h>
+#include <FECore/sys.h>
+#include <algorithm>
+
+//-----------------------------------------------------------------------------
+// Nested dissection ordering of the graph of a symmetric matrix. 
+// The graph is split recursively with separators that are taken from the middle 
+// level of a breadth-first level structure rooted at a pseudo-peripheral vertex.
+// Vertices with identical adjacency (i.e. the degrees of freedom of a node) are 
+// merged first, which reduces the graph size considerably for FE matrices.
+class NestedDissection
+{
+public:
+	// The graph is given in compressed row format (without the diagonal)
+	NestedDissection(int n, const vector<int>& xadj, const vector<int>& adj);
+
+	// calculate the ordering (new to old)
+	void Apply(vector<int>& perm);
+
+private:
+	void Compress();
+	int BFS(int root, int label, vector<int>& list, vector<int>& levelPtr);
+	void Dissect(vector<int>& nodes, int label);
+
+private:
+	int					m_n;
+	const vector<int>&	m_xadj;
+	const vector<int>&	m_adj;
+
+	// compressed graph
+	int			m_nc;
+	vector<int>	m_cxadj, m_cadj;
+	vector<int>	m_vptr, m_var;	// vertices of each compressed vertex
+	vector<int>	m_wgt;			// weight (nr of vertices) of each compressed vertex
+
+	vector<int>	m_label;
+	vector<int>	m_lvl;
+	vector<int>	m_order;
+	int			m_nextLabel;
+};
+
+//-----------------------------------------------------------------------------
+NestedDissection::NestedDissection(int n, const vector<int>& xadj, const vector<int>& adj) : m_n(n), m_xadj(xadj), m_adj(adj)
+{
+	m_nc = 0;
+	m_nextLabel = 0;
+}
+
+//-----------------------------------------------------------------------------
+// merge consecutive vertices that have the same adjacency (including themselves)
+void NestedDissection::Compress()
+{
+	vector<int> cid(m_n);
+	m_vptr.clear();
+	m_var.resize(m_n);
+	m_nc = 0;
+	for (int i = 0; i < m_n; ++i)
+	{
+		bool bsame = false;
+		if (i > 0)
+		{
+			// the lists are sorted, so the adjacency of i-1 without i must equal 
+			// the adjacency of i without i-1
+			int a0 = m_xadj[i - 1], a1 = m_xadj[i];
+			int b0 = m_xadj[i], b1 = m_xadj[i + 1];
+			if ((a1 - a0 == b1 - b0) && (a1 > a0))
+			{
+				bsame = true;
+				int ka = a0, kb = b0;
+				while (bsame && ((ka < a1) || (kb < b1)))
+				{
+					if ((ka < a1) && (m_adj[ka] == i)) { ka++; continue; }
+					if ((kb < b1) && (m_adj[kb] == i - 1)) { kb++; continue; }
+					if ((ka >= a1) || (kb >= b1) || (m_adj[ka] != m_adj[kb])) bsame = false;
+					else { ka++; kb++; }
+				}
+				// i-1 and i must be connected
+				if (bsame && (std::binary_search(m_adj.begin() + b0, m_adj.begin() + b1, i - 1) == false)) bsame = false;
+			}
+		}
+
+		if (bsame == false) { m_vptr.push_back(i); m_nc++; }
+		cid[i] = m_nc - 1;
+		m_var[i] = i;
+	}
+	m_vptr.push_back(m_n);
+
+	m_wgt.resize(m_nc);
+	for (int i = 0; i < m_nc; ++i) m_wgt[i] = m_vptr[i + 1] - m_vptr[i];
+
+	// build the compressed graph (from the first vertex of each compressed vertex)
+	m_cxadj.assign(m_nc + 1, 0);
+	m_cadj.clear();
+	for (int i = 0; i < m_nc; ++i)
+	{
+		int v = m_vptr[i];
+		int last = -1;
+		for (int k = m_xadj[v]; k < m_xadj[v + 1]; ++k)
+		{
+			int c = cid[m_adj[k]];
+			if ((c != i) && (c != last)) { m_cadj.push_back(c); last = c; }
+		}
+		m_cxadj[i + 1] = (int)m_cadj.size();
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Breadth-first search of the vertices with the given label. The vertices must have
+// their level set to -1. Returns the number of levels.
+int NestedDissection::BFS(int root, int label, vector<int>& list, vector<int>& levelPtr)
+{
+	list.clear();
+	levelPtr.clear();
+
+	list.push_back(root);
+	m_lvl[root] = 0;
+	levelPtr.push_back(0);
+	int l0 = 0;
+	while (l0 < (int)list.size())
+	{
+		int l1 = (int)list.size();
+		levelPtr.push_back(l1);
+		int nextLevel = (int)levelPtr.size() - 1;
+		for (int i = l0; i < l1; ++i)
+		{
+			int v = list[i];
+			for (int k = m_cxadj[v]; k < m_cxadj[v + 1]; ++k)
+			{
+				int w = m_cadj[k];
+				if ((m_label[w] == label) && (m_lvl[w] == -1))
+				{
+					m_lvl[w] = nextLevel;
+					list.push_back(w);
+				}
+			}
+		}
+		l0 = l1;
+	}
+	return (int)levelPtr.size() - 1;
+}
+
+//-----------------------------------------------------------------------------
+void NestedDissection::Dissect(vector<int>& nodes, int label)
+{
+	const int LEAF_SIZE = 64;
+
+	int nweight = 0;
+	for (int v : nodes) nweight += m_wgt[v];
+
+	// small graphs are not split any further
+	if ((nodes.size() < 4) || (nweight <= LEAF_SIZE))
+	{
+		m_order.insert(m_order.end(), nodes.begin(), nodes.end());
+		return;
+	}
+
+	// find a level structure
+	for (int v : nodes) m_lvl[v] = -1;
+	vector<int> list, levelPtr;
+	int nlevels = BFS(nodes[0], label, list, levelPtr);
+
+	// if the graph is not connected, we process each component separately
+	if (list.size() < nodes.size())
+	{
+		vector< vector<int> > comps;
+		comps.push_back(list);
+		for (int v : nodes)
+		{
+			if (m_lvl[v] == -1)
+			{
+				BFS(v, label, list, levelPtr);
+				comps.push_back(list);
+			}
+		}
+		nodes.clear();
+		for (size_t i = 0; i < comps.size(); ++i)
+		{
+			int l = m_nextLabel++;
+			for (int v : comps[i]) m_label[v] = l;
+			Dissect(comps[i], l);
+		}
+		return;
+	}
+
+	// find a pseudo-peripheral vertex (i.e. one with a deep level structure)
+	for (int iter = 0; iter < 4; ++iter)
+	{
+		// pick the vertex of the last level with the smallest degree
+		int root = list[levelPtr[nlevels - 1]];
+		for (int i = levelPtr[nlevels - 1]; i < levelPtr[nlevels]; ++i)
+		{
+			int v = list[i];
+			if (m_cxadj[v + 1] - m_cxadj[v] < m_cxadj[root + 1] - m_cxadj[root]) root = v;
+		}
+
+		vector<int> list2, levelPtr2;
+		for (int v : nodes) m_lvl[v] = -1;
+		int nlevels2 = BFS(root, label, list2, levelPtr2);
+		bool bdeeper = (nlevels2 > nlevels);
+		list.swap(list2);
+		levelPtr.swap(levelPtr2);
+		nlevels = nlevels2;
+		if (bdeeper == false) break;
+	}
+
+	if (nlevels < 3)
+	{
+		m_order.insert(m_order.end(), nodes.begin(), nodes.end());
+		return;
+	}
+
+	// Find the separator level. We pick the level that minimizes the ratio of the 
+	// separator's weight to the product of the weights of the two parts, which 
+	// favors small separators that still split the graph in balanced parts.
+	int L = 1;
+	double cmin = 0.0;
+	int wa = 0;
+	for (int l = 0; l < nlevels - 1; ++l)
+	{
+		int ws = 0;
+		for (int i = levelPtr[l]; i < levelPtr[l + 1]; ++i) ws += m_wgt[list[i]];
+		int wb = nweight - wa - ws;
+		if ((l > 0) && (wa > 0) && (wb > 0))
+		{
+			double c = (double)ws / ((double)wa * (double)wb);
+			if ((L == 1 && cmin == 0.0) || (c < cmin)) { L = l; cmin = c; }
+		}
+		wa += ws;
+	}
+
+	// split the graph. Vertices of the separator level that are not connected 
+	// to the next level, are moved to the first part.
+	vector<int> partA, partB, sep;
+	for (int i = 0; i < levelPtr[L]; ++i) partA.push_back(list[i]);
+	for (int i = levelPtr[L + 1]; i < levelPtr[nlevels]; ++i) partB.push_back(list[i]);
+	for (int i = levelPtr[L]; i < levelPtr[L + 1]; ++i)
+	{
+		int v = list[i];
+		bool bnext = false;
+		for (int k = m_cxadj[v]; k < m_cxadj[v + 1]; ++k)
+		{
+			int u = m_cadj[k];
+			if ((m_label[u] == label) && (m_lvl[u] == L + 1)) { bnext = true; break; }
+		}
+		if (bnext) sep.push_back(v); else partA.push_back(v);
+	}
+	nodes.clear();
+
+	int la = m_nextLabel++;
+	int lb = m_nextLabel++;
+	for (int v : partA) m_label[v] = la;
+	for (int v : partB) m_label[v] = lb;
+	for (int v : sep) m_label[v] = -1;
+
+	Dissect(partA, la);
+	Dissect(partB, lb);
+
+	// the separator is numbered last
+	m_order.insert(m_order.end(), sep.begin(), sep.end());
+}
+
+//-----------------------------------------------------------------------------
+void NestedDissection::Apply(vector<int>& perm)
+{
+	Compress();
+
+	m_label.assign(m_nc, 0);
+	m_lvl.assign(m_nc, -1);
+	m_order.clear();
+	m_order.reserve(m_nc);
+	m_nextLabel = 1;
+
+	vector<int> nodes(m_nc);
+	for (int i = 0; i < m_nc; ++i) nodes[i] = i;
+	Dissect(nodes, 0);
+	assert(m_order.size() == m_nc);
+
+	// expand the compressed ordering
+	perm.clear();
+	perm.reserve(m_n);
+	for (int c : m_order)
+	{
+		for (int i = m_vptr[c]; i < m_vptr[c + 1]; ++i) perm.push_back(m_var[i]);
+	}
+}
+
+//=============================================================================
+BEGIN_FECORE_CLASS(SparseCholeskySolver, LinearSolver)
+	ADD_PARAMETER(m_ordering, "ordering", 0, "nested_dissection\0none\0");
+	ADD_PARAMETER(m_print_level, "print_level");
+END_FECORE_CLASS();
+
+//-----------------------------------------------------------------------------
+SparseCholeskySolver::SparseCholeskySolver(FEModel* fem) : LinearSolver(fem), m_pA(nullptr)
+{
+	m_ordering = 0;
+	m_print_level = 0;
+	m_n = 0;
+	m_bfactored = false;
+}
+
+//-----------------------------------------------------------------------------
+SparseMatrix* SparseCholeskySolver::CreateSparseMatrix(Matrix_Type ntype)
+{
+	return (m_pA = (ntype == REAL_SYMMETRIC ? new CompactSymmMatrix(0) : nullptr));
+}
+
+//-----------------------------------------------------------------------------
+bool SparseCholeskySolver::SetSparseMatrix(SparseMatrix* pA)
+{
+	m_pA = dynamic_cast<CompactSymmMatrix*>(pA);
+	m_n = 0;
+	return (m_pA != nullptr);
+}
+
+//-----------------------------------------------------------------------------
+bool SparseCholeskySolver::PreProcess()
+{
+	if (m_pA == nullptr) return false;
+
+	// see if the matrix pattern changed since the last symbolic factorization
+	int n = m_pA->Rows();
+	int nnz = m_pA->NonZeroes();
+	const int* ptr = m_pA->Pointers();
+	const int* ind = m_pA->Indices();
+	bool bsame = ((n == m_n) && (nnz == (int)m_ind.size()) && 
+		std::equal(ptr, ptr + n + 1, m_ptr.begin()) &&
+		std::equal(ind, ind + nnz, m_ind.begin()));
+
+	if (bsame == false)
+	{
+		m_n = n;
+		m_ptr.assign(ptr, ptr + n + 1);
+		m_ind.assign(ind, ind + nnz);
+		SymbolicFactor();
+	}
+	else if (m_print_level > 0) feLog("Reusing symbolic factorization.\n");
+
+	return LinearSolver::PreProcess();
+}
+
+//-----------------------------------------------------------------------------
+void SparseCholeskySolver::SymbolicFactor()
+{
+	const int n = m_n;
+	const int off = m_pA->Offset();
+
+	// build the adjacency graph of the matrix
+	vector<int> xadj(n + 1, 0), adj;
+	for (int j = 0; j < n; ++j)
+	{
+		for (int k = m_ptr[j] - off; k < m_ptr[j + 1] - off; ++k)
+		{
+			int i = m_ind[k] - off;
+			if (i != j) { xadj[i + 1]++; xadj[j + 1]++; }
+		}
+	}
+	for (int i = 0; i < n; ++i) xadj[i + 1] += xadj[i];
+	adj.resize(xadj[n]);
+	{
+		vector<int> pos(xadj.begin(), xadj.end() - 1);
+		for (int j = 0; j < n; ++j)
+		{
+			for (int k = m_ptr[j] - off; k < m_ptr[j + 1] - off; ++k)
+			{
+				int i = m_ind[k] - off;
+				if (i != j) { adj[pos[i]++] = j; adj[pos[j]++] = i; }
+			}
+		}
+	}
+	#pragma omp parallel for
+	for (int i = 0; i < n; ++i) std::sort(adj.begin() + xadj[i], adj.begin() + xadj[i + 1]);
+
+	// calculate the fill-reducing ordering
+	m_perm.resize(n);
+	if (m_ordering == 0)
+	{
+		NestedDissection nd(n, xadj, adj);
+		nd.Apply(m_perm);
+	}
+	else for (int i = 0; i < n; ++i) m_perm[i] = i;
+
+	// elimination tree (Liu's algorithm with path compression)
+	vector<int> iperm(n);
+	for (int i = 0; i < n; ++i) iperm[m_perm[i]] = i;
+	vector<int> parent(n, -1), anc(n, -1);
+	for (int k = 0; k < n; ++k)
+	{
+		int v = m_perm[k];
+		for (int l = xadj[v]; l < xadj[v + 1]; ++l)
+		{
+			int i = iperm[adj[l]];
+			while ((i != -1) && (i < k))
+			{
+				int inext = anc[i];
+				anc[i] = k;
+				if (inext == -1) parent[i] = k;
+				i = inext;
+			}
+		}
+	}
+
+	// postorder the tree, so that the columns of a supernode are numbered consecutively
+	{
+		vector<int> head(n, -1), next(n, -1);
+		for (int j = n - 1; j >= 0; --j)
+		{
+			if (parent[j] != -1) { next[j] = head[parent[j]]; head[parent[j]] = j; }
+		}
+		vector<int> post; post.reserve(n);
+		vector<int> stack;
+		for (int j = 0; j < n; ++j)
+		{
+			if (parent[j] != -1) continue;
+			stack.push_back(j);
+			while (!stack.empty())
+			{
+				int p = stack.back();
+				int c = head[p];
+				if (c == -1) { stack.pop_back(); post.push_back(p); }
+				else { head[p] = next[c]; stack.push_back(c); }
+			}
+		}
+
+		// update the permutation and the tree
+		vector<int> ipost(n), perm2(n), parent2(n);
+		for (int k = 0; k < n; ++k) ipost[post[k]] = k;
+		for (int k = 0; k < n; ++k)
+		{
+			perm2[k] = m_perm[post[k]];
+			parent2[k] = (parent[post[k]] == -1 ? -1 : ipost[parent[post[k]]]);
+		}
+		m_perm.swap(perm2);
+		parent.swap(parent2);
+		for (int i = 0; i < n; ++i) iperm[m_perm[i]] = i;
+	}
+
+	// column counts of L (by traversing the row subtrees)
+	vector<int> colCount(n, 1), flag(n, -1);
+	for (int k = 0; k < n; ++k)
+	{
+		flag[k] = k;
+		int v = m_perm[k];
+		for (int l = xadj[v]; l < xadj[v + 1]; ++l)
+		{
+			int i = iperm[adj[l]];
+			while ((i < k) && (flag[i] != k))
+			{
+				colCount[i]++;
+				flag[i] = k;
+				i = parent[i];
+			}
+		}
+	}
+
+	// find the fundamental supernodes
+	vector<int> nchild(n, 0);
+	for (int j = 0; j < n; ++j) if (parent[j] != -1) nchild[parent[j]]++;
+	m_sfirst.clear();
+	for (int j = 0; j < n; ++j)
+	{
+		bool bmerge = (j > 0) && (parent[j - 1] == j) && (nchild[j] == 1) && (colCount[j - 1] == colCount[j] + 1);
+		if (bmerge == false) m_sfirst.push_back(j);
+	}
+	int ns = (int)m_sfirst.size();
+	m_sfirst.push_back(n);
+
+	vector<int> snode(n);
+	for (int s = 0; s < ns; ++s)
+		for (int j = m_sfirst[s]; j < m_sfirst[s + 1]; ++j) snode[j] = s;
+
+	// supernodal elimination tree
+	m_sparent.resize(ns);
+	for (int s = 0; s < ns; ++s)
+	{
+		int p = parent[m_sfirst[s + 1] - 1];
+		m_sparent[s] = (p == -1 ? -1 : snode[p]);
+	}
+	m_childPtr.assign(ns + 1, 0);
+	for (int s = 0; s < ns; ++s) if (m_sparent[s] != -1) m_childPtr[m_sparent[s] + 1]++;
+	for (int s = 0; s < ns; ++s) m_childPtr[s + 1] += m_childPtr[s];
+	m_child.resize(m_childPtr[ns]);
+	{
+		vector<int> pos(m_childPtr.begin(), m_childPtr.end() - 1);
+		for (int s = 0; s < ns; ++s) if (m_sparent[s] != -1) m_child[pos[m_sparent[s]]++] = s;
+	}
+
+	// row structure of the supernodes
+	m_rowPtr.assign(ns + 1, 0);
+	m_Lptr.assign(ns + 1, 0);
+	for (int s = 0; s < ns; ++s)
+	{
+		int f = m_sfirst[s];
+		int ncol = m_sfirst[s + 1] - f;
+		m_rowPtr[s + 1] = m_rowPtr[s] + colCount[f];
+		m_Lptr[s + 1] = m_Lptr[s] + (size_t)colCount[f]*(size_t)ncol;
+	}
+	m_rows.resize(m_rowPtr[ns]);
+	m_rel.assign(m_rowPtr[ns], 0);
+	vector<int> mark(n, -1), pos(n, 0);
+	for (int s = 0; s < ns; ++s)
+	{
+		int f = m_sfirst[s];
+		int l = m_sfirst[s + 1] - 1;
+		int* rows = &m_rows[m_rowPtr[s]];
+		int nr = 0;
+		for (int j = f; j <= l; ++j) { rows[nr++] = j; mark[j] = s; }
+
+		// rows of the matrix
+		for (int j = f; j <= l; ++j)
+		{
+			int v = m_perm[j];
+			for (int k = xadj[v]; k < xadj[v + 1]; ++k)
+			{
+				int i = iperm[adj[k]];
+				if ((i > l) && (mark[i] != s)) { rows[nr++] = i; mark[i] = s; }
+			}
+		}
+
+		// rows of the children
+		for (int k = m_childPtr[s]; k < m_childPtr[s + 1]; ++k)
+		{
+			int c = m_child[k];
+			int ncc = m_sfirst[c + 1] - m_sfirst[c];
+			for (int r = m_rowPtr[c] + ncc; r < m_rowPtr[c + 1]; ++r)
+			{
+				int i = m_rows[r];
+				if (mark[i] != s) { rows[nr++] = i; mark[i] = s; }
+			}
+		}
+		assert(nr == m_rowPtr[s + 1] - m_rowPtr[s]);
+		std::sort(rows + (l - f + 1), rows + nr);
+
+		// relative positions of the children's rows
+		for (int r = 0; r < nr; ++r) pos[rows[r]] = r;
+		for (int k = m_childPtr[s]; k < m_childPtr[s + 1]; ++k)
+		{
+			int c = m_child[k];
+			int ncc = m_sfirst[c + 1] - m_sfirst[c];
+			for (int r = m_rowPtr[c] + ncc; r < m_rowPtr[c + 1]; ++r) m_rel[r] = pos[m_rows[r]];
+		}
+	}
+
+	// location of the matrix values in the factor
+	int nnz = (int)m_ind.size();
+	m_amap.resize(nnz);
+	#pragma omp parallel for
+	for (int j = 0; j < n; ++j)
+	{
+		for (int k = m_ptr[j] - off; k < m_ptr[j + 1] - off; ++k)
+		{
+			int i = m_ind[k] - off;
+			int ni = iperm[i], nj = iperm[j];
+			int col = (ni < nj ? ni : nj);
+			int row = (ni < nj ? nj : ni);
+			int s = snode[col];
+			int m = m_rowPtr[s + 1] - m_rowPtr[s];
+			const int* rows = &m_rows[m_rowPtr[s]];
+			int r = (int)(std::lower_bound(rows, rows + m, row) - rows);
+			assert(rows[r] == row);
+			m_amap[k] = m_Lptr[s] + (size_t)(col - m_sfirst[s])*m + r;
+		}
+	}
+
+	// sort the supernodes by their level in the elimination tree
+	vector<int> level(ns, 0);
+	int maxLevel = 0;
+	for (int s = 0; s < ns; ++s)
+	{
+		int p = m_sparent[s];
+		if ((p != -1) && (level[p] < level[s] + 1)) level[p] = level[s] + 1;
+		if (level[s] > maxLevel) maxLevel = level[s];
+	}
+	m_levelPtr.assign(maxLevel + 2, 0);
+	for (int s = 0; s < ns; ++s) m_levelPtr[level[s] + 1]++;
+	for (int l = 0; l <= maxLevel; ++l) m_levelPtr[l + 1] += m_levelPtr[l];
+	m_level.resize(ns);
+	{
+		vector<int> lpos(m_levelPtr.begin(), m_levelPtr.end() - 1);
+		for (int s = 0; s < ns; ++s) m_level[lpos[level[s]]++] = s;
+	}
+
+	m_bfactored = false;
+
+	if (m_print_level > 0)
+	{
+		feLog("Sparse Cholesky symbolic factorization:\n");
+		feLog("\tNr of equations ........................... : %d\n", n);
+		feLog("\tNr of nonzeroes in factor ................. : %.0lf\n", (double)m_Lptr[ns]);
+		feLog("\tNr of supernodes .......................... : %d\n", ns);
+		feLog("\tElimination tree levels ................... : %d\n", maxLevel + 1);
+	}
+}
+
+//-----------------------------------------------------------------------------
+bool SparseCholeskySolver::Factor()
+{
+	if ((m_pA == nullptr) || (m_n != m_pA->Rows())) return false;
+
+	const int n = m_n;
+	const int off = m_pA->Offset();
+	const double* values = m_pA->Values();
+	int ns = (int)m_sfirst.size() - 1;
+
+	// copy the matrix values into the factor
+	m_L.assign(m_Lptr[ns], 0.0);
+	#pragma omp parallel for
+	for (int j = 0; j < n; ++j)
+	{
+		for (int k = m_ptr[j] - off; k < m_ptr[j + 1] - off; ++k) m_L[m_amap[k]] = values[k];
+	}
+
+	// factor the supernodes, level by level
+	m_U.assign(ns, vector<double>());
+	int nthreads = omp_get_max_threads();
+	bool bok = true;
+	int nlevels = (int)m_levelPtr.size() - 1;
+	for (int l = 0; l < nlevels; ++l)
+	{
+		int l0 = m_levelPtr[l];
+		int l1 = m_levelPtr[l + 1];
+		if (l1 - l0 >= nthreads)
+		{
+			// plenty of supernodes on this level, so we process them in parallel
+			int nerr = 0;
+			#pragma omp parallel for schedule(dynamic) reduction(+:nerr)
+			for (int i = l0; i < l1; ++i)
+			{
+				if (FactorSupernode(m_level[i], false) == false) nerr++;
+			}
+			if (nerr > 0) bok = false;
+		}
+		else
+		{
+			// only a few (but large) supernodes left, so we parallelize within the supernodes
+			for (int i = l0; i < l1; ++i)
+			{
+				if (FactorSupernode(m_level[i], nthreads > 1) == false) bok = false;
+			}
+		}
+		if (bok == false) break;
+	}
+	m_U.clear();
+
+	if (bok == false) feLogError("Zero pivot encountered in sparse Cholesky factorization.");
+
+	m_bfactored = bok;
+	return bok;
+}
+
+//-----------------------------------------------------------------------------
+// Factor a supernode with the multifrontal method. The front consists of the 
+// supernode's columns (stored in L) and the update matrix (U), which is passed on to the parent.
+bool SparseCholeskySolver::FactorSupernode(int s, bool bpar)
+{
+	const int f = m_sfirst[s];
+	const int n = m_sfirst[s + 1] - f;
+	const int m = m_rowPtr[s + 1] - m_rowPtr[s];
+	const int mu = m - n;
+	double* P = &m_L[m_Lptr[s]];
+
+	vector<double>& U = m_U[s];
+	U.assign((size_t)mu*mu, 0.0);
+
+	// extend-add the update matrices of the children
+	for (int k = m_childPtr[s]; k < m_childPtr[s + 1]; ++k)
+	{
+		int c = m_child[k];
+		int nc = m_sfirst[c + 1] - m_sfirst[c];
+		int muc = (m_rowPtr[c + 1] - m_rowPtr[c]) - nc;
+		const int* rel = &m_rel[m_rowPtr[c] + nc];
+		vector<double>& Uc = m_U[c];
+		for (int jj = 0; jj < muc; ++jj)
+		{
+			int rj = rel[jj];
+			const double* ucj = &Uc[(size_t)jj*muc];
+			if (rj < n)
+			{
+				double* pj = P + (size_t)rj*m;
+				for (int ii = jj; ii < muc; ++ii) pj[rel[ii]] += ucj[ii];
+			}
+			else
+			{
+				double* uj = &U[(size_t)(rj - n)*mu];
+				for (int ii = jj; ii < muc; ++ii) uj[rel[ii] - n] += ucj[ii];
+			}
+		}
+		vector<double>().swap(Uc);
+	}
+
+	// Factor the supernode's columns in blocks. The columns of a block are factored
+	// with a left-looking method, after which the block is used to update the 
+	// remaining columns of the front, i.e. the rest of the supernode and the update matrix.
+	const int NB = 32;
+	vector<double> W((size_t)NB*m);
+	for (int kb = 0; kb < n; kb += NB)
+	{
+		const int ke = (kb + NB < n ? kb + NB : n);
+		const int nb = ke - kb;
+
+		for (int k = kb; k < ke; ++k)
+		{
+			double* Pk = P + (size_t)k*m;
+			for (int p = kb; p < k; ++p)
+			{
+				const double* Lp = P + (size_t)p*m;
+				double t = Lp[p] * Lp[k];
+				if (t == 0.0) continue;
+				for (int i = k; i < m; ++i) Pk[i] -= Lp[i] * t;
+			}
+
+			double d = Pk[k];
+			if (d == 0.0) return false;
+			double di = 1.0 / d;
+			for (int i = k + 1; i < m; ++i) Pk[i] *= di;
+		}
+
+		// W(j,p) = D(p)*L(j,p)
+		for (int j = ke; j < m; ++j)
+		{
+			double* wj = &W[(size_t)(j - ke)*nb];
+			for (int p = 0; p < nb; ++p)
+			{
+				const double* Lp = P + (size_t)(kb + p)*m;
+				wj[p] = Lp[kb + p] * Lp[j];
+			}
+		}
+
+		// update the remaining columns: F(j:m,j) -= L(j:m,kb:ke)*W(j,:)
+		// The columns are processed in groups of four, which reduces the memory traffic
+		// for reading L. (The rows above the diagonal of a column are not used, so 
+		// they can be overwritten.)
+		const int ng = (m - ke + 3) / 4;
+		#pragma omp parallel for schedule(dynamic, 2) if(bpar && (ng > 16))
+		for (int g = 0; g < ng; ++g)
+		{
+			const int j0 = ke + 4 * g;
+			const int j1 = (j0 + 4 < m ? j0 + 4 : m);
+			if ((j1 - j0 == 4) && ((j1 <= n) || (j0 >= n)))
+			{
+				const int ioff = (j0 < n ? 0 : n);
+				double* c0 = (j0 < n ? P + (size_t)j0*m : &U[(size_t)(j0 - n)*mu]);
+				double* c1 = c0 + (j0 < n ? m : mu);
+				double* c2 = c1 + (j0 < n ? m : mu);
+				double* c3 = c2 + (j0 < n ? m : mu);
+				const double* w0 = &W[(size_t)(j0 - ke)*nb];
+				const double* w1 = w0 + nb;
+				const double* w2 = w1 + nb;
+				const double* w3 = w2 + nb;
+				for (int p = 0; p < nb; ++p)
+				{
+					const double* Lp = P + (size_t)(kb + p)*m;
+					double t0 = w0[p], t1 = w1[p], t2 = w2[p], t3 = w3[p];
+					if ((t0 == 0.0) && (t1 == 0.0) && (t2 == 0.0) && (t3 == 0.0)) continue;
+					for (int i = j0; i < m; ++i)
+					{
+						double l = Lp[i];
+						c0[i - ioff] -= l * t0;
+						c1[i - ioff] -= l * t1;
+						c2[i - ioff] -= l * t2;
+						c3[i - ioff] -= l * t3;
+					}
+				}
+			}
+			else
+			{
+				for (int j = j0; j < j1; ++j)
+				{
+					const int ioff = (j < n ? 0 : n);
+					double* c = (j < n ? P + (size_t)j*m : &U[(size_t)(j - n)*mu]);
+					const double* wj = &W[(size_t)(j - ke)*nb];
+					for (int p = 0; p < nb; ++p)
+					{
+						double t = wj[p];
+						if (t == 0.0) continue;
+						const double* Lp = P + (size_t)(kb + p)*m;
+						for (int i = j; i < m; ++i) c[i - ioff] -= Lp[i] * t;
+					}
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool SparseCholeskySolver::BackSolve(double* x, double* b)
+{
+	if (m_bfactored == false) return false;
+
+	const int n = m_n;
+	int ns = (int)m_sfirst.size() - 1;
+
+	// permute the right-hand side
+	vector<double> y(n);
+	for (int i = 0; i < n; ++i) y[i] = b[m_perm[i]];
+
+	// forward substitution (L is unit lower triangular)
+	for (int s = 0; s < ns; ++s)
+	{
+		int f = m_sfirst[s];
+		int nc = m_sfirst[s + 1] - f;
+		int m = m_rowPtr[s + 1] - m_rowPtr[s];
+		const int* rows = &m_rows[m_rowPtr[s]];
+		const double* P = &m_L[m_Lptr[s]];
+		for (int c = 0; c < nc; ++c)
+		{
+			const double* Pc = P + (size_t)c*m;
+			double yc = y[f + c];
+			if (yc == 0.0) continue;
+			for (int i = c + 1; i < m; ++i) y[rows[i]] -= Pc[i] * yc;
+		}
+	}
+
+	// diagonal
+	for (int s = 0; s < ns; ++s)
+	{
+		int f = m_sfirst[s];
+		int nc = m_sfirst[s + 1] - f;
+		int m = m_rowPtr[s + 1] - m_rowPtr[s];
+		const double* P = &m_L[m_Lptr[s]];
+		for (int c = 0; c < nc; ++c) y[f + c] /= P[(size_t)c*m + c];
+	}
+
+	// backward substitution
+	for (int s = ns - 1; s >= 0; --s)
+	{
+		int f = m_sfirst[s];
+		int nc = m_sfirst[s + 1] - f;
+		int m = m_rowPtr[s + 1] - m_rowPtr[s];
+		const int* rows = &m_rows[m_rowPtr[s]];
+		const double* P = &m_L[m_Lptr[s]];
+		for (int c = nc - 1; c >= 0; --c)
+		{
+			const double* Pc = P + (size_t)c*m;
+			double sum = 0.0;
+			for (int i = c + 1; i < m; ++i) sum += Pc[i] * y[rows[i]];
+			y[f + c] -= sum;
+		}
+	}
+
+	// permute the solution back
+	for (int i = 0; i < n; ++i) x[m_perm[i]] = y[i];
+
+	UpdateStats(0);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void SparseCholeskySolver::Destroy()
+{
+	// We keep the symbolic factorization, since it can be reused if the 
+	// matrix pattern doesn't change.
+	vector<double>().swap(m_L);
+	m_bfactored = false;
+	LinearSolver::Destroy();
+}
@@ -0,0 +1,105 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include <FECore/LinearSolver.h>
+#include "CompactSymmMatrix.h"
+
+//-----------------------------------------------------------------------------
+//! Sparse direct solver for symmetric matrices that does not depend on any 
+//! external libraries. 
+//! The matrix is first reordered with nested dissection to reduce the fill-in. 
+//! Then it is factored as L*D*L^T with a supernodal multifrontal method, where 
+//! the supernodes of each level of the elimination tree are factored in parallel.
+//! The ordering and symbolic factorization are only recalculated when the sparsity
+//! pattern of the matrix changes.
+//! Note that no pivoting is done, so, like the skyline solver, this solver assumes
+//! the matrix can be factored without pivoting (e.g. is positive definite).
+class SparseCholeskySolver : public LinearSolver
+{
+public:
+	//! constructor
+	SparseCholeskySolver(FEModel* fem);
+
+	//! Preprocess (calculates the ordering and symbolic factorization)
+	bool PreProcess() override;
+
+	//! Factor matrix
+	bool Factor() override;
+
+	//! Backsolve the linear system
+	bool BackSolve(double* x, double* b) override;
+
+	//! Clean up
+	void Destroy() override;
+
+	//! Create a sparse matrix
+	SparseMatrix* CreateSparseMatrix(Matrix_Type ntype) override;
+
+	//! Set the sparse matrix
+	bool SetSparseMatrix(SparseMatrix* pA) override;
+
+private:
+	//! calculate the ordering and the symbolic factorization
+	void SymbolicFactor();
+
+	//! factor a supernode
+	bool FactorSupernode(int s, bool bpar);
+
+private:
+	CompactSymmMatrix*	m_pA;
+
+	int		m_ordering;		//!< ordering method (0 = nested dissection, 1 = none)
+	int		m_print_level;	//!< print level
+
+	// matrix pattern of last symbolic factorization
+	int				m_n;
+	vector<int>		m_ptr;
+	vector<int>		m_ind;
+
+	// symbolic factorization
+	vector<int>		m_perm;		//!< permutation (new to old)
+	vector<int>		m_sfirst;	//!< first column of each supernode
+	vector<int>		m_sparent;	//!< parent of each supernode in the supernodal elimination tree
+	vector<int>		m_childPtr;	//!< children of each supernode
+	vector<int>		m_child;
+	vector<int>		m_rowPtr;	//!< row indices of each supernode
+	vector<int>		m_rows;
+	vector<int>		m_rel;		//!< position of a supernode's rows in its parent's rows
+	vector<int>		m_levelPtr;	//!< supernodes sorted by their level in the elimination tree
+	vector<int>		m_level;
+	vector<size_t>	m_Lptr;		//!< start of each supernode's values in m_L
+	vector<size_t>	m_amap;		//!< location of the matrix' values in m_L
+
+	// numerical factorization
+	vector<double>				m_L;	//!< factor (supernode columns are stored as dense column-major blocks)
+	vector< vector<double> >	m_U;	//!< update matrices of the supernodes
+	bool						m_bfactored;
+
+	DECLARE_FECORE_CLASS();
+};